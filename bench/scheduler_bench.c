@@ -0,0 +1,246 @@
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#include "arena.h"
+#include "array.h"
+#include "clipping.h"
+#include "color.h"
+#include "display_list.h"
+#include "line.h"
+#include "point.h"
+#include "scheduler.h"
+#include "tiler.h"
+
+#define BENCH_OBJECTS 1000000 /** << Lines in the synthetic scene.         */
+#define BENCH_ROUNDS  5       /** << Measured rounds per thread count.     */
+#define BENCH_CHUNK   64      /** << Objects processed by each job.        */
+#define BENCH_CANVAS  2000    /** << Coordinates are in [-CANVAS, CANVAS]. */
+
+#define BENCH_LONG_LINES 2000 /** << Lines crossing the whole surface in the tiler's case. */
+#define BENCH_WIDTH      1920 /** << Width of the tiler's surface.                        */
+#define BENCH_HEIGHT     1080 /** << Height of the tiler's surface.                       */
+
+/**
+ * @brief Synthetic scene shared by all jobs.
+*/
+struct bench
+{
+    array_tt             lines; /** << All lines.                                          */
+    double              *base;  /** << Original coordinates (x0, y0, x1, y1) of each line. */
+    struct clip_segment *segs;  /** << Clipping result of each line.                       */
+    double               dx;    /** << Translation in X.                                   */
+    double               dy;    /** << Translation in Y.                                   */
+};
+
+/**
+ * @brief (JOB) Translates lines [begin, end) from their original coordinates, then clips them (Liang-Barsky).
+ *
+ * @param begin First line.
+ * @param end   One past last line.
+ * @param arg   Given scene.
+*/
+static void bench_job(int   begin,
+                      int   end,
+                      void *arg)
+{
+    struct bench *b = arg;
+
+    for ( int i = begin; i < end; i++ )
+    {
+        const point_tt *points = line_get_points(array_get(b->lines, i));
+        const double *base = &b->base[i * 4];
+
+        point_set_coord(points[0], base[0] + b->dx, base[1] + b->dy);
+        point_set_coord(points[1], base[2] + b->dx, base[3] + b->dy);
+        clip_segment_init(&b->segs[i], point_x_coord(points[0]), point_y_coord(points[0]), point_x_coord(points[1]), point_y_coord(points[1]));
+        clip_liang_barsky(&b->segs[i], -500, 500, -400, 400);
+    }
+}
+
+/**
+ * @brief Checksum of all clipping results, used to check that every thread count produces the serial result.
+ *
+ * @param b Given scene.
+ *
+ * @returns Checksum.
+*/
+static unsigned long bench_checksum(const struct bench *b)
+{
+    unsigned long sum = 0;
+
+    for ( int i = 0; i < BENCH_OBJECTS; i++ )
+    {
+        const struct clip_segment *s = &b->segs[i];
+        sum = sum * 31 + (unsigned long) (s->accepted + s->x1 * 3 + s->y1 * 5 + s->x2 * 7 + s->y2 * 11);
+    }
+
+    return (sum);
+}
+
+/**
+ * @brief Next thread count to measure: powers of 2, then N.
+ *
+ * @param threads     Current thread count.
+ * @param max_threads N.
+ *
+ * @returns Next thread count (greater than N when done).
+*/
+static int bench_next_threads(int threads,
+                              int max_threads)
+{
+    return ( threads * 2 > max_threads && threads != max_threads ) ? max_threads : threads * 2;
+}
+
+/**
+ * @brief Checksum of all pixels of an image surface.
+ *
+ * @param surface Given surface.
+ *
+ * @returns Checksum.
+*/
+static unsigned long bench_surface_checksum(cairo_surface_t *surface)
+{
+    const unsigned char *data = cairo_image_surface_get_data(surface);
+    int stride = cairo_image_surface_get_stride(surface),
+        width = cairo_image_surface_get_width(surface),
+        height = cairo_image_surface_get_height(surface);
+    unsigned long sum = 0;
+
+    for ( int y = 0; y < height; y++ )
+    {
+        const uint32_t *row = (const uint32_t*) (data + (y * stride));
+        for ( int x = 0; x < width; x++ ) sum = sum * 31 + (row[x] & 0xffffff);
+    }
+
+    return (sum);
+}
+
+/**
+ * @brief Scaling benchmark of the tiler: rasterizes BENCH_LONG_LINES lines (DDA and Bresenham) and circumferences
+ * that cross the whole surface with 1 to N threads. Each tile only steps through the part of a line inside it,
+ * so a frame's work is split among tiles instead of being repeated by each of them.
+ *
+ * @param max_threads N.
+ *
+ * @returns 0 = Same pixels with every thread count, 1 = Otherwise.
+*/
+static int bench_tiler(int max_threads)
+{
+    display_list_tt dl = display_list_create(BENCH_WIDTH / 2, BENCH_HEIGHT / 2);
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, BENCH_WIDTH, BENCH_HEIGHT);
+    int half_w = BENCH_WIDTH / 2,
+        half_h = BENCH_HEIGHT / 2;
+
+    for ( int i = 0; i < BENCH_LONG_LINES; i++ )
+    {
+        // From left border to right border (or top to bottom), so every line crosses a whole row (or column) of tiles.
+        double a = (rand() % BENCH_HEIGHT) - half_h,
+               b = (rand() % BENCH_HEIGHT) - half_h,
+               c = (rand() % BENCH_WIDTH) - half_w,
+               d = (rand() % BENCH_WIDTH) - half_w;
+        uint32_t color = COLOR_RGBA(rand() % 256, rand() % 256, rand() % 256, 255);
+
+        if ( i % 2 ) display_list_add_line(dl, -half_w, a, half_w, b, 1 + (i / 2) % 2, color);
+        else display_list_add_line(dl, c, -half_h, d, half_h, 1 + (i / 2) % 2, color);
+        if ( i % 20 == 0 ) display_list_add_circumference(dl, c / 2, a / 2, 200 + rand() % 800, color);
+    }
+
+    unsigned long expected = 0;
+    double serial = 0.0;
+    int result = 0;
+    printf("\n%8s %12s %10s %10s   (tiler, %d long lines on %dx%d)\n", "threads", "ms/frame", "speedup", "result", BENCH_LONG_LINES, BENCH_WIDTH, BENCH_HEIGHT);
+    for ( int threads = 1; threads <= max_threads; threads = bench_next_threads(threads, max_threads) )
+    {
+        scheduler_tt s = scheduler_create(threads);
+        tiler_tt t = tiler_create(s);
+        gint64 elapsed = 0;
+        unsigned long sum = 0;
+
+        for ( int r = 0; r < BENCH_ROUNDS; r++ )
+        {
+            gint64 start = g_get_monotonic_time();
+            tiler_rasterize(t, surface, dl);
+            elapsed += g_get_monotonic_time() - start;
+            sum = bench_surface_checksum(surface);
+        }
+        double ms = elapsed / 1000.0 / BENCH_ROUNDS;
+        tiler_destroy(t);
+        scheduler_destroy(s);
+
+        if ( threads == 1 )
+        {
+            expected = sum;
+            serial = ms;
+        }
+        printf("%8d %12.2f %9.2fx %10s\n", threads, ms, serial / ms, ( sum == expected ) ? "same" : "DIFFERENT");
+        if ( sum != expected )
+        {
+            result = 1;
+            break;
+        }
+    }
+
+    cairo_surface_destroy(surface);
+    display_list_destroy(dl);
+
+    return (result);
+}
+
+/**
+ * @brief Scaling benchmark of the scheduler: translates and clips a synthetic scene of BENCH_OBJECTS lines with 1 to N threads,
+ * then rasterizes long lines with the tiler (see bench_tiler()).
+ * Usage: scheduler_bench [N]. If N is not given, number of processors is used.
+*/
+int main(int    argc,
+         char **argv)
+{
+    int max_threads = ( argc > 1 ) ? atoi(argv[1]) : (int) g_get_num_processors();
+    struct bench b;
+    arena_tt arena = arena_create(ARENA_CHUNK_SIZE);
+
+    srand(42);
+    b.lines = array_create(BENCH_OBJECTS);
+    b.base = (double*) malloc(sizeof(double) * 4 * BENCH_OBJECTS);
+    b.segs = (struct clip_segment*) malloc(sizeof(struct clip_segment) * BENCH_OBJECTS);
+    for ( int i = 0; i < BENCH_OBJECTS; i++ )
+    {
+        for ( int j = 0; j < 4; j++ ) b.base[i * 4 + j] = (rand() % (2 * BENCH_CANVAS + 1)) - BENCH_CANVAS;
+        point_tt p_init = point_create(b.base[i * 4], b.base[i * 4 + 1]),
+                 p_final = point_create(b.base[i * 4 + 2], b.base[i * 4 + 3]);
+        array_set(b.lines, i, line_create(arena, p_init, p_final, 1));
+    }
+
+    unsigned long expected = 0;
+    double serial = 0.0;
+    printf("%8s %12s %10s %10s\n", "threads", "ms/round", "speedup", "result");
+    for ( int threads = 1; threads <= max_threads; threads = bench_next_threads(threads, max_threads) )
+    {
+        scheduler_tt s = scheduler_create(threads);
+        gint64 elapsed = 0;
+        unsigned long sum = 0;
+
+        for ( int r = 0; r < BENCH_ROUNDS; r++ )
+        {
+            b.dx = r * 17.0;
+            b.dy = -r * 11.0;
+            gint64 t = g_get_monotonic_time();
+            scheduler_parallel_for(s, BENCH_OBJECTS, BENCH_CHUNK, bench_job, &b);
+            elapsed += g_get_monotonic_time() - t;
+            sum = sum * 131 + bench_checksum(&b);
+        }
+        double ms = elapsed / 1000.0 / BENCH_ROUNDS;
+        scheduler_destroy(s);
+
+        if ( threads == 1 )
+        {
+            expected = sum;
+            serial = ms;
+        }
+        printf("%8d %12.2f %9.2fx %10s\n", threads, ms, serial / ms, ( sum == expected ) ? "same" : "DIFFERENT");
+        if ( sum != expected ) return 1;
+    }
+
+    return bench_tiler(max_threads);
+}
@@ -0,0 +1,72 @@
+#include <glib.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#include "affine.h"
+#include "affine_kernel.h"
+
+#define BENCH_POINTS (1 << 12) /** << Points transformed each round (arrays fit in cache, so it measures the kernel, not memory). */
+#define BENCH_ROUNDS 50000     /** << Measured rounds per kernel level.      */
+#define BENCH_CANVAS 2000      /** << Coordinates are in [-CANVAS, CANVAS]. */
+
+/**
+ * @brief Throughput benchmark of the affine kernel: transforms BENCH_POINTS points with every level supported by CPU, checking that
+ * all of them produce the scalar result. Usage: transform_bench.
+*/
+int main(void)
+{
+    double *x = (double*) malloc(sizeof(double) * BENCH_POINTS),
+           *y = (double*) malloc(sizeof(double) * BENCH_POINTS),
+           *out_x = (double*) malloc(sizeof(double) * BENCH_POINTS),
+           *out_y = (double*) malloc(sizeof(double) * BENCH_POINTS),
+           *expected_x = (double*) malloc(sizeof(double) * BENCH_POINTS),
+           *expected_y = (double*) malloc(sizeof(double) * BENCH_POINTS);
+    struct affine m, step;
+
+    srand(42);
+    for ( int i = 0; i < BENCH_POINTS; i++ )
+    {
+        x[i] = (rand() % (2 * BENCH_CANVAS + 1)) - BENCH_CANVAS;
+        y[i] = (rand() % (2 * BENCH_CANVAS + 1)) - BENCH_CANVAS;
+    }
+
+    // Rotation, then scale, then translation, composed once
+    affine_rotation(&m, M_PI / 6.0);
+    affine_scale(&step, 2.0, 0.5);
+    affine_multiply(&m, &step, &m);
+    affine_translation(&step, 17.0, -11.0);
+    affine_multiply(&m, &step, &m);
+
+    int best = affine_kernel_set_level(AFFINE_KERNEL_AVX2);
+    double serial = 0.0;
+    printf("%8s %12s %14s %10s %10s\n", "kernel", "us/round", "Mpoints/s", "speedup", "result");
+    for ( int level = AFFINE_KERNEL_SCALAR; level <= best; level++ )
+    {
+        affine_kernel_set_level(level);
+        gint64 t = g_get_monotonic_time();
+
+        for ( int r = 0; r < BENCH_ROUNDS; r++ ) affine_kernel_apply(&m, x, y, out_x, out_y, BENCH_POINTS);
+        double us = (double) (g_get_monotonic_time() - t) / BENCH_ROUNDS;
+
+        if ( level == AFFINE_KERNEL_SCALAR )
+        {
+            memcpy(expected_x, out_x, sizeof(double) * BENCH_POINTS);
+            memcpy(expected_y, out_y, sizeof(double) * BENCH_POINTS);
+            serial = us;
+        }
+        int same = ( memcmp(expected_x, out_x, sizeof(double) * BENCH_POINTS) == 0 && memcmp(expected_y, out_y, sizeof(double) * BENCH_POINTS) == 0 );
+        printf("%8s %12.2f %14.1f %9.2fx %10s\n", affine_kernel_name(level), us, BENCH_POINTS / us, serial / us, same ? "same" : "DIFFERENT");
+        if ( !same ) return 1;
+    }
+
+    free(x);
+    free(y);
+    free(out_x);
+    free(out_y);
+    free(expected_x);
+    free(expected_y);
+    return 0;
+}
@@ -22,20 +22,40 @@
 #include <assert.h>
 #include <stdlib.h>
 
+#define ARRAY_MIN_SIZE 8 /**< Minimum size after growing. */
+
 /**
  * @brief Array.
  */
 struct array
 {
-    int curr_num;    /**< Current number of elements. */
-	int size;        /**< Maximum size.               */
-	void **elements; /**< Elements.                   */
+    int curr_num;    /**< Current number of elements.          */
+	int size;        /**< Allocated size (grows when needed). */
+	void **elements; /**< Elements.                          */
 };
 
+/**
+ * @brief Grows an array, doubling its size, so that idx fits.
+ *
+ * @param a   Target array.
+ * @param idx Index that must fit.
+ */
+static void array_grow(struct array *a, int idx)
+{
+	int size = (a->size < ARRAY_MIN_SIZE) ? ARRAY_MIN_SIZE : a->size;
+
+	while (size <= idx)
+		size *= 2;
+
+	a->elements = realloc(a->elements, size*sizeof(void *));
+	assert(a->elements != NULL);
+	a->size = size;
+}
+
 /**
  * @brief Creates an array.
  *
- * @param size Array size.
+ * @param size Initial array size. Array grows when needed.
  */
 struct array *array_create(int size)
 {
@@ -82,7 +102,7 @@ int array_size(const struct array *a)
 }
 
 /**
- * @brief Sets the ith element of an array.
+ * @brief Sets the ith element of an array. If idx does not fit, array grows.
  *
  * @param a   Target array.
  * @param idx Index.
@@ -92,13 +112,34 @@ void array_set(struct array *a, int idx, void *obj)
 {
 	/* Sanity check. */
 	assert(a != NULL);
-	assert((idx >= 0) && (idx < a->size));
+	assert(idx >= 0);
 	assert(obj != NULL);
 
+	if (idx >= a->size)
+		array_grow(a, idx);
+
     if ( idx >= a->curr_num ) a->curr_num++;
 	a->elements[idx] = obj;
 }
 
+/**
+ * @brief Appends an element at the end of an array (amortized O(1)).
+ *
+ * @param a   Target array.
+ * @param obj Object.
+ */
+void array_append(struct array *a, void *obj)
+{
+	/* Sanity check. */
+	assert(a != NULL);
+	assert(obj != NULL);
+
+	if (a->curr_num >= a->size)
+		array_grow(a, a->curr_num);
+
+	a->elements[a->curr_num++] = obj;
+}
+
 /**
  * @brief Gets the ith element of an array.
  *
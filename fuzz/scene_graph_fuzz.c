@@ -0,0 +1,254 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#include "affine.h"
+#include "arena.h"
+#include "circumference.h"
+#include "handle.h"
+#include "point.h"
+#include "scene_graph.h"
+
+#define FUZZ_ROUNDS        2000 /** << Random scenes per run (if not given).   */
+#define FUZZ_CIRCUMFERENCE 1    /** << Kind of a Circumference's handle.       */
+#define FUZZ_GROUP         2    /** << Kind of a group's handle.               */
+#define FUZZ_OBJECTS       24   /** << Circumferences in each random scene.    */
+#define FUZZ_TOLERANCE     1e-9 /** << Relative error allowed between results. */
+
+/**
+ * @brief Random generator of the run (xorshift64*), so a seed always reproduces the same scenes.
+ *
+ * @param state Generator's state.
+ *
+ * @returns Random number in [0, 1).
+*/
+static double fuzz_rand(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (double) ((*state * UINT64_C(2685821657736338717)) >> 11) / 9007199254740992.0;
+}
+
+/**
+ * @brief Writes a random transformation: a translation, a rotation or a (possibly non-uniform, possibly mirrored) scale about a random point.
+ *
+ * @param state Generator's state.
+ * @param a     Output: transformation.
+*/
+static void fuzz_transform(uint64_t      *state,
+                           struct affine *a)
+{
+    struct affine m;
+    double kind = fuzz_rand(state);
+
+    if ( kind < 0.3 ) affine_translation(a, fuzz_rand(state) * 200 - 100, fuzz_rand(state) * 200 - 100);
+    else
+    {
+        if ( kind < 0.6 ) affine_rotation(&m, fuzz_rand(state) * 2 * M_PI);
+        else affine_scale(&m, ( fuzz_rand(state) * 3.8 + 0.2 ) * ( ( fuzz_rand(state) < 0.2 ) ? -1 : 1 ), fuzz_rand(state) * 3.8 + 0.2);
+        affine_about(a, &m, fuzz_rand(state) * 200 - 100, fuzz_rand(state) * 200 - 100);
+    }
+}
+
+/**
+ * @brief Checks a Circumference in a group against its expected matrix to world, composed eagerly: circumference_map() through its own matrix
+ * composed with group's (lazily cached) world matrix must give the mapped center, and a radius that reaches the mapped border point.
+ *
+ * @param g        Given scene graph.
+ * @param h        Circumference's handle.
+ * @param c        Given Circumference.
+ * @param expected Expected matrix to world.
+ *
+ * @returns 0 if it matches, 1 otherwise.
+*/
+static int fuzz_check(scene_graph_tt       g,
+                      handle_tt            h,
+                      circumference_tt     c,
+                      const struct affine *expected)
+{
+    const point_tt *points = circumference_get_points(c);
+    const struct affine *m = circumference_get_matrix(c);
+    struct affine tmp;
+    handle_tt parent = scene_graph_parent(g, h);
+    double cx = point_x_coord(points[0]),
+           cy = point_y_coord(points[0]),
+           bx = point_x_coord(points[1]),
+           by = point_y_coord(points[1]),
+           x, y, r;
+
+    if ( parent != HANDLE_NONE )
+    {
+        affine_multiply(&tmp, scene_graph_world(g, parent), m);
+        m = &tmp;
+    }
+    r = circumference_map(c, m, &x, &y);
+    affine_apply(expected, &cx, &cy);
+    affine_apply(expected, &bx, &by);
+
+    double radius = sqrt(pow(bx - cx, 2) + pow(by - cy, 2)),
+           scale = fmax(1.0, fabs(cx) + fabs(cy) + radius);
+    if ( fabs(x - cx) <= FUZZ_TOLERANCE * scale && fabs(y - cy) <= FUZZ_TOLERANCE * scale && fabs(r - radius) <= FUZZ_TOLERANCE * scale ) return (0);
+
+    printf("MISMATCH circumference %u: center (%.17g, %.17g) radius %.17g, expected (%.17g, %.17g) radius %.17g\n", h, x, y, r, cx, cy, radius);
+    return (1);
+}
+
+/**
+ * @brief Scales a group holding a single Circumference (radius 10, border to its right): its radius must follow the group, e.g. 3 times bigger
+ * after a uniform scale by 3 and 2 times bigger after scaling X by 2, so it still passes through its border point.
+ *
+ * @param arena  Arena of Circumferences.
+ * @param table  Handles.
+ *
+ * @returns Number of mismatches.
+*/
+static int fuzz_scaled_group(arena_tt        arena,
+                             handle_table_tt table)
+{
+    static const double scales[3][3] = { { 3.0, 3.0, 30.0 }, { 2.0, 1.0, 60.0 }, { 0.5, 4.0, 30.0 } };
+    scene_graph_tt g = scene_graph_create();
+    circumference_tt c = circumference_create(arena, point_create(5, 5), point_create(15, 5));
+    handle_tt h = handle_alloc(table, FUZZ_CIRCUMFERENCE, c),
+              group = handle_alloc(table, FUZZ_GROUP, g);
+    int failures = 0;
+
+    scene_graph_group(g, group, &h, 1);
+    for ( int i = 0; i < 3; i++ )
+    {
+        struct affine a,
+                      tmp;
+        double x, y, r;
+
+        // Scales accumulate: 10 * 3 = 30, then X by 2 (border is to the right) = 60, then X by 0.5 = 30
+        affine_scale(&a, scales[i][0], scales[i][1]);
+        scene_graph_transform(g, group, &a);
+        affine_multiply(&tmp, scene_graph_world(g, group), circumference_get_matrix(c));
+        r = circumference_map(c, &tmp, &x, &y);
+        if ( fabs(r - scales[i][2]) > FUZZ_TOLERANCE * scales[i][2] )
+        {
+            printf("MISMATCH scaled group: radius %.17g, expected %.17g\n", r, scales[i][2]);
+            failures++;
+        }
+    }
+
+    scene_graph_destroy(g);
+    return (failures);
+}
+
+/**
+ * @brief Builds a random scene: Circumferences with their own transformations, nested in random groups that are transformed too, then checks
+ * every Circumference (see fuzz_check). Expected matrices are composed eagerly, as each transformation is applied.
+ *
+ * @param arena Arena of Circumferences.
+ * @param table Handles.
+ * @param state Generator's state.
+ *
+ * @returns Number of mismatches.
+*/
+static int fuzz_scene(arena_tt        arena,
+                      handle_table_tt table,
+                      uint64_t       *state)
+{
+    scene_graph_tt g = scene_graph_create();
+    handle_tt handles[FUZZ_OBJECTS],
+              roots[FUZZ_OBJECTS];
+    circumference_tt circumferences[FUZZ_OBJECTS];
+    struct affine expected[FUZZ_OBJECTS];
+    handle_list_tt leaves;
+    int num_roots = FUZZ_OBJECTS,
+        failures = 0;
+
+    vector_init(&leaves);
+    for ( int i = 0; i < FUZZ_OBJECTS; i++ )
+    {
+        double x = fuzz_rand(state) * 400 - 200,
+               y = fuzz_rand(state) * 400 - 200;
+        struct affine a;
+
+        circumferences[i] = circumference_create(arena, point_create(x, y), point_create(x + fuzz_rand(state) * 100 - 50, y + fuzz_rand(state) * 100 - 50));
+        handles[i] = roots[i] = handle_alloc(table, FUZZ_CIRCUMFERENCE, circumferences[i]);
+        fuzz_transform(state, &a);
+        circumference_transform(circumferences[i], &a);
+        expected[i] = *circumference_get_matrix(circumferences[i]);
+    }
+
+    while ( num_roots > 1 )
+    {
+        // Groups some roots (moved to the end of roots), then transforms a random group
+        int n = 1 + (int) (fuzz_rand(state) * fmin(num_roots, 4));
+        for ( int i = 0; i < n; i++ )
+        {
+            int j = (int) (fuzz_rand(state) * (num_roots - i));
+            handle_tt t = roots[j];
+            roots[j] = roots[num_roots - 1 - i];
+            roots[num_roots - 1 - i] = t;
+        }
+        handle_tt group = handle_alloc(table, FUZZ_GROUP, g);
+        scene_graph_group(g, group, &roots[num_roots - n], n);
+        num_roots -= n;
+        roots[num_roots++] = group;
+
+        handle_tt target = scene_graph_group_at(g, (int) (fuzz_rand(state) * scene_graph_num_groups(g)));
+        struct affine a,
+                      tmp;
+        fuzz_transform(state, &a);
+        scene_graph_transform(g, target, &a);
+
+        // A transformation in target's parent coordinates: Objects under it get parent's world * a * parent's world^-1 before their matrices
+        struct affine world = { { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } } },
+                      inverse;
+        handle_tt parent = scene_graph_parent(g, target);
+        if ( parent != HANDLE_NONE ) world = *scene_graph_world(g, parent);
+        if ( !affine_invert(&inverse, &world) ) continue;
+        affine_multiply(&tmp, &a, &inverse);
+        affine_multiply(&a, &world, &tmp);
+
+        vector_clear(&leaves);
+        scene_graph_leaves(g, target, &leaves);
+        for ( int i = 0; i < leaves.size; i++ )
+        {
+            int k = 0;
+            while ( handles[k] != leaves.data[i] ) k++;
+            tmp = expected[k];
+            affine_multiply(&expected[k], &a, &tmp);
+        }
+
+        for ( int i = 0; i < FUZZ_OBJECTS; i++ ) failures += fuzz_check(g, handles[i], circumferences[i], &expected[i]);
+    }
+
+    vector_free(&leaves);
+    scene_graph_destroy(g);
+    return (failures);
+}
+
+/**
+ * @brief Fuzzer of Scene Graph's world matrices and of grouped Circumferences, meant to run with AddressSanitizer and UndefinedBehaviorSanitizer
+ * (see 'make fuzz'): radius of a Circumference in a group must follow group's transformations (e.g. a scale), lazily cached world matrices must
+ * match eagerly composed ones. Usage: scene_graph_fuzz [ROUNDS] [SEED]. Same seed, same scenes.
+*/
+int main(int    argc,
+         char **argv)
+{
+    int rounds = ( argc > 1 ) ? atoi(argv[1]) : FUZZ_ROUNDS;
+    uint64_t seed = ( argc > 2 ) ? strtoull(argv[2], NULL, 10) : 42,
+             state = seed * UINT64_C(0x9E3779B97F4A7C15) + 1;
+    arena_tt arena = arena_create(ARENA_CHUNK_SIZE);
+    handle_table_tt table = handle_table_create(FUZZ_OBJECTS * 2);
+    long failures = fuzz_scaled_group(arena, table);
+
+    for ( int i = 0; i < rounds; i++ )
+    {
+        failures += fuzz_scene(arena, table, &state);
+        handle_table_clear(table);
+        point_clear();
+        arena_reset(arena);
+    }
+    handle_table_destroy(table);
+    arena_destroy(arena);
+
+    printf("%d rounds (seed %llu): %ld failures\n", rounds, (unsigned long long) seed, failures);
+    return ( failures == 0 ) ? 0 : 1;
+}
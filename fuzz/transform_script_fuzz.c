@@ -0,0 +1,231 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#include "transform_script.h"
+
+#define FUZZ_ROUNDS  200000 /** << Random cases per run (if not given).                 */
+#define FUZZ_TEXT    4096   /** << Longest generated text (numbers of ~1000 digits fit). */
+#define FUZZ_GARBAGE 64     /** << Longest random script of arbitrary chars.            */
+
+/**
+ * @brief Numbers whose correct rounding is hard (halfway cases, powers of 10 beyond 1e22, limits of double), always checked first.
+*/
+static const char *hard[] = {
+    "1e23", "6.75e235", "8.533e+68", "4.1006e-184", "9.998e+307", "9.9538452227e-280", "6.47660115e-260", "7.4e+47",
+    "5.92e+48", "7.35e+66", "8.32116e+55", "0.1", "0.3", "2.2250738585072011e-308", "2.2250738585072012e-308",
+    "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1.7976931348623157e308",
+    "1.7976931348623158e308", "1.7976931348623159e308", "9007199254740993", "9007199254740992.5", "18446744073709551616",
+    "123456789012345678901234567890", "0.000000000000000000000000000001e30", "1e-400", "1e400", "-0", "-0.0e5",
+    "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497791.9999999999999999999999999999999999999999999999999999999999999999999999",
+    "2.47032822920623272088284396434110686182529901307162382212792841250337753635104375932649918180817996189898282347722858865463328355177969898199387398005390939063150356595155702263922908583924491051844359318028499365361525003193704576782492193656236698636584807570015857692699037063119282795585513329278343384093519780155312465972635795746227664652728272200563740064854999770965994704540208281662262378573934507363390079677619305775067401763246736009689513405355374585166611342237666786041621596804619144672918403005300575308490487653917113865916462395249126236538818796362393732804238910186723484976682350898633885879256283027559956575244555072551893136908362547791869486679949683240497058210285131854513962138377228261454376934125320985913276672363281255",
+};
+
+/**
+ * @brief Random generator of the run (xorshift64*), so a seed always reproduces the same cases.
+ *
+ * @param state Generator's state.
+ * @param n     Upper bound.
+ *
+ * @returns Random integer in [0, n).
+*/
+static int fuzz_rand(uint64_t *state,
+                     int       n)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (int) (((*state * UINT64_C(2685821657736338717)) >> 33) % (uint64_t) n);
+}
+
+/**
+ * @brief Writes a random number: sign, integer and fraction digits (up to ~1000, with runs of zeros and nines that lie near halfway cases)
+ * and exponent, each part being optional.
+ *
+ * @param state Generator's state.
+ * @param out   Output text.
+ *
+ * @returns Length of text.
+*/
+static int fuzz_number(uint64_t *state,
+                       char     *out)
+{
+    int n = 0,
+        lengths[3] = { 0, 0, 0 };
+
+    if ( fuzz_rand(state, 4) == 0 ) out[n++] = ( fuzz_rand(state, 2) ) ? '-' : '+';
+    for ( int part = 0; part < 2; part++ )
+    {
+        int kind = fuzz_rand(state, 8);
+        lengths[part] = ( kind == 0 ) ? 0 : ( kind < 6 ) ? fuzz_rand(state, 20) : fuzz_rand(state, 1000);
+    }
+    if ( lengths[0] + lengths[1] == 0 ) lengths[0] = 1;
+
+    for ( int part = 0; part < 2; part++ )
+    {
+        if ( part == 1 && ( lengths[1] > 0 || fuzz_rand(state, 4) == 0 ) ) out[n++] = '.';
+        for ( int i = 0; i < lengths[part]; i++ )
+        {
+            int kind = fuzz_rand(state, 10);
+            out[n++] = ( kind == 0 ) ? '0' : ( kind == 1 ) ? '9' : (char) ('0' + fuzz_rand(state, 10));
+            // Long runs of one digit
+            if ( kind < 2 && fuzz_rand(state, 8) == 0 )
+                for ( int run = fuzz_rand(state, 40); run > 0 && i + 1 < lengths[part]; run--, i++, n++ ) out[n] = out[n - 1];
+        }
+    }
+
+    if ( fuzz_rand(state, 2) )
+    {
+        out[n++] = ( fuzz_rand(state, 2) ) ? 'e' : 'E';
+        if ( fuzz_rand(state, 2) ) out[n++] = ( fuzz_rand(state, 2) ) ? '-' : '+';
+        int kind = fuzz_rand(state, 8);
+        lengths[2] = ( kind == 0 ) ? 330 + fuzz_rand(state, 700) : ( kind < 4 ) ? fuzz_rand(state, 23) : fuzz_rand(state, 330);
+        n += sprintf(&out[n], "%d", lengths[2]);
+    }
+    out[n] = '\0';
+
+    return (n);
+}
+
+/**
+ * @brief Checks a parsed value against strtod() of its text: both must be the very same double (correctly rounded, sign of zero included).
+ *
+ * @param text   Number's text.
+ * @param parsed Value read by the script.
+ * @param angle  If value is an angle (converted to radians). 0 = No, 1 = Yes.
+ *
+ * @returns 0 if they match, 1 otherwise.
+*/
+static int fuzz_check(const char *text,
+                      double      parsed,
+                      int         angle)
+{
+    double expected = strtod(text, NULL);
+
+    if ( angle ) expected = expected * M_PI / 180.0;
+    if ( memcmp(&expected, &parsed, sizeof(double)) == 0 ) return (0);
+
+    printf("MISMATCH %s: parsed %.17g, strtod %.17g\n", text, parsed, expected);
+    return (1);
+}
+
+/**
+ * @brief Parses a number as a Translation (script and template) and as a Rotation (template), checking every value against strtod().
+ * Numbers out of range must be rejected.
+ *
+ * @param s    Script reused by every parse.
+ * @param text Number's text.
+ *
+ * @returns Number of mismatches.
+*/
+static int fuzz_case(transform_script_tt s,
+                     const char         *text)
+{
+    static char script[2 * FUZZ_TEXT + 64];
+    int failures = 0,
+        finite = isfinite(strtod(text, NULL));
+
+    snprintf(script, sizeof(script), "T(%s, 1)\nr%sd; S(2,%s)", text, text, text);
+    if ( transform_script_parse(s, script) != ( finite ? 3 : -1 ) )
+    {
+        printf("MISMATCH %s: script %s\n", text, finite ? "rejected" : "accepted");
+        return (1);
+    }
+    if ( finite )
+    {
+        failures += fuzz_check(text, transform_script_get(s, 0)->values[0], 0);
+        failures += fuzz_check(text, transform_script_get(s, 1)->values[0], 1);
+        failures += fuzz_check(text, transform_script_get(s, 2)->values[1], 0);
+    }
+
+    snprintf(script, sizeof(script), " ( %s ,%s)", text, text);
+    if ( transform_script_parse_template(s, script, TRANSFORM_TRANSLATION) != ( finite ? 0 : -1 ) )
+    {
+        printf("MISMATCH %s: template %s\n", text, finite ? "rejected" : "accepted");
+        return (failures + 1);
+    }
+    if ( finite ) failures += fuzz_check(text, transform_script_get(s, 0)->values[1], 0);
+
+    snprintf(script, sizeof(script), "%sD", text);
+    if ( transform_script_parse_template(s, script, TRANSFORM_ROTATION) == 0 ) failures += fuzz_check(text, transform_script_get(s, 0)->values[0], 1);
+
+    return (failures);
+}
+
+/**
+ * @brief Parses a random script of chars a script may have, checking that results are consistent: either steps or an error
+ * at a position inside the text.
+ *
+ * @param s     Script reused by every parse.
+ * @param state Generator's state.
+ *
+ * @returns 0 if results are consistent, 1 otherwise.
+*/
+static int fuzz_garbage(transform_script_tt s,
+                        uint64_t           *state)
+{
+    static const char alphabet[] = "TtRrSsXxYyDdEe()(),,;;\n\n#.-+0123456789  \t\r?";
+    char text[FUZZ_GARBAGE + 1];
+    int length = fuzz_rand(state, FUZZ_GARBAGE + 1),
+        line = 0,
+        column = 0,
+        lines = 1;
+
+    for ( int i = 0; i < length; i++ )
+    {
+        text[i] = alphabet[fuzz_rand(state, (int) sizeof(alphabet) - 1)];
+        if ( text[i] == '\n' ) lines++;
+    }
+    text[length] = '\0';
+
+    int rc = transform_script_parse(s, text);
+    const char *error = transform_script_error(s, &line, &column);
+    if ( ( rc < 0 ) != ( error != NULL ) || ( rc >= 0 && rc != transform_script_size(s) ) || ( rc < 0 && ( line < 1 || line > lines || column < 1 || column > length + 1 ) ) )
+    {
+        printf("INCONSISTENT parse of \"%s\": %d\n", text, rc);
+        return (1);
+    }
+
+    for ( int type = TRANSFORM_TRANSLATION; type <= TRANSFORM_SCALE; type++ )
+    {
+        rc = transform_script_parse_template(s, text, type);
+        if ( ( rc < 0 ) != ( transform_script_error(s, &line, &column) != NULL ) || transform_script_size(s) != ( rc == 0 ) )
+        {
+            printf("INCONSISTENT template of \"%s\": %d\n", text, rc);
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+/**
+ * @brief Fuzzer of Transform Script's parser, meant to run with AddressSanitizer and UndefinedBehaviorSanitizer (see 'make fuzz').
+ * Every number read must be the double strtod() gives (0 ULP), random scripts must never crash nor give inconsistent results.
+ * Usage: transform_script_fuzz [ROUNDS] [SEED]. Same seed, same cases.
+*/
+int main(int    argc,
+         char **argv)
+{
+    int rounds = ( argc > 1 ) ? atoi(argv[1]) : FUZZ_ROUNDS;
+    uint64_t seed = ( argc > 2 ) ? strtoull(argv[2], NULL, 10) : 42,
+             state = seed * UINT64_C(0x9E3779B97F4A7C15) + 1;
+    static char text[FUZZ_TEXT];
+    transform_script_tt s = transform_script_create();
+    long failures = 0;
+
+    for ( size_t i = 0; i < sizeof(hard) / sizeof(hard[0]); i++ ) failures += fuzz_case(s, hard[i]);
+    for ( int i = 0; i < rounds; i++ )
+    {
+        fuzz_number(&state, text);
+        failures += fuzz_case(s, text);
+        failures += fuzz_garbage(s, &state);
+    }
+    transform_script_destroy(s);
+
+    printf("%d rounds (seed %llu): %ld failures\n", rounds, (unsigned long long) seed, failures);
+    return ( failures == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+#ifndef AFFINE_H_
+#define AFFINE_H_
+
+    /**
+     * @brief A 2D affine transformation as a 3x3 matrix (row-major), applied to column vectors (X, Y, 1). Last row is always (0, 0, 1).
+    */
+    struct affine
+    {
+        double m[3][3]; /** << Matrix' rows. */
+    };
+
+    /**
+     * @brief Pointer to an affine chain struct.
+    */
+    typedef struct affine_chain * affine_chain_tt;
+
+    /**
+     * @brief Pointer to a const affine chain struct.
+    */
+    typedef const struct affine_chain * const_affine_chain_tt;
+
+    /**
+     * @brief Operations on Affine matrices. Output may be one of the inputs.
+    */
+    /**@(*/
+    extern void            affine_identity(struct affine*);
+    extern void            affine_translation(struct affine*, double, double);
+    extern void            affine_scale(struct affine*, double, double);
+    extern void            affine_rotation(struct affine*, double);
+    extern void            affine_multiply(struct affine*, const struct affine*, const struct affine*);
+    extern int             affine_invert(struct affine*, const struct affine*);
+    extern void            affine_about(struct affine*, const struct affine*, double, double);
+    extern void            affine_apply(const struct affine*, double*, double*);
+    extern void            affine_apply_box(const struct affine*, const double*, double*);
+    /**@)*/
+
+    /**
+     * @brief Operations on Affine Chain: a sequence of matrices applied in order. A pinned matrix is applied around an anchor
+     * (e.g. an object's first point) as it is at that step, so it depends on each object.
+    */
+    /**@(*/
+    extern affine_chain_tt affine_chain_create(void);
+    extern void            affine_chain_destroy(affine_chain_tt);
+    extern void            affine_chain_clear(affine_chain_tt);
+    extern int             affine_chain_size(const_affine_chain_tt);
+    extern void            affine_chain_push(affine_chain_tt, const struct affine*, int);
+    extern int             affine_chain_is_pinned(const_affine_chain_tt);
+    extern void            affine_chain_resolve(const_affine_chain_tt, double, double, struct affine*);
+    extern void            affine_chain_resolve_unpinned(const_affine_chain_tt, struct affine*);
+    /**@)*/
+
+#endif /* AFFINE_H_ */
@@ -0,0 +1,25 @@
+#ifndef AFFINE_KERNEL_H_
+#define AFFINE_KERNEL_H_
+
+    #include "affine.h"
+
+    /**
+     * @brief Instruction sets the kernel may run with. Best one supported by CPU is picked at first use.
+    */
+    /**@(*/
+    #define AFFINE_KERNEL_SCALAR 0 /** << Plain C loop, 1 point per iteration. */
+    #define AFFINE_KERNEL_SSE2   1 /** << 2 points per instruction.            */
+    #define AFFINE_KERNEL_AVX2   2 /** << 4 points per instruction.            */
+    /**@)*/
+
+    /**
+     * @brief Operations on Affine Kernel: applies a matrix to contiguous X and Y arrays. Every level produces the same results.
+    */
+    /**@(*/
+    extern void        affine_kernel_apply(const struct affine*, const double*, const double*, double*, double*, int);
+    extern int         affine_kernel_level(void);
+    extern int         affine_kernel_set_level(int);
+    extern const char *affine_kernel_name(int);
+    /**@)*/
+
+#endif /* AFFINE_KERNEL_H_ */
@@ -0,0 +1,25 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+    #include <stddef.h>
+
+    #define ARENA_CHUNK_SIZE (64 * 1024) /** << Default size (in bytes) of an arena's chunk. */
+
+    /**
+     * @brief Pointer to an arena struct.
+    */
+    typedef struct arena * arena_tt;
+
+    /**
+     * @brief Operations on Arena.
+    */
+    /**@(*/
+    extern arena_tt arena_create(size_t);
+    extern void     arena_destroy(arena_tt);
+    extern void    *arena_alloc(arena_tt, size_t);
+    extern void     arena_reset(arena_tt);
+    extern size_t   arena_used(arena_tt);
+    extern size_t   arena_reserved(arena_tt);
+    /**@)*/
+
+#endif /* ARENA_H_ */
@@ -0,0 +1,37 @@
+#ifndef BVH_H_
+#define BVH_H_
+
+    #include "handle.h"
+
+    #define BVH_LEAF_SIZE 8 /** << Maximum number of entries in a leaf.                      */
+    #define BVH_SLICES    2 /** << Each node is tiled in BVH_SLICES x BVH_SLICES children. */
+
+    /**
+     * @brief Pointer to a bvh struct.
+    */
+    typedef struct bvh * bvh_tt;
+
+    /**
+     * @brief Pointer to a const bvh struct.
+    */
+    typedef const struct bvh * const_bvh_tt;
+
+    /**
+     * @brief Operations on BVH (Bounding Volume Hierarchy). Boxes are 4 doubles: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+    */
+    /**@(*/
+    extern bvh_tt bvh_create(int);
+    extern void   bvh_destroy(bvh_tt);
+    extern void   bvh_clear(bvh_tt);
+    extern int    bvh_size(const_bvh_tt);
+    extern int    bvh_is_built(const_bvh_tt);
+
+    extern void   bvh_add(bvh_tt, handle_tt, const double*);
+    extern void   bvh_build(bvh_tt);
+    extern void   bvh_remove(bvh_tt, handle_tt);
+    extern void   bvh_update(bvh_tt, handle_tt, const double*);
+    extern void   bvh_refit(bvh_tt);
+    extern int    bvh_query(bvh_tt, const double*, double, handle_list_tt*, handle_list_tt*);
+    /**@)*/
+
+#endif /* BVH_H_ */
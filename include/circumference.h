@@ -1,6 +1,8 @@
 #ifndef CIRCUMFERENCE_H_
 #define CIRCUMFERENCE_H_
 
+    #include "affine.h"
+    #include "arena.h"
     #include "point.h"
 
     /**
@@ -17,12 +19,16 @@
      * @brief Operations on Circumference.
     */
     /**@(*/
-    extern circumference_tt circumference_create(point_tt, point_tt);
-    extern void             circumference_destroy(circumference_tt);
-    extern int              circumference_id(const_circumference_tt);
-    extern double           circumference_radius(const_circumference_tt);
+    extern circumference_tt     circumference_create(arena_tt, point_tt, point_tt);
+    extern void                 circumference_destroy(circumference_tt);
+    extern double               circumference_radius(const_circumference_tt);
+    extern double               circumference_map(const_circumference_tt, const struct affine*, double*, double*);
+    extern void                 circumference_get_box(circumference_tt, double*);
+    extern void                 circumference_get_center(const_circumference_tt, double*, double*);
+    extern const struct affine *circumference_get_matrix(const_circumference_tt);
+    extern void                 circumference_transform(circumference_tt, const struct affine*);
 
-    extern point_tt*        circumference_get_points(const_circumference_tt);
+    extern const point_tt      *circumference_get_points(const_circumference_tt);
     /**@)*/
 
 #endif /* CIRCUMFERENCE_H_ */
\ No newline at end of file
@@ -1,10 +1,26 @@
 #ifndef CLIPPING_H_
 #define CLIPPING_H_
 
-    #include "array.h"
+    #include "arena.h"
     #include "point.h"
     #define  NUM_CLIP_POINTS 4
 
+    #define  CLIP_COHEN_SUTHERLAND 1 /** << Cohen-Sutherland's line clipping. */
+    #define  CLIP_LIANG_BARSKY     2 /** << Liang-Barsky's line clipping.     */
+
+    /**
+     * @brief A segment (in integer coordinates, as clipping algorithms work) and its clipping result.
+     * Clipping only reads and writes the segment itself, so many segments can be clipped in parallel.
+    */
+    struct clip_segment
+    {
+        int x1;       /** << Initial X coordinate. Clipped in place.      */
+        int y1;       /** << Initial Y coordinate. Clipped in place.      */
+        int x2;       /** << Final X coordinate. Clipped in place.        */
+        int y2;       /** << Final Y coordinate. Clipped in place.        */
+        int accepted; /** << If segment is inside Clip. 0 = No, 1 = Yes. */
+    };
+
     /**
      * @brief Pointer to a clip struct.
     */
@@ -19,12 +35,16 @@
      * @brief Operations on Clip.
     */
     /**@(*/
-    extern clip_tt  clip_create(point_tt*, int, int);
-    extern void     clip_destroy(clip_tt);
-    extern int      clip_id(const_clip_tt);
+    extern clip_tt         clip_create(arena_tt, const point_tt*, int, int);
+    extern void            clip_destroy(clip_tt);
+
+    extern const point_tt *clip_get_points(const_clip_tt);
+    extern void            clip_get_maxmin(const_clip_tt, double*);
 
-    extern array_tt clip_get_points(const_clip_tt);
-    extern double*  clip_get_maxmin(const_clip_tt);
+    extern void            clip_segment_init(struct clip_segment*, double, double, double, double);
+    extern int             clip_segment(int, struct clip_segment*, int, int, int, int);
+    extern int             clip_liang_barsky(struct clip_segment*, int, int, int, int);
+    extern int             clip_cohen_sutherland(struct clip_segment*, int, int, int, int);
     /**@)*/
 
 
@@ -1,18 +1,45 @@
 #ifndef COLOR_H_
 #define COLOR_H_
 
+    #include <stdint.h>
+
     /**
-     * @brief Pointer to a color struct.
+     * @brief Packed colors: 0xRRGGBBAA, 8 bits per channel.
     */
-   typedef struct color * color_tt;
+    /**@(*/
+    #define COLOR_RGBA(r, g, b, a) ( ((uint32_t) (r) << 24) | ((uint32_t) (g) << 16) | ((uint32_t) (b) << 8) | (uint32_t) (a) )
+    #define COLOR_RED_OF(c)        ( ((c) >> 24) & 0xFF )
+    #define COLOR_GREEN_OF(c)      ( ((c) >> 16) & 0xFF )
+    #define COLOR_BLUE_OF(c)       ( ((c) >> 8) & 0xFF )
+    #define COLOR_ALPHA_OF(c)      ( (c) & 0xFF )
+    #define COLOR_BLACK            COLOR_RGBA(0, 0, 0, 255)
+    #define COLOR_RED              COLOR_RGBA(255, 0, 0, 255)
+    /**@)*/
+
+    #define PALETTE_MAX_COLORS 65536 /** << Palette indexes are 16 bits. */
 
     /**
-     * @brief Operations on Line.
+     * @brief Pointer to a palette struct.
+    */
+    typedef struct palette * palette_tt;
+
+    /**
+     * @brief Pointer to a const palette struct.
+    */
+    typedef const struct palette * const_palette_tt;
+
+    /**
+     * @brief Operations on Color and Palette.
     */
     /**@(*/
-    extern color_tt color_create(double, double, double);
-    extern void     color_destroy(color_tt);
-    extern double*  color_get_colors(color_tt);
+    extern uint32_t   color_pack(double, double, double);
+
+    extern palette_tt palette_create(void);
+    extern void       palette_destroy(palette_tt);
+    extern void       palette_clear(palette_tt);
+    extern uint16_t   palette_intern(palette_tt, uint32_t);
+    extern uint32_t   palette_get(const_palette_tt, uint16_t);
+    extern int        palette_size(const_palette_tt);
     /**@)*/
 
-#endif /* COLOR_H_ */
\ No newline at end of file
+#endif /* COLOR_H_ */
@@ -0,0 +1,59 @@
+#ifndef COMMAND_LOG_H_
+#define COMMAND_LOG_H_
+
+    #include "affine.h"
+    #include "handle.h"
+
+    /**
+     * @brief Kinds of commands.
+    */
+    /**@(*/
+    #define COMMAND_TRANSFORM 1 /** << Matrices applied to roots (handles), one shared or one per root. No handles = every root. */
+    #define COMMAND_CREATE    2 /** << Objects created (handles).                                                           */
+    #define COMMAND_GROUP     3 /** << A group (first handle) made of roots (other handles).                                 */
+    #define COMMAND_UNGROUP   4 /** << Groups split back: each group, its children and HANDLE_NONE. Groups' local matrices.  */
+    /**@)*/
+
+    /**
+     * @brief A command as it is kept in log: only what changed (a delta), never a copy of the scene.
+    */
+    struct command
+    {
+        int                  type;         /** << COMMAND_*.                                         */
+        const handle_tt     *handles;      /** << Handles affected (see COMMAND_*).                   */
+        int                  num_handles;  /** << Number of handles.                                  */
+        const struct affine *matrices;     /** << Matrices (see COMMAND_*).                            */
+        int                  num_matrices; /** << Number of matrices.                                 */
+    };
+
+    /**
+     * @brief Pointer to a command log struct.
+    */
+    typedef struct command_log * command_log_tt;
+
+    /**
+     * @brief Pointer to a const command log struct.
+    */
+    typedef const struct command_log * const_command_log_tt;
+
+    /**
+     * @brief Operations on Command Log: commands done (that can be undone) followed by commands undone (that can be redone).
+     * Handles and matrices of all commands are kept in two contiguous arrays, so recording never allocates per command.
+    */
+    /**@(*/
+    extern command_log_tt command_log_create(void);
+    extern void           command_log_destroy(command_log_tt);
+    extern void           command_log_clear(command_log_tt);
+    extern int            command_log_size(const_command_log_tt);
+    extern int            command_log_position(const_command_log_tt);
+    extern void           command_log_get(const_command_log_tt, int, struct command*);
+    extern size_t         command_log_bytes(const_command_log_tt);
+
+    extern void           command_log_begin(command_log_tt, int);
+    extern handle_tt     *command_log_add_handles(command_log_tt, int);
+    extern struct affine *command_log_add_matrices(command_log_tt, int);
+    extern int            command_log_undo(command_log_tt, struct command*);
+    extern int            command_log_redo(command_log_tt, struct command*);
+    /**@)*/
+
+#endif /* COMMAND_LOG_H_ */
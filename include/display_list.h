@@ -0,0 +1,61 @@
+#ifndef DISPLAY_LIST_H_
+#define DISPLAY_LIST_H_
+
+    #include <stdint.h>
+
+    /**
+     * @brief Types of drawing operations.
+    */
+    /**@(*/
+    #define DISPLAY_BRUSH         0 /** << 6x6 square at (x0, y0).                          */
+    #define DISPLAY_LINE          1 /** << Line from (x0, y0) to (x1, y1), drawn with algh. */
+    #define DISPLAY_CIRCUMFERENCE 2 /** << Circumference centered at (x0, y0), radius x1.   */
+    #define DISPLAY_LABEL         3 /** << "(X, Y)" label of point (x0, y0).                */
+    /**@)*/
+
+    /**
+     * @brief A single drawing operation. Coordinates are the same used by Points (origin at canvas' center).
+    */
+    struct display_op
+    {
+        int      type;  /** << Type of operation (DISPLAY_BRUSH, DISPLAY_LINE...). */
+        int      algh;  /** << Line drawing algorithm. 1 = DDA, 2 = Bresenham.     */
+        double   x0;    /** << First X coordinate.                                 */
+        double   y0;    /** << First Y coordinate.                                 */
+        double   x1;    /** << Second X coordinate (or radius).                    */
+        double   y1;    /** << Second Y coordinate.                                */
+        uint32_t color; /** << Color of operation (packed RGBA, see color.h).      */
+    };
+
+    /**
+     * @brief Pointer to a display list struct.
+    */
+    typedef struct display_list * display_list_tt;
+
+    /**
+     * @brief Pointer to a const display list struct.
+    */
+    typedef const struct display_list * const_display_list_tt;
+
+    /**
+     * @brief Operations on Display List.
+    */
+    /**@(*/
+    extern display_list_tt          display_list_create(int, int);
+    extern void                     display_list_destroy(display_list_tt);
+    extern void                     display_list_clear(display_list_tt);
+    extern void                     display_list_reset(display_list_tt, int, int);
+    extern int                      display_list_size(const_display_list_tt);
+    extern int                      display_list_center_x(const_display_list_tt);
+    extern int                      display_list_center_y(const_display_list_tt);
+    extern const struct display_op *display_list_get(const_display_list_tt, int);
+    extern void                     display_list_set_damage(display_list_tt, const double*);
+    extern int                      display_list_get_damage(const_display_list_tt, double*);
+
+    extern void                     display_list_add_brush(display_list_tt, double, double, uint32_t);
+    extern void                     display_list_add_line(display_list_tt, double, double, double, double, int, uint32_t);
+    extern void                     display_list_add_circumference(display_list_tt, double, double, double, uint32_t);
+    extern void                     display_list_add_label(display_list_tt, double, double);
+    /**@)*/
+
+#endif /* DISPLAY_LIST_H_ */
@@ -0,0 +1,34 @@
+#ifndef GRID_H_
+#define GRID_H_
+
+    #include "handle.h"
+
+    #define GRID_CELL_SIZE 64.0 /** << Default side (in world units) of a grid's cell.                          */
+    #define GRID_MAX_CELLS 1024 /** << Entries covering more cells are kept apart and tested by every query.   */
+
+    /**
+     * @brief Pointer to a grid struct.
+    */
+    typedef struct grid * grid_tt;
+
+    /**
+     * @brief Pointer to a const grid struct.
+    */
+    typedef const struct grid * const_grid_tt;
+
+    /**
+     * @brief Operations on Grid. Boxes are 4 doubles: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+    */
+    /**@(*/
+    extern grid_tt grid_create(double);
+    extern void    grid_destroy(grid_tt);
+    extern void    grid_clear(grid_tt);
+    extern int     grid_size(const_grid_tt);
+
+    extern void    grid_insert(grid_tt, handle_tt, const double*);
+    extern void    grid_remove(grid_tt, handle_tt);
+    extern void    grid_update(grid_tt, handle_tt, const double*);
+    extern int     grid_query(grid_tt, const double*, handle_list_tt*);
+    /**@)*/
+
+#endif /* GRID_H_ */
@@ -0,0 +1,59 @@
+#ifndef HANDLE_H_
+#define HANDLE_H_
+
+    #include <stdint.h>
+
+    #include "vector.h"
+
+    /**
+     * @brief Compact reference to a scene entity: low 24 bits are the index of a slot, high 8 bits are the slot's generation.
+     * Releasing a slot bumps its generation, so old handles go stale instead of referencing whatever reuses the slot.
+    */
+    typedef uint32_t handle_tt;
+
+    /**
+     * @brief Growable list of handles (see vector.h).
+    */
+    typedef VECTOR(handle_tt) handle_list_tt;
+
+    #define HANDLE_INDEX_BITS 24          /** << Bits of a handle used by the slot's index.           */
+    #define HANDLE_INDEX_MASK 0x00FFFFFFu /** << Mask of the slot's index.                            */
+    #define HANDLE_MAX_SLOTS  0x00FFFFFF  /** << Index 0xFFFFFF is never handed out (see HANDLE_NONE). */
+    #define HANDLE_NONE       0xFFFFFFFFu /** << No entity.                                           */
+
+    /**
+     * @brief Packing and unpacking of handles.
+    */
+    /**@(*/
+    #define HANDLE_MAKE(index, gen)  ( (handle_tt) ( ((uint32_t) (uint8_t) (gen) << HANDLE_INDEX_BITS) | ((uint32_t) (index) & HANDLE_INDEX_MASK) ) )
+    #define HANDLE_INDEX(h)          ( (int) ((h) & HANDLE_INDEX_MASK) )
+    #define HANDLE_GENERATION(h)     ( (uint8_t) ((h) >> HANDLE_INDEX_BITS) )
+    /**@)*/
+
+    /**
+     * @brief Pointer to a handle table struct.
+    */
+    typedef struct handle_table * handle_table_tt;
+
+    /**
+     * @brief Pointer to a const handle table struct.
+    */
+    typedef const struct handle_table * const_handle_table_tt;
+
+    /**
+     * @brief Operations on Handle Table.
+    */
+    /**@(*/
+    extern handle_table_tt handle_table_create(int);
+    extern void            handle_table_destroy(handle_table_tt);
+    extern void            handle_table_clear(handle_table_tt);
+    extern int             handle_table_size(const_handle_table_tt);
+
+    extern handle_tt       handle_alloc(handle_table_tt, int, void*);
+    extern void            handle_release(handle_table_tt, handle_tt);
+    extern int             handle_is_valid(const_handle_table_tt, handle_tt);
+    extern void           *handle_get(const_handle_table_tt, handle_tt);
+    extern int             handle_kind(const_handle_table_tt, handle_tt);
+    /**@)*/
+
+#endif /* HANDLE_H_ */
@@ -0,0 +1,42 @@
+#ifndef LABEL_H_
+#define LABEL_H_
+
+    #define LABEL_CELL_SIZE       8   /** << Side (in pixels) of an occupancy grid cell.                   */
+    #define LABEL_MAX_LABELS      200 /** << Default density cap. Maximum labels drawn per layout pass.    */
+    #define LABEL_LOD_FACTOR      4   /** << Candidates above cap * factor only show object vertices.      */
+    #define LABEL_CHAR_WIDTH      7   /** << Approximated width (in pixels) of a label character.          */
+    #define LABEL_HEIGHT          12  /** << Approximated height (in pixels) of a label.                   */
+
+    /**
+     * @brief Kinds of labels, ordered by importance. Lower values survive higher level of details.
+    */
+    /**@(*/
+    #define LABEL_VERTEX  0 /** << Vertex of an Object (Line, Polygon, Circumference or Clip). */
+    #define LABEL_POINT   1 /** << Free point, not taken by any Object.                        */
+    #define LABEL_CLIPPED 2 /** << Point created by a clipping algorithm.                      */
+    /**@)*/
+
+    /**
+     * @brief Pointer to a label layout struct.
+    */
+    typedef struct label_layout * label_layout_tt;
+
+    /**
+     * @brief Pointer to a const label layout struct.
+    */
+    typedef const struct label_layout * const_label_layout_tt;
+
+    /**
+     * @brief Operations on Label Layout.
+    */
+    /**@(*/
+    extern label_layout_tt label_layout_create(int, int, int);
+    extern void            label_layout_destroy(label_layout_tt);
+    extern void            label_layout_reset(label_layout_tt, int);
+    extern int             label_layout_damage(label_layout_tt, const double*, int);
+    extern int             label_layout_place(label_layout_tt, double, double, double, double, int);
+    extern int             label_layout_count(const_label_layout_tt);
+    extern void            label_layout_set_max(label_layout_tt, int);
+    /**@)*/
+
+#endif /* LABEL_H_ */
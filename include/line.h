@@ -1,6 +1,8 @@
 #ifndef LINE_H_
 #define LINE_H_
 
+    #include "affine.h"
+    #include "arena.h"
     #include "point.h"
 
     /**
@@ -17,15 +19,17 @@
      * @brief Operations on Line.
     */
     /**@(*/
-    extern line_tt   line_create(point_tt, point_tt, int);
-    extern void      line_destroy(line_tt);
-    extern int       line_id(const_line_tt);
-    extern void      line_add_clipped_points(line_tt, point_tt, point_tt, int);
-    extern int       line_get_algh(const_line_tt);
-    extern int       line_was_clipped(const_line_tt);
+    extern line_tt              line_create(arena_tt, point_tt, point_tt, int);
+    extern void                 line_destroy(line_tt);
+    extern void                 line_add_clipped_points(line_tt, point_tt, point_tt, int);
+    extern int                  line_get_algh(const_line_tt);
+    extern int                  line_was_clipped(const_line_tt);
 
-    extern point_tt* line_get_points(const_line_tt);
-    extern point_tt* line_get_clipped_points(const_line_tt);
+    extern const point_tt      *line_get_points(const_line_tt);
+    extern const point_tt      *line_get_clipped_points(const_line_tt);
+    extern void                 line_get_box(line_tt, double*);
+    extern const struct affine *line_get_matrix(const_line_tt);
+    extern void                 line_transform(line_tt, const struct affine*);
     /**@)*/
 
 #endif /* LINE_H_ */
\ No newline at end of file
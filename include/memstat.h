@@ -0,0 +1,59 @@
+#ifndef MEMSTAT_H_
+#define MEMSTAT_H_
+
+    #include <stddef.h>
+    #include <stdio.h>
+
+    /**
+     * @brief Modules whose memory is accounted.
+    */
+    /**@(*/
+    #define MEMSTAT_POINTS         0 /** << Point Store's arrays.                               */
+    #define MEMSTAT_COLORS         1 /** << Palette of colors.                                  */
+    #define MEMSTAT_LINES          2 /** << Lines (in scene's arena).                           */
+    #define MEMSTAT_POLYGONS       3 /** << Polygons and their points' handles (in arena).      */
+    #define MEMSTAT_CIRCUMFERENCES 4 /** << Circumferences (in scene's arena).                  */
+    #define MEMSTAT_CLIPS          5 /** << Clips and their points' handles (in arena).         */
+    #define MEMSTAT_TEMPORARY      6 /** << Buffers only alive during an operation.             */
+    #define MEMSTAT_COMMANDS       7 /** << Undo/redo log of commands (see command_log.h).      */
+    #define MEMSTAT_NUM_MODULES    8
+    /**@)*/
+
+    #define MEMSTAT_ENV "QMAIN_MEMSTAT" /** << If set (to anything but "0"), statistics are written to stderr on exit. */
+
+    /**
+     * @brief Counters of a module (or of all of them).
+    */
+    struct memstat_counters
+    {
+        long long live_bytes;   /** << Bytes in use.                          */
+        long long peak_bytes;   /** << Most bytes ever in use at once.        */
+        long long live_allocs;  /** << Allocations in use.                    */
+        long long total_allocs; /** << Allocations ever made.                 */
+    };
+
+    /**
+     * @brief Counters of every module at a given moment.
+    */
+    struct memstat_snapshot
+    {
+        struct memstat_counters modules[MEMSTAT_NUM_MODULES]; /** << By MEMSTAT_* module.                             */
+        struct memstat_counters total;                        /** << Sum of all modules (peak is the sum of peaks). */
+    };
+
+    /**
+     * @brief Operations on Memory Statistics. Counters are atomic, so any thread may update them.
+    */
+    /**@(*/
+    extern void        memstat_alloc(int, size_t);
+    extern void        memstat_release(int, size_t);
+    extern void        memstat_resize(int, size_t, size_t);
+    extern void        memstat_release_all(int);
+
+    extern void        memstat_snapshot(struct memstat_snapshot*);
+    extern const char *memstat_module_name(int);
+    extern void        memstat_dump(FILE*);
+    extern void        memstat_dump_on_exit(void);
+    /**@)*/
+
+#endif /* MEMSTAT_H_ */
@@ -40,6 +40,7 @@
 	extern void      array_destroy(array_tt);
 	extern int       array_size(const_array_tt);
 	extern void      array_set(array_tt, int, const void *);
+	extern void      array_append(array_tt, const void *);
 	extern void     *array_get(const_array_tt, int);
 	extern int       array_get_curr_num(const_array_tt);
 	extern void      array_set_curr_num(array_tt, int);
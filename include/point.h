@@ -1,33 +1,43 @@
 #ifndef POINT_H_
 #define POINT_H_
 
-    #include "color.h"
+    #include "point_store.h"
 
-    /**
-     * @brief Pointer to a point struct.
-    */
-    typedef struct point * point_tt;
+    #define POINT_NONE HANDLE_NONE /** << No point (e.g. clipped points of an object that is outside Clip). */
 
     /**
-     * @brief Pointer to a const point struct.
+     * @brief Handle (see handle.h) of a point in the scene's point store (see point_store.h). Its index is the point's slot in store's arrays.
     */
-    typedef const struct point * const_point_tt;
+    typedef handle_tt point_tt;
 
     /**
      * @brief Operations on Point.
     */
     /**@(*/
-    extern point_tt point_create(double, double);
-    extern void     point_destroy(point_tt);
-    extern double   point_x_coord(const_point_tt);
-    extern double   point_y_coord(const_point_tt);
-    extern void     point_set_coord(point_tt, double, double);
-    extern int      point_id(const_point_tt);
+    extern point_tt       point_create(double, double);
+    extern void           point_destroy(point_tt);
+    extern double         point_x_coord(point_tt);
+    extern double         point_y_coord(point_tt);
+    extern void           point_set_coord(point_tt, double, double);
+    extern int            point_index(point_tt);
+    extern int            point_is_valid(point_tt);
+    extern void           point_get_box(const point_tt*, int, double*);
+    extern void           point_gather(const point_tt*, int, double*, double*);
+    extern unsigned       point_epoch(void);
+
+    extern void           point_take(point_tt);
+    extern int            point_is_taken(point_tt);
+    extern void           point_mark(point_tt, unsigned char);
+    extern void           point_unmark(point_tt, unsigned char);
+    extern unsigned char  point_flags(point_tt);
+    extern void           point_define_color(point_tt, double, double, double);
+    extern uint32_t       point_color(point_tt);
 
-    extern void     point_take(point_tt);
-    extern int      point_is_taken(const_point_tt);
-    extern void     point_define_color(point_tt, double, double, double);
-    extern color_tt point_color(const_point_tt);
+    extern point_store_tt point_get_store(void);
+    extern int            point_count(void);
+    extern int            point_live_count(void);
+    extern point_tt       point_at(int);
+    extern void           point_clear(void);
     /**@)*/
 
-#endif /* POINT_H_ */
\ No newline at end of file
+#endif /* POINT_H_ */
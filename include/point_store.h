@@ -0,0 +1,53 @@
+#ifndef POINT_STORE_H_
+#define POINT_STORE_H_
+
+    #include <stdint.h>
+
+    #include "color.h"
+    #include "handle.h"
+
+    /**
+     * @brief Flags of a point in the store.
+    */
+    /**@(*/
+    #define POINT_ALIVE   0x01 /** << Point exists (free slots have no flags).    */
+    #define POINT_TAKEN   0x02 /** << Point is taken by an object.                */
+    #define POINT_CLIP    0x04 /** << Point belongs to a Clip area.               */
+    #define POINT_CLIPPED 0x08 /** << Point was created by clipping an object.    */
+    /**@)*/
+
+    /**
+     * @brief Pointer to a point store struct.
+    */
+    typedef struct point_store * point_store_tt;
+
+    /**
+     * @brief Pointer to a const point store struct.
+    */
+    typedef const struct point_store * const_point_store_tt;
+
+    /**
+     * @brief Operations on Point Store.
+    */
+    /**@(*/
+    extern point_store_tt point_store_create(int);
+    extern void           point_store_destroy(point_store_tt);
+    extern void           point_store_clear(point_store_tt);
+    extern int            point_store_add(point_store_tt, double, double, unsigned char);
+    extern void           point_store_remove(point_store_tt, int);
+    extern int            point_store_size(const_point_store_tt);
+    extern int            point_store_live(const_point_store_tt);
+    extern void           point_store_touch(point_store_tt);
+    extern unsigned       point_store_epoch(const_point_store_tt);
+
+    extern double        *point_store_x(point_store_tt);
+    extern double        *point_store_y(point_store_tt);
+    extern unsigned char *point_store_flags(point_store_tt);
+    extern uint16_t      *point_store_color_index(point_store_tt);
+    extern const uint8_t *point_store_generation(const_point_store_tt);
+
+    extern uint16_t       point_store_intern_color(point_store_tt, uint32_t);
+    extern uint32_t       point_store_color(const_point_store_tt, uint16_t);
+    /**@)*/
+
+#endif /* POINT_STORE_H_ */
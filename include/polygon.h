@@ -2,9 +2,9 @@
 #define POLYGON_H_
 
 
+    #include "affine.h"
+    #include "arena.h"
     #include "point.h"
-    #include "array.h"
-    #define MAX_POINTS 50
 
     /**
      * @brief Pointer to a polygon struct.
@@ -20,15 +20,19 @@
      * @brief Operations on polygons.
     */
     /**@(*/
-    extern polygon_tt polygon_create(point_tt*, int, int);
-    extern void       polygon_destroy(polygon_tt);
-    extern int        polygon_id(const_polygon_tt);
-    extern void       polygon_add_clipped_points(polygon_tt, point_tt*, int, int);
-    extern int        polygon_get_algh(const_polygon_tt);
-    extern int        polygon_was_clipped(const_polygon_tt);
+    extern polygon_tt           polygon_create(arena_tt, const point_tt*, int, int);
+    extern void                 polygon_destroy(polygon_tt);
+    extern void                 polygon_add_clipped_points(polygon_tt, arena_tt, const point_tt*, int, int);
+    extern int                  polygon_get_algh(const_polygon_tt);
+    extern int                  polygon_was_clipped(const_polygon_tt);
 
-    extern array_tt  polygon_get_points(const_polygon_tt);
-    extern array_tt  polygon_get_clipped_points(const_polygon_tt);
+    extern const point_tt      *polygon_get_points(const_polygon_tt);
+    extern int                  polygon_num_points(const_polygon_tt);
+    extern void                 polygon_get_box(polygon_tt, double*);
+    extern const struct affine *polygon_get_matrix(const_polygon_tt);
+    extern void                 polygon_transform(polygon_tt, const struct affine*);
+    extern const point_tt      *polygon_get_clipped_points(const_polygon_tt);
+    extern int                  polygon_num_clipped_points(const_polygon_tt);
     /**@)*/
 
 #endif /* POLYGON_H_ */
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef RASTER_H_
+#define RASTER_H_
+
+    #include <cairo.h>
+    #include <stdint.h>
+
+    #include "display_list.h"
+
+    #define RASTER_BRUSH_SIZE 6  /** << Side (in pixels) of a plotted point.      */
+    #define RASTER_LABEL_SIZE 32 /** << Maximum length of a "(X, Y)" label text. */
+
+    /**
+     * @brief Where canvas' origin is and which part of canvas is being rasterized. Rasterization only depends on it
+     * and on the cairo context, so it can run in any thread.
+    */
+    struct raster_view
+    {
+        int center_x; /** << Canvas' center X, in pixels.                                     */
+        int center_y; /** << Canvas' center Y, in pixels.                                     */
+        int clip_x0;  /** << Left of rasterized area, in pixels. Brushes outside are skipped. */
+        int clip_y0;  /** << Top of rasterized area, in pixels.                               */
+        int clip_x1;  /** << Right of rasterized area, in pixels.                             */
+        int clip_y1;  /** << Bottom of rasterized area, in pixels.                            */
+    };
+
+    /**
+     * @brief Operations on Rasterization.
+    */
+    /**@(*/
+    extern void raster_brush(cairo_t*, const struct raster_view*, double, double, uint32_t);
+    extern void raster_dda(cairo_t*, const struct raster_view*, double, double, double, double, uint32_t);
+    extern void raster_bresenham(cairo_t*, const struct raster_view*, double, double, double, double, uint32_t);
+    extern void raster_circumference(cairo_t*, const struct raster_view*, double, double, double, uint32_t);
+    extern int  raster_clip_segment(double, double, double, double, const double*, double*);
+    extern void raster_label(cairo_t*, const struct raster_view*, double, double);
+    extern int  raster_label_text(char*, double, double);
+    extern void raster_view_init(struct raster_view*, const_display_list_tt);
+    extern void raster_op(cairo_t*, const struct raster_view*, const struct display_op*);
+
+    extern void raster_display_list(cairo_t*, const_display_list_tt);
+    /**@)*/
+
+#endif /* RASTER_H_ */
@@ -0,0 +1,36 @@
+#ifndef RENDERER_H_
+#define RENDERER_H_
+
+    #include <gtk/gtk.h>
+
+    #include "display_list.h"
+    #include "scheduler.h"
+
+    #define RENDER_SINGLE 0 /** << Render thread rasterizes the whole buffer by itself.                   */
+    #define RENDER_TILED  1 /** << Buffer is split into tiles rasterized by scheduler's threads.          */
+    #define RENDER_SLICED 2 /** << GTK's frame clock rasterizes, in priority order, a budget per frame. */
+
+    #define RENDER_DEFAULT_BUDGET 8000 /** << Default time (in microseconds) RENDER_SLICED spends per frame. */
+    #define RENDER_SPARE_LISTS    3    /** << Rasterized display lists kept to be recorded again.           */
+
+    /**
+     * @brief Pointer to a renderer struct.
+    */
+    typedef struct renderer * renderer_tt;
+
+    /**
+     * @brief Operations on Renderer.
+    */
+    /**@(*/
+    extern renderer_tt     renderer_create(GtkWidget*, scheduler_tt, int, int);
+    extern void            renderer_destroy(renderer_tt);
+    extern void            renderer_resize(renderer_tt, int, int);
+    extern display_list_tt renderer_acquire(renderer_tt, int, int);
+    extern int             renderer_submit(renderer_tt, display_list_tt);
+    extern int             renderer_is_busy(renderer_tt);
+    extern void            renderer_present(renderer_tt, cairo_t*);
+    extern void            renderer_set_mode(renderer_tt, int);
+    extern void            renderer_set_budget(renderer_tt, gint64);
+    /**@)*/
+
+#endif /* RENDERER_H_ */
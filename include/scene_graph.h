@@ -0,0 +1,44 @@
+#ifndef SCENE_GRAPH_H_
+#define SCENE_GRAPH_H_
+
+    #include "affine.h"
+    #include "handle.h"
+
+    /**
+     * @brief Pointer to a scene graph struct.
+    */
+    typedef struct scene_graph * scene_graph_tt;
+
+    /**
+     * @brief Pointer to a const scene graph struct.
+    */
+    typedef const struct scene_graph * const_scene_graph_tt;
+
+    /**
+     * @brief Operations on Scene Graph: groups of nodes (Objects or other groups), referenced by handles. Each group has a local matrix,
+     * mapping its children to its parent (or to the world). World matrices of groups are computed lazily and cached: transforming a group
+     * only marks its subgroups dirty, children are never touched.
+    */
+    /**@(*/
+    extern scene_graph_tt        scene_graph_create(void);
+    extern void                  scene_graph_destroy(scene_graph_tt);
+    extern void                  scene_graph_clear(scene_graph_tt);
+    extern int                   scene_graph_num_groups(const_scene_graph_tt);
+    extern handle_tt             scene_graph_group_at(const_scene_graph_tt, int);
+    extern int                   scene_graph_is_group(const_scene_graph_tt, handle_tt);
+
+    extern void                  scene_graph_group(scene_graph_tt, handle_tt, const handle_tt*, int);
+    extern void                  scene_graph_ungroup(scene_graph_tt, handle_tt, handle_list_tt*);
+    extern handle_tt             scene_graph_parent(const_scene_graph_tt, handle_tt);
+    extern handle_tt             scene_graph_root(const_scene_graph_tt, handle_tt);
+    extern const handle_list_tt *scene_graph_children(const_scene_graph_tt, handle_tt);
+    extern handle_tt             scene_graph_first_leaf(const_scene_graph_tt, handle_tt);
+    extern void                  scene_graph_leaves(const_scene_graph_tt, handle_tt, handle_list_tt*);
+
+    extern const struct affine  *scene_graph_local(const_scene_graph_tt, handle_tt);
+    extern void                  scene_graph_transform(scene_graph_tt, handle_tt, const struct affine*);
+    extern const struct affine  *scene_graph_world(scene_graph_tt, handle_tt);
+    extern void                  scene_graph_resolve(scene_graph_tt);
+    /**@)*/
+
+#endif /* SCENE_GRAPH_H_ */
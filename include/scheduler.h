@@ -0,0 +1,24 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+    /**
+     * @brief Pointer to a scheduler struct.
+    */
+    typedef struct scheduler * scheduler_tt;
+
+    /**
+     * @brief Job function. Processes indexes [begin, end) of a parallel loop.
+    */
+    typedef void (*scheduler_job_fn)(int begin, int end, void *arg);
+
+    /**
+     * @brief Operations on Scheduler.
+    */
+    /**@(*/
+    extern scheduler_tt scheduler_create(int);
+    extern void         scheduler_destroy(scheduler_tt);
+    extern int          scheduler_threads(scheduler_tt);
+    extern void         scheduler_parallel_for(scheduler_tt, int, int, scheduler_job_fn, void*);
+    /**@)*/
+
+#endif /* SCHEDULER_H_ */
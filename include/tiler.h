@@ -0,0 +1,25 @@
+#ifndef TILER_H_
+#define TILER_H_
+
+    #include <cairo.h>
+
+    #include "display_list.h"
+    #include "scheduler.h"
+
+    #define TILE_SIZE 128 /** << Side (in pixels) of a tile. */
+
+    /**
+     * @brief Pointer to a tiler struct.
+    */
+    typedef struct tiler * tiler_tt;
+
+    /**
+     * @brief Operations on Tiler.
+    */
+    /**@(*/
+    extern tiler_tt tiler_create(scheduler_tt);
+    extern void     tiler_destroy(tiler_tt);
+    extern void     tiler_rasterize(tiler_tt, cairo_surface_t*, const_display_list_tt);
+    /**@)*/
+
+#endif /* TILER_H_ */
@@ -0,0 +1,51 @@
+#ifndef TRANSFORM_SCRIPT_H_
+#define TRANSFORM_SCRIPT_H_
+
+    /**
+     * @brief Kinds of transformations (steps of a script).
+    */
+    /**@(*/
+    #define TRANSFORM_TRANSLATION   1 /** << 'T(X,Y)'. */
+    #define TRANSFORM_ROTATION      2 /** << 'RXd'.    */
+    #define TRANSFORM_SCALE         3 /** << 'S(X,Y)'. */
+    #define TRANSFORM_X_REFLECTION  4 /** << 'RX'.     */
+    #define TRANSFORM_Y_REFLECTION  5 /** << 'RY'.     */
+    #define TRANSFORM_XY_REFLECTION 6 /** << 'RXY'.    */
+    /**@)*/
+
+    /**
+     * @brief A step of a script: a transformation and its values.
+    */
+    struct transform_step
+    {
+        int    type;      /** << TRANSFORM_*.                                                        */
+        double values[2]; /** << (X, Y) of Translation and Scale, angle (radians) of Rotation.      */
+        int    line;      /** << Line of script where step starts (from 1).                        */
+    };
+
+    /**
+     * @brief Pointer to a transform script struct.
+    */
+    typedef struct transform_script * transform_script_tt;
+
+    /**
+     * @brief Pointer to a const transform script struct.
+    */
+    typedef const struct transform_script * const_transform_script_tt;
+
+    /**
+     * @brief Operations on Transform Script: a sequence of transformations written as text, e.g. 'T(10,5); R30d; S(2,2); RX'.
+     * Steps are separated by ';' or new lines, '#' starts a comment up to end of line. Parsing never copies text nor allocates per token.
+    */
+    /**@(*/
+    extern transform_script_tt          transform_script_create(void);
+    extern void                         transform_script_destroy(transform_script_tt);
+    extern int                          transform_script_parse(transform_script_tt, const char*);
+    extern int                          transform_script_parse_template(transform_script_tt, const char*, int);
+    extern int                          transform_script_size(const_transform_script_tt);
+    extern const struct transform_step *transform_script_get(const_transform_script_tt, int);
+    extern const char                  *transform_script_error(const_transform_script_tt, int*, int*);
+    extern const char                  *transform_script_name(int);
+    /**@)*/
+
+#endif /* TRANSFORM_SCRIPT_H_ */
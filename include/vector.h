@@ -0,0 +1,48 @@
+#ifndef VECTOR_H_
+#define VECTOR_H_
+
+    #include <assert.h>
+    #include <stdlib.h>
+
+    #define VECTOR_MIN_CAPACITY 8 /** << Minimum capacity after growing. */
+
+    /**
+     * @brief Typed, growable and contiguous vector. Declares an anonymous struct, e.g. VECTOR(int) v; or typedef VECTOR(double) vector_double_tt;
+     * Unlike array_tt (which holds pointers), elements are stored by value.
+    */
+    #define VECTOR(type) struct { type *data; int size; int capacity; }
+
+    /**
+     * @brief Operations on Vector.
+    */
+    /**@(*/
+    #define vector_init(v)         ( (v)->data = NULL, (v)->size = 0, (v)->capacity = 0 )
+    #define vector_free(v)         ( free((v)->data), vector_init(v) )
+    #define vector_clear(v)        ( (v)->size = 0 )
+    #define vector_reserve(v, n)   ( ((n) > (v)->capacity) ? vector_grow((void**) &(v)->data, &(v)->capacity, (n), sizeof(*(v)->data)) : (void) 0 )
+    #define vector_push(v, value)  ( vector_reserve((v), (v)->size + 1), (v)->data[(v)->size++] = (value) )
+    #define vector_get(v, idx)     ( (v)->data[(idx)] )
+    /**@)*/
+
+    /**
+     * @brief Grows a vector's storage, doubling its capacity until n elements fit (amortized O(1) push).
+     *
+     * @param data     Vector's storage.
+     * @param capacity Vector's capacity.
+     * @param n        Number of elements that must fit.
+     * @param elem     Size of an element.
+    */
+    static inline void vector_grow(void   **data,
+                                   int     *capacity,
+                                   int      n,
+                                   size_t   elem)
+    {
+        int c = ( *capacity < VECTOR_MIN_CAPACITY ) ? VECTOR_MIN_CAPACITY : *capacity;
+
+        while ( c < n ) c *= 2;
+        *data = realloc(*data, elem * c);
+        assert( *data != NULL );
+        *capacity = c;
+    }
+
+#endif /* VECTOR_H_ */
@@ -0,0 +1,357 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+
+#include "affine.h"
+#include "vector.h"
+
+/**
+ * @brief A step of a chain.
+*/
+struct affine_step
+{
+    struct affine matrix; /** << Transformation.                                  */
+    int           pinned; /** << If it is applied around chain's anchor. 0/1.     */
+};
+
+struct affine_chain
+{
+    VECTOR(struct affine_step) steps;      /** << Steps, in the order they are applied.           */
+    struct affine              composed;   /** << Product of all steps (valid if none is pinned). */
+    int                        num_pinned; /** << Number of pinned steps.                         */
+};
+
+/**
+ * @brief Sets a matrix to identity.
+ *
+ * @param a Given matrix.
+*/
+void affine_identity(struct affine *a)
+{
+    /* Sanity Check. */
+    assert( a != NULL );
+
+    for ( int i = 0; i < 3; i++ )
+        for ( int j = 0; j < 3; j++ ) a->m[i][j] = ( i == j ) ? 1.0 : 0.0;
+}
+
+/**
+ * @brief Sets a matrix to a translation.
+ *
+ * @param a  Given matrix.
+ * @param tx X offset.
+ * @param ty Y offset.
+*/
+void affine_translation(struct affine *a,
+                        double         tx,
+                        double         ty)
+{
+    affine_identity(a);
+    a->m[0][2] = tx;
+    a->m[1][2] = ty;
+}
+
+/**
+ * @brief Sets a matrix to a scale (around origin). Reflections are scales by -1.
+ *
+ * @param a  Given matrix.
+ * @param sx X factor.
+ * @param sy Y factor.
+*/
+void affine_scale(struct affine *a,
+                  double         sx,
+                  double         sy)
+{
+    affine_identity(a);
+    a->m[0][0] = sx;
+    a->m[1][1] = sy;
+}
+
+/**
+ * @brief Sets a matrix to a rotation (around origin).
+ *
+ * @param a     Given matrix.
+ * @param angle Angle, in radians.
+*/
+void affine_rotation(struct affine *a,
+                     double         angle)
+{
+    double c = cos(angle),
+           s = sin(angle);
+
+    affine_identity(a);
+    a->m[0][0] = c;
+    a->m[0][1] = -s;
+    a->m[1][0] = s;
+    a->m[1][1] = c;
+}
+
+/**
+ * @brief Multiplies two matrices: applying result is the same as applying b, then a.
+ *
+ * @param out Output: a * b. May be a or b.
+ * @param a   Matrix applied last.
+ * @param b   Matrix applied first.
+*/
+void affine_multiply(struct affine       *out,
+                     const struct affine *a,
+                     const struct affine *b)
+{
+    /* Sanity Check. */
+    assert( out != NULL && a != NULL && b != NULL );
+
+    struct affine r;
+
+    for ( int i = 0; i < 3; i++ )
+        for ( int j = 0; j < 3; j++ ) r.m[i][j] = (a->m[i][0] * b->m[0][j]) + (a->m[i][1] * b->m[1][j]) + (a->m[i][2] * b->m[2][j]);
+    *out = r;
+}
+
+/**
+ * @brief Inverts a matrix: applying a, then its inverse, gives every point back (up to rounding).
+ *
+ * @param out Output: inverse of a. May be a. Unchanged if a has no inverse.
+ * @param a   Given matrix.
+ *
+ * @returns 1 if a has an inverse, 0 if it collapses the plane (e.g. a scale by 0).
+*/
+int affine_invert(struct affine       *out,
+                  const struct affine *a)
+{
+    /* Sanity Check. */
+    assert( out != NULL && a != NULL );
+
+    double det = (a->m[0][0] * a->m[1][1]) - (a->m[0][1] * a->m[1][0]);
+    if ( det == 0.0 || !isfinite(det) ) return (0);
+
+    // Last row is always (0, 0, 1): inverse of the 2x2 part, then translation is moved back through it
+    struct affine r;
+    r.m[0][0] =  a->m[1][1] / det;
+    r.m[0][1] = -a->m[0][1] / det;
+    r.m[1][0] = -a->m[1][0] / det;
+    r.m[1][1] =  a->m[0][0] / det;
+    r.m[0][2] = -(r.m[0][0] * a->m[0][2]) - (r.m[0][1] * a->m[1][2]);
+    r.m[1][2] = -(r.m[1][0] * a->m[0][2]) - (r.m[1][1] * a->m[1][2]);
+    r.m[2][0] = r.m[2][1] = 0.0;
+    r.m[2][2] = 1.0;
+    *out = r;
+
+    return (1);
+}
+
+/**
+ * @brief Makes a matrix act around a point instead of the origin: T(px, py) * a * T(-px, -py).
+ *
+ * @param out Output. May be a.
+ * @param a   Given matrix.
+ * @param px  Point's X coordinate.
+ * @param py  Point's Y coordinate.
+*/
+void affine_about(struct affine       *out,
+                  const struct affine *a,
+                  double               px,
+                  double               py)
+{
+    struct affine t;
+
+    affine_translation(&t, -px, -py);
+    affine_multiply(out, a, &t);
+    affine_translation(&t, px, py);
+    affine_multiply(out, &t, out);
+}
+
+/**
+ * @brief Applies a matrix to a point.
+ *
+ * @param a Given matrix.
+ * @param x X coordinate. Output: transformed X coordinate.
+ * @param y Y coordinate. Output: transformed Y coordinate.
+*/
+void affine_apply(const struct affine *a,
+                  double              *x,
+                  double              *y)
+{
+    double px = *x,
+           py = *y;
+
+    *x = (a->m[0][0] * px) + (a->m[0][1] * py) + a->m[0][2];
+    *y = (a->m[1][0] * px) + (a->m[1][1] * py) + a->m[1][2];
+}
+
+/**
+ * @brief Applies a matrix to a box: returns the box of its transformed corners. It holds every transformed point of the given box,
+ * but it is not the tightest one when matrix rotates.
+ *
+ * @param a   Given matrix.
+ * @param box Given box: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+ * @param out Output: transformed box. May be box.
+*/
+void affine_apply_box(const struct affine *a,
+                      const double        *box,
+                      double              *out)
+{
+    double r[4] = { INFINITY, INFINITY, -INFINITY, -INFINITY };
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        double x = box[(i & 1) ? 2 : 0],
+               y = box[(i & 2) ? 3 : 1];
+        affine_apply(a, &x, &y);
+        r[0] = fmin(r[0], x);
+        r[1] = fmin(r[1], y);
+        r[2] = fmax(r[2], x);
+        r[3] = fmax(r[3], y);
+    }
+    for ( int i = 0; i < 4; i++ ) out[i] = r[i];
+}
+
+/**
+ * @brief Initializes the Affine Chain structure, with no steps.
+ *
+ * @returns An affine chain.
+*/
+affine_chain_tt affine_chain_create(void)
+{
+    struct affine_chain *c = (struct affine_chain*) malloc(sizeof(struct affine_chain));
+
+    vector_init(&c->steps);
+    affine_chain_clear(c);
+
+    return (c);
+}
+
+/**
+ * @brief Destroys the Affine Chain structure.
+ *
+ * @param c Given chain.
+*/
+void affine_chain_destroy(struct affine_chain *c)
+{
+    /* Sanity Check. */
+    assert( c != NULL );
+
+    vector_free(&c->steps);
+    free(c);
+}
+
+/**
+ * @brief Removes all steps, keeping memory to be reused.
+ *
+ * @param c Given chain.
+*/
+void affine_chain_clear(struct affine_chain *c)
+{
+    /* Sanity Check. */
+    assert( c != NULL );
+
+    vector_clear(&c->steps);
+    affine_identity(&c->composed);
+    c->num_pinned = 0;
+}
+
+/**
+ * @brief Returns the number of steps.
+ *
+ * @param c Given chain.
+ *
+ * @returns Number of steps.
+*/
+int affine_chain_size(const struct affine_chain *c)
+{
+    /* Sanity Check. */
+    assert( c != NULL );
+
+    return (c->steps.size);
+}
+
+/**
+ * @brief Appends a step, applied after every step already in chain.
+ *
+ * @param c      Given chain.
+ * @param a      Step's matrix.
+ * @param pinned If matrix is applied around chain's anchor (as it is at this step). 0 = No, 1 = Yes.
+*/
+void affine_chain_push(struct affine_chain *c,
+                       const struct affine *a,
+                       int                  pinned)
+{
+    /* Sanity Check. */
+    assert( c != NULL && a != NULL );
+
+    struct affine_step s = { *a, pinned };
+    vector_push(&c->steps, s);
+    if ( pinned ) c->num_pinned++;
+    else affine_multiply(&c->composed, a, &c->composed);
+}
+
+/**
+ * @brief Returns if any step is pinned, i.e. if chain's matrix depends on its anchor.
+ *
+ * @param c Given chain.
+ *
+ * @returns If chain is pinned. 0 = No (same matrix for every anchor), 1 = Yes.
+*/
+int affine_chain_is_pinned(const struct affine_chain *c)
+{
+    /* Sanity Check. */
+    assert( c != NULL );
+
+    return ( c->num_pinned > 0 );
+}
+
+/**
+ * @brief Composes all steps in one matrix, for a given anchor. Pinned steps are applied around the anchor as moved by previous steps.
+ * O(1) if chain is not pinned, O(steps) otherwise.
+ *
+ * @param c   Given chain.
+ * @param ax  Anchor's X coordinate (before any step).
+ * @param ay  Anchor's Y coordinate (before any step).
+ * @param out Output: a matrix that applies every step at once.
+*/
+void affine_chain_resolve(const struct affine_chain *c,
+                          double                     ax,
+                          double                     ay,
+                          struct affine             *out)
+{
+    /* Sanity Check. */
+    assert( c != NULL && out != NULL );
+
+    if ( c->num_pinned == 0 )
+    {
+        *out = c->composed;
+        return;
+    }
+
+    affine_identity(out);
+    for ( int i = 0; i < c->steps.size; i++ )
+    {
+        const struct affine_step *s = &c->steps.data[i];
+        struct affine step = s->matrix;
+
+        if ( s->pinned )
+        {
+            double px = ax,
+                   py = ay;
+            affine_apply(out, &px, &py);
+            affine_about(&step, &s->matrix, px, py);
+        }
+        affine_multiply(out, &step, out);
+    }
+}
+
+/**
+ * @brief Composes all steps but pinned ones, e.g. for an object a pinned step would not change (a Circumference rotated around its center).
+ * O(1), their product is kept as steps are pushed.
+ *
+ * @param c   Given chain.
+ * @param out Output: a matrix that applies every step that is not pinned at once.
+*/
+void affine_chain_resolve_unpinned(const struct affine_chain *c,
+                                   struct affine             *out)
+{
+    /* Sanity Check. */
+    assert( c != NULL && out != NULL );
+
+    *out = c->composed;
+}
@@ -0,0 +1,232 @@
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+
+#include "affine_kernel.h"
+
+// Every level must give the same results, so multiply and add are never fused (e.g. when built with -march=native)
+#if defined(__clang__)
+    #pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+    #pragma GCC optimize ("fp-contract=off")
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define AFFINE_KERNEL_X86 /** << SSE2 and AVX2 kernels are built (and picked if CPU supports them). */
+#endif
+
+/**
+ * @brief Level in use, AFFINE_KERNEL_*. -1 until first use.
+*/
+static atomic_int level = -1;
+
+/**
+ * @brief Names of levels, by AFFINE_KERNEL_* level.
+*/
+static const char *names[3] = { "scalar", "sse2", "avx2" };
+
+/**
+ * @brief Applies a matrix to points [begin, n), one at a time. Tail of SIMD kernels.
+ * Every kernel computes X' = ((m00 * X) + (m01 * Y)) + m02 in this order (no fused multiply-add), so results are the same.
+ *
+ * @param a     Given matrix.
+ * @param x     X coordinates.
+ * @param y     Y coordinates.
+ * @param out_x Output: transformed X coordinates.
+ * @param out_y Output: transformed Y coordinates.
+ * @param begin First point.
+ * @param n     Number of points.
+*/
+static void affine_kernel_scalar(const struct affine *a,
+                                 const double        *x,
+                                 const double        *y,
+                                 double              *out_x,
+                                 double              *out_y,
+                                 int                  begin,
+                                 int                  n)
+{
+    const double m00 = a->m[0][0], m01 = a->m[0][1], m02 = a->m[0][2],
+                 m10 = a->m[1][0], m11 = a->m[1][1], m12 = a->m[1][2];
+
+    for ( int i = begin; i < n; i++ )
+    {
+        double px = x[i],
+               py = y[i];
+        out_x[i] = ((m00 * px) + (m01 * py)) + m02;
+        out_y[i] = ((m10 * px) + (m11 * py)) + m12;
+    }
+}
+
+#ifdef AFFINE_KERNEL_X86
+
+/**
+ * @brief Applies a matrix to n points, 2 per instruction. See affine_kernel_scalar.
+*/
+__attribute__((target("sse2")))
+static void affine_kernel_sse2(const struct affine *a,
+                               const double        *x,
+                               const double        *y,
+                               double              *out_x,
+                               double              *out_y,
+                               int                  n)
+{
+    const __m128d m00 = _mm_set1_pd(a->m[0][0]), m01 = _mm_set1_pd(a->m[0][1]), m02 = _mm_set1_pd(a->m[0][2]),
+                  m10 = _mm_set1_pd(a->m[1][0]), m11 = _mm_set1_pd(a->m[1][1]), m12 = _mm_set1_pd(a->m[1][2]);
+    int i = 0;
+
+    for ( ; i + 2 <= n; i += 2 )
+    {
+        __m128d px = _mm_loadu_pd(&x[i]),
+                py = _mm_loadu_pd(&y[i]);
+        _mm_storeu_pd(&out_x[i], _mm_add_pd(_mm_add_pd(_mm_mul_pd(m00, px), _mm_mul_pd(m01, py)), m02));
+        _mm_storeu_pd(&out_y[i], _mm_add_pd(_mm_add_pd(_mm_mul_pd(m10, px), _mm_mul_pd(m11, py)), m12));
+    }
+    affine_kernel_scalar(a, x, y, out_x, out_y, i, n);
+}
+
+/**
+ * @brief Applies a matrix to n points, 4 per instruction (8 per iteration). See affine_kernel_scalar.
+*/
+__attribute__((target("avx2")))
+static void affine_kernel_avx2(const struct affine *a,
+                               const double        *x,
+                               const double        *y,
+                               double              *out_x,
+                               double              *out_y,
+                               int                  n)
+{
+    const __m256d m00 = _mm256_set1_pd(a->m[0][0]), m01 = _mm256_set1_pd(a->m[0][1]), m02 = _mm256_set1_pd(a->m[0][2]),
+                  m10 = _mm256_set1_pd(a->m[1][0]), m11 = _mm256_set1_pd(a->m[1][1]), m12 = _mm256_set1_pd(a->m[1][2]);
+    int i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+        __m256d px0 = _mm256_loadu_pd(&x[i]),
+                py0 = _mm256_loadu_pd(&y[i]),
+                px1 = _mm256_loadu_pd(&x[i + 4]),
+                py1 = _mm256_loadu_pd(&y[i + 4]);
+        __m256d ox0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m00, px0), _mm256_mul_pd(m01, py0)), m02),
+                oy0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m10, px0), _mm256_mul_pd(m11, py0)), m12),
+                ox1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m00, px1), _mm256_mul_pd(m01, py1)), m02),
+                oy1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m10, px1), _mm256_mul_pd(m11, py1)), m12);
+        _mm256_storeu_pd(&out_x[i], ox0);
+        _mm256_storeu_pd(&out_y[i], oy0);
+        _mm256_storeu_pd(&out_x[i + 4], ox1);
+        _mm256_storeu_pd(&out_y[i + 4], oy1);
+    }
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        __m256d px = _mm256_loadu_pd(&x[i]),
+                py = _mm256_loadu_pd(&y[i]);
+        _mm256_storeu_pd(&out_x[i], _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m00, px), _mm256_mul_pd(m01, py)), m02));
+        _mm256_storeu_pd(&out_y[i], _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m10, px), _mm256_mul_pd(m11, py)), m12));
+    }
+    affine_kernel_scalar(a, x, y, out_x, out_y, i, n);
+}
+
+#endif
+
+/**
+ * @brief Returns the best level supported by CPU.
+ *
+ * @returns AFFINE_KERNEL_* level.
+*/
+static int affine_kernel_detect(void)
+{
+#ifdef AFFINE_KERNEL_X86
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports("avx2") ) return (AFFINE_KERNEL_AVX2);
+    if ( __builtin_cpu_supports("sse2") ) return (AFFINE_KERNEL_SSE2);
+#endif
+    return (AFFINE_KERNEL_SCALAR);
+}
+
+/**
+ * @brief Returns the level in use. Best one supported by CPU, unless another one was set.
+ *
+ * @returns AFFINE_KERNEL_* level.
+*/
+int affine_kernel_level(void)
+{
+    int l = atomic_load_explicit(&level, memory_order_relaxed);
+
+    if ( l < 0 )
+    {
+        l = affine_kernel_detect();
+        atomic_store_explicit(&level, l, memory_order_relaxed);
+    }
+
+    return (l);
+}
+
+/**
+ * @brief Sets the level in use (e.g. to compare levels). If CPU does not support it, best supported one below it is used.
+ *
+ * @param l AFFINE_KERNEL_* level.
+ *
+ * @returns Level actually set.
+*/
+int affine_kernel_set_level(int l)
+{
+    /* Sanity Check. */
+    assert( l >= AFFINE_KERNEL_SCALAR && l <= AFFINE_KERNEL_AVX2 );
+
+    int best = affine_kernel_detect();
+    if ( l > best ) l = best;
+    atomic_store_explicit(&level, l, memory_order_relaxed);
+
+    return (l);
+}
+
+/**
+ * @brief Returns the name of a level.
+ *
+ * @param l AFFINE_KERNEL_* level.
+ *
+ * @returns Level's name.
+*/
+const char *affine_kernel_name(int l)
+{
+    /* Sanity Check. */
+    assert( l >= AFFINE_KERNEL_SCALAR && l <= AFFINE_KERNEL_AVX2 );
+
+    return (names[l]);
+}
+
+/**
+ * @brief Applies a matrix to n points given as contiguous X and Y arrays. Output may be the input (in place).
+ *
+ * @param a     Given matrix.
+ * @param x     X coordinates.
+ * @param y     Y coordinates.
+ * @param out_x Output: transformed X coordinates.
+ * @param out_y Output: transformed Y coordinates.
+ * @param n     Number of points.
+*/
+void affine_kernel_apply(const struct affine *a,
+                         const double        *x,
+                         const double        *y,
+                         double              *out_x,
+                         double              *out_y,
+                         int                  n)
+{
+    /* Sanity Check. */
+    assert( a != NULL && n >= 0 );
+
+    switch ( affine_kernel_level() )
+    {
+#ifdef AFFINE_KERNEL_X86
+        case AFFINE_KERNEL_AVX2:
+            affine_kernel_avx2(a, x, y, out_x, out_y, n);
+            break;
+        case AFFINE_KERNEL_SSE2:
+            affine_kernel_sse2(a, x, y, out_x, out_y, n);
+            break;
+#endif
+        default:
+            affine_kernel_scalar(a, x, y, out_x, out_y, 0, n);
+            break;
+    }
+}
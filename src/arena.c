@@ -0,0 +1,179 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdlib.h>
+
+
+#include "arena.h"
+
+#define ARENA_ALIGNMENT alignof(max_align_t) /** << Every allocation is aligned as malloc's. */
+
+/**
+ * @brief A block of memory handed out by bumping an offset.
+*/
+struct arena_chunk
+{
+    struct arena_chunk *next;   /** << Next chunk (kept between resets). */
+    size_t              size;   /** << Bytes that fit in data.            */
+    size_t              used;   /** << Bytes already handed out.          */
+    max_align_t         data[]; /** << Memory of chunk.                   */
+};
+
+struct arena
+{
+    struct arena_chunk *first;      /** << First chunk, where a reset arena starts.          */
+    struct arena_chunk *current;    /** << Chunk being bumped.                               */
+    size_t              chunk_size; /** << Size of new chunks (bigger if an allocation is). */
+};
+
+/**
+ * @brief Allocates a new, empty, chunk.
+ *
+ * @param size Bytes that must fit in it.
+ *
+ * @returns A chunk.
+*/
+static struct arena_chunk* arena_chunk_create(size_t size)
+{
+    struct arena_chunk *c = (struct arena_chunk*) malloc(sizeof(struct arena_chunk) + size);
+
+    assert( c != NULL );
+    c->next = NULL;
+    c->size = size;
+    c->used = 0;
+
+    return (c);
+}
+
+/**
+ * @brief Initializes the Arena structure. An arena hands out memory that is never freed one by one:
+ * all of it is given back at once by arena_reset (and kept to be reused) or arena_destroy.
+ *
+ * @param chunk_size Size (in bytes) of each chunk. If 0, ARENA_CHUNK_SIZE is used.
+ *
+ * @returns An arena.
+*/
+arena_tt arena_create(size_t chunk_size)
+{
+    struct arena *a = (struct arena*) malloc(sizeof(struct arena));
+
+    a->chunk_size = ( chunk_size > 0 ) ? chunk_size : ARENA_CHUNK_SIZE;
+    a->first = a->current = arena_chunk_create(a->chunk_size);
+
+    return (a);
+}
+
+/**
+ * @brief Destroys the Arena structure and all memory it handed out.
+ *
+ * @param a Given arena.
+*/
+void arena_destroy(struct arena *a)
+{
+    /* Sanity Check. */
+    assert( a != NULL );
+
+    struct arena_chunk *c = a->first;
+    while ( c != NULL )
+    {
+        struct arena_chunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    free(a);
+}
+
+/**
+ * @brief Allocates memory from an arena. It is valid until arena is reset or destroyed.
+ * When current chunk is full, the next one is reused (after a reset) or a new one is chained.
+ *
+ * @param a    Given arena.
+ * @param size Bytes to allocate.
+ *
+ * @returns Allocated memory (aligned as malloc's).
+*/
+void* arena_alloc(struct arena *a,
+                  size_t        size)
+{
+    /* Sanity Check. */
+    assert( a != NULL );
+
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    struct arena_chunk *c = a->current;
+    if ( c->used + size > c->size )
+    {
+        struct arena_chunk *next = c->next;
+
+        // A kept chunk that is too small is replaced, so chunks never pile up across resets.
+        if ( next == NULL || next->size < size )
+        {
+            struct arena_chunk *bigger = arena_chunk_create(( size > a->chunk_size ) ? size : a->chunk_size);
+            if ( next != NULL )
+            {
+                bigger->next = next->next;
+                free(next);
+            }
+            next = bigger;
+            c->next = next;
+        }
+
+        next->used = 0;
+        a->current = c = next;
+    }
+
+    void *p = (char*) c->data + c->used;
+    c->used += size;
+
+    return (p);
+}
+
+/**
+ * @brief Gives back all memory handed out by an arena, in O(1). Chunks are kept, so an arena that is
+ * filled and reset over and over stops allocating once it reaches its largest size.
+ *
+ * @param a Given arena.
+*/
+void arena_reset(struct arena *a)
+{
+    /* Sanity Check. */
+    assert( a != NULL );
+
+    a->current = a->first;
+    a->first->used = 0;
+}
+
+/**
+ * @brief Returns how many bytes an arena has handed out since its last reset.
+ *
+ * @param a Given arena.
+ *
+ * @returns Bytes in use (including alignment padding and unused tails of filled chunks).
+*/
+size_t arena_used(struct arena *a)
+{
+    /* Sanity Check. */
+    assert( a != NULL );
+
+    size_t used = 0;
+    for ( struct arena_chunk *c = a->first; c != a->current; c = c->next ) used += c->size;
+
+    return (used + a->current->used);
+}
+
+/**
+ * @brief Returns how many bytes an arena holds, used or not.
+ *
+ * @param a Given arena.
+ *
+ * @returns Bytes reserved by all chunks.
+*/
+size_t arena_reserved(struct arena *a)
+{
+    /* Sanity Check. */
+    assert( a != NULL );
+
+    size_t reserved = 0;
+    for ( struct arena_chunk *c = a->first; c != NULL; c = c->next ) reserved += c->size;
+
+    return (reserved);
+}
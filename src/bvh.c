@@ -0,0 +1,431 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+
+#include "bvh.h"
+
+#define BVH_NO_ENTRY -1 /** << Handle's index is not in the tree. */
+
+/**
+ * @brief An entry of the tree. Entries of a subtree are contiguous, so a whole subtree can be reported at once.
+*/
+struct bvh_entry
+{
+    handle_tt handle; /** << Entry's handle. */
+    double    box[4]; /** << Entry's box.    */
+};
+
+/**
+ * @brief A node of the tree: its box and its range of entries. Leaves have no children.
+*/
+struct bvh_node
+{
+    double box[4];                                /** << Union of entries' boxes.     */
+    int    begin;                                 /** << First entry of subtree.      */
+    int    end;                                   /** << One past last entry.         */
+    int    num_children;                          /** << 0 if node is a leaf.         */
+    int    children[BVH_SLICES * BVH_SLICES];     /** << Children, always after node. */
+};
+
+struct bvh
+{
+    VECTOR(struct bvh_entry) entries; /** << Entries, in tree's order once built.           */
+    VECTOR(struct bvh_node)  nodes;   /** << Nodes in pre-order, root is the first one.     */
+    VECTOR(int)              where;   /** << Position of each entry, by handle's index.     */
+    VECTOR(int)              stack;   /** << Nodes still to be visited by a query.          */
+    int                      built;   /** << If nodes match entries. 0 = No, 1 = Yes.       */
+};
+
+/**
+ * @brief Initializes the BVH structure.
+ *
+ * @param capacity Initial number of entries. Tree grows when needed.
+ *
+ * @returns An empty bvh.
+*/
+bvh_tt bvh_create(int capacity)
+{
+    struct bvh *t = (struct bvh*) malloc(sizeof(struct bvh));
+
+    vector_init(&t->entries);
+    vector_init(&t->nodes);
+    vector_init(&t->where);
+    vector_init(&t->stack);
+    vector_reserve(&t->entries, capacity);
+    t->built = 1;
+
+    return (t);
+}
+
+/**
+ * @brief Destroys the BVH structure.
+ *
+ * @param t Given bvh.
+*/
+void bvh_destroy(struct bvh *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    vector_free(&t->entries);
+    vector_free(&t->nodes);
+    vector_free(&t->where);
+    vector_free(&t->stack);
+    free(t);
+}
+
+/**
+ * @brief Removes all entries, keeping memory to be reused.
+ *
+ * @param t Given bvh.
+*/
+void bvh_clear(struct bvh *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    for ( int i = 0; i < t->entries.size; i++ ) t->where.data[HANDLE_INDEX(t->entries.data[i].handle)] = BVH_NO_ENTRY;
+    vector_clear(&t->entries);
+    vector_clear(&t->nodes);
+    t->built = 1;
+}
+
+/**
+ * @brief Returns the number of entries.
+ *
+ * @param t Given bvh.
+ *
+ * @returns Number of entries.
+*/
+int bvh_size(const struct bvh *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    return (t->entries.size);
+}
+
+/**
+ * @brief Returns if tree matches its entries, i.e. no entry was added since last bvh_build.
+ *
+ * @param t Given bvh.
+ *
+ * @returns If tree is built. 0 = No, 1 = Yes.
+*/
+int bvh_is_built(const struct bvh *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    return (t->built);
+}
+
+/**
+ * @brief Adds an entry. Tree must be built again (bvh_build) before it is queried.
+ *
+ * @param t   Given bvh.
+ * @param h   Entry's handle. Must not be in tree already.
+ * @param box Entry's box.
+*/
+void bvh_add(struct bvh   *t,
+             handle_tt     h,
+             const double *box)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+    assert( h != HANDLE_NONE );
+
+    int i = HANDLE_INDEX(h);
+    while ( t->where.size <= i ) vector_push(&t->where, BVH_NO_ENTRY);
+    assert( t->where.data[i] == BVH_NO_ENTRY );
+
+    struct bvh_entry e = { h, { box[0], box[1], box[2], box[3] } };
+    t->where.data[i] = t->entries.size;
+    vector_push(&t->entries, e);
+    t->built = 0;
+}
+
+/**
+ * @brief Returns the center of an entry's box along an axis (doubled, only used to order entries).
+ *
+ * @param e    Given entry.
+ * @param axis 0 = X, 1 = Y.
+ *
+ * @returns Doubled center.
+*/
+static double bvh_center(const struct bvh_entry *e,
+                         int                     axis)
+{
+    double c = e->box[axis] + e->box[axis + 2];
+
+    return isnan(c) ? 0.0 : c;
+}
+
+/**
+ * @brief Partially orders entries [begin, end) along an axis (quickselect), so the kth one is in its sorted place,
+ * entries before it are not greater and entries after it are not smaller. O(n) on average, cheaper than sorting.
+ *
+ * @param entries Given entries.
+ * @param begin   First entry.
+ * @param end     One past last entry.
+ * @param k       Position that must be in place, in [begin, end).
+ * @param axis    0 = X, 1 = Y.
+*/
+static void bvh_select(struct bvh_entry *entries,
+                       int               begin,
+                       int               end,
+                       int               k,
+                       int               axis)
+{
+    int lo = begin,
+        hi = end - 1;
+
+    while ( lo < hi )
+    {
+        double pivot = bvh_center(&entries[lo + (hi - lo) / 2], axis);
+        int i = lo,
+            j = hi;
+
+        while ( i <= j )
+        {
+            while ( bvh_center(&entries[i], axis) < pivot ) i++;
+            while ( bvh_center(&entries[j], axis) > pivot ) j--;
+            if ( i <= j )
+            {
+                struct bvh_entry tmp = entries[i];
+                entries[i++] = entries[j];
+                entries[j--] = tmp;
+            }
+        }
+
+        if ( k <= j ) hi = j;
+        else if ( k >= i ) lo = i;
+        else return;
+    }
+}
+
+/**
+ * @brief Builds the subtree of entries [begin, end) (Sort-Tile-Recursive): entries are ordered by X and cut in BVH_SLICES vertical slices,
+ * each slice is ordered by Y and cut in BVH_SLICES tiles, and each tile is a child, built the same way until it fits in a leaf.
+ * Only the cuts matter, so entries are partially ordered (bvh_select) instead of sorted.
+ *
+ * @param t     Given bvh.
+ * @param begin First entry.
+ * @param end   One past last entry.
+ *
+ * @returns Index of subtree's root.
+*/
+static int bvh_build_node(struct bvh *t,
+                          int         begin,
+                          int         end)
+{
+    struct bvh_node node = { { 0.0, 0.0, 0.0, 0.0 }, begin, end, 0, { 0 } };
+    int n = end - begin,
+        id = t->nodes.size;
+
+    vector_push(&t->nodes, node);
+    if ( n <= BVH_LEAF_SIZE ) return id;
+
+    struct bvh_entry *entries = t->entries.data;
+    int slice = (n + BVH_SLICES - 1) / BVH_SLICES;
+
+    for ( int s = begin; s < end; s += slice )
+    {
+        int s_end = ( s + slice < end ) ? s + slice : end,
+            tile = (s_end - s + BVH_SLICES - 1) / BVH_SLICES;
+
+        if ( s_end < end ) bvh_select(entries, s, end, s_end, 0);
+        for ( int c = s; c < s_end; c += tile )
+        {
+            int c_end = ( c + tile < s_end ) ? c + tile : s_end;
+            if ( c_end < s_end ) bvh_select(entries, c, s_end, c_end, 1);
+
+            // Children are pushed after node, so nodes' storage may move: node is always read back by its index
+            int child = bvh_build_node(t, c, c_end);
+            struct bvh_node *p = &t->nodes.data[id];
+            p->children[p->num_children++] = child;
+        }
+    }
+
+    return id;
+}
+
+/**
+ * @brief Builds the tree over all entries (Sort-Tile-Recursive bulk loading), then computes nodes' boxes. O(n log n) on average.
+ *
+ * @param t Given bvh.
+*/
+void bvh_build(struct bvh *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    vector_clear(&t->nodes);
+    if ( t->entries.size > 0 ) bvh_build_node(t, 0, t->entries.size);
+
+    for ( int i = 0; i < t->entries.size; i++ ) t->where.data[HANDLE_INDEX(t->entries.data[i].handle)] = i;
+    t->built = 1;
+    bvh_refit(t);
+}
+
+/**
+ * @brief Removes an entry: last entry takes its place. Tree must be built again (bvh_build) before it is queried.
+ *
+ * @param t Given bvh.
+ * @param h Entry's handle. If it is not in tree, nothing is done.
+*/
+void bvh_remove(struct bvh *t,
+                handle_tt   h)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    int i = HANDLE_INDEX(h);
+    if ( h == HANDLE_NONE || i >= t->where.size || t->where.data[i] == BVH_NO_ENTRY ) return;
+
+    int at = t->where.data[i];
+    if ( t->entries.data[at].handle != h ) return;
+
+    t->entries.data[at] = t->entries.data[--t->entries.size];
+    if ( at < t->entries.size ) t->where.data[HANDLE_INDEX(t->entries.data[at].handle)] = at;
+    t->where.data[i] = BVH_NO_ENTRY;
+    t->built = 0;
+}
+
+/**
+ * @brief Changes an entry's box. Nodes' boxes are only fixed by bvh_refit, so many entries can be changed before it.
+ *
+ * @param t   Given bvh.
+ * @param h   Entry's handle. If it is not in tree, nothing is done.
+ * @param box New box.
+*/
+void bvh_update(struct bvh   *t,
+                handle_tt     h,
+                const double *box)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    int i = HANDLE_INDEX(h);
+    if ( h == HANDLE_NONE || i >= t->where.size || t->where.data[i] == BVH_NO_ENTRY ) return;
+
+    struct bvh_entry *e = &t->entries.data[t->where.data[i]];
+    if ( e->handle != h ) return;
+    for ( int k = 0; k < 4; k++ ) e->box[k] = box[k];
+}
+
+/**
+ * @brief Recomputes every node's box from its entries, keeping tree's shape. O(n), since children always come after their parent.
+ * Cheap compared to bvh_build, but tree gets looser as entries move away from each other.
+ *
+ * @param t Given bvh.
+*/
+void bvh_refit(struct bvh *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+    assert( t->built );
+
+    for ( int i = t->nodes.size - 1; i >= 0; i-- )
+    {
+        struct bvh_node *node = &t->nodes.data[i];
+
+        node->box[0] = node->box[1] = INFINITY;
+        node->box[2] = node->box[3] = -INFINITY;
+        for ( int k = 0; k < ( node->num_children ? node->num_children : node->end - node->begin ); k++ )
+        {
+            const double *box = node->num_children ? t->nodes.data[node->children[k]].box : t->entries.data[node->begin + k].box;
+            if ( box[0] < node->box[0] ) node->box[0] = box[0];
+            if ( box[1] < node->box[1] ) node->box[1] = box[1];
+            if ( box[2] > node->box[2] ) node->box[2] = box[2];
+            if ( box[3] > node->box[3] ) node->box[3] = box[3];
+        }
+    }
+}
+
+/**
+ * @brief Checks if a box is inside a rectangle (borders included). Empty boxes are never inside.
+ *
+ * @param box  Given box.
+ * @param rect Given rectangle.
+ *
+ * @returns If box is inside. 0 = No, 1 = Yes.
+*/
+static int bvh_inside(const double *box,
+                      const double *rect)
+{
+    return ( box[0] <= box[2] && box[1] <= box[3] &&
+             box[0] >= rect[0] && box[2] <= rect[2] && box[1] >= rect[1] && box[3] <= rect[3] );
+}
+
+/**
+ * @brief Checks if a box overlaps a rectangle grown by a margin (borders included).
+ *
+ * @param box    Given box.
+ * @param rect   Given rectangle.
+ * @param margin Margin added to every side of rectangle.
+ *
+ * @returns If they overlap. 0 = No, 1 = Yes.
+*/
+static int bvh_overlaps(const double *box,
+                        const double *rect,
+                        double        margin)
+{
+    return ( box[0] <= rect[2] + margin && box[2] >= rect[0] - margin && box[1] <= rect[3] + margin && box[3] >= rect[1] - margin );
+}
+
+/**
+ * @brief Splits entries against a rectangle. Subtrees outside it are rejected without visiting them, and subtrees inside it are accepted
+ * at once (their entries are contiguous), so only subtrees crossing rectangle's border are visited down to their entries.
+ *
+ * @param t        Given bvh. Must be built.
+ * @param rect     Given rectangle (a box).
+ * @param margin   Entries not inside rectangle, but overlapping it grown by margin, are reported as crossing.
+ * @param inside   Where handles of entries inside rectangle are appended.
+ * @param crossing Where handles of other entries overlapping rectangle (plus margin) are appended.
+ *
+ * @returns Number of handles appended (to both lists).
+*/
+int bvh_query(struct bvh     *t,
+              const double   *rect,
+              double          margin,
+              handle_list_tt *inside,
+              handle_list_tt *crossing)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+    assert( t->built );
+    assert( inside != NULL && crossing != NULL );
+
+    int before = inside->size + crossing->size;
+
+    vector_clear(&t->stack);
+    if ( t->nodes.size > 0 ) vector_push(&t->stack, 0);
+    while ( t->stack.size > 0 )
+    {
+        const struct bvh_node *node = &t->nodes.data[t->stack.data[--t->stack.size]];
+
+        if ( !bvh_overlaps(node->box, rect, margin) ) continue;
+        if ( bvh_inside(node->box, rect) )
+        {
+            vector_reserve(inside, inside->size + node->end - node->begin);
+            for ( int i = node->begin; i < node->end; i++ ) inside->data[inside->size++] = t->entries.data[i].handle;
+        }
+        else if ( node->num_children == 0 )
+        {
+            for ( int i = node->begin; i < node->end; i++ )
+            {
+                const struct bvh_entry *e = &t->entries.data[i];
+                if ( bvh_inside(e->box, rect) ) vector_push(inside, e->handle);
+                else if ( bvh_overlaps(e->box, rect, margin) ) vector_push(crossing, e->handle);
+            }
+        }
+        else
+        {
+            for ( int k = node->num_children - 1; k >= 0; k-- ) vector_push(&t->stack, node->children[k]);
+        }
+    }
+
+    return (inside->size + crossing->size - before);
+}
@@ -2,42 +2,44 @@
 #include <stdlib.h>
 #include <math.h>
 
+#include "affine.h"
+#include "arena.h"
 #include "circumference.h"
+#include "memstat.h"
 
 struct circumference
 {
-    int c_id;        /** << Circumference identifier.     */
+    point_tt points[2];   /** << Circumference's center and border points. */
 
-    point_tt center; /** << Circumference's center point. */
-    point_tt border; /** << Circumference's border point. */
-};
-
-/**
- * @brief Next available circumference identification number.
-*/
-static int next_c_id = 0;
+    struct affine matrix; /** << Points' coordinates to world: every transformation applied so far. */
 
+    double   box[4];      /** << Cached world box of the whole circumference.       */
+    unsigned box_epoch;   /** << Points' epoch when box was computed (0 = invalid). */
+};
 
 /**
  * @brief Initializes the Line structure.
  * 
+ * @param arena  Arena that holds the circumference.
  * @param center Center point of a line.
  * @param border Border point of a line.
  *
  * @returns A Circumference.
 */
-circumference_tt circumference_create(struct point *center, struct point *border)
+circumference_tt circumference_create(arena_tt arena, point_tt center, point_tt border)
 {
-    struct circumference *c = (struct circumference*) malloc(sizeof(struct circumference));
-    c->c_id = next_c_id++;
-    c->center = center;
-    c->border = border;
+    struct circumference *c = (struct circumference*) arena_alloc(arena, sizeof(struct circumference));
+    memstat_alloc(MEMSTAT_CIRCUMFERENCES, sizeof(struct circumference));
+    c->points[0] = center;
+    c->points[1] = border;
+    affine_identity(&c->matrix);
+    c->box_epoch = 0;
 
     return (c);
 }
 
 /**
- * @brief Destroys the Circumference structure.
+ * @brief Destroys the Circumference structure and its points. Its memory is given back when its arena is reset.
  * 
  * @param c Given circumference.
 */
@@ -46,10 +48,8 @@ void circumference_destroy(struct circumference *c)
     /* Sanity Check. */
     assert( c != NULL );
     
-    point_destroy(c->center);
-    point_destroy(c->border);
-
-    free(c);
+    point_destroy(c->points[0]);
+    point_destroy(c->points[1]);
 }
 
 /**
@@ -57,21 +57,90 @@ void circumference_destroy(struct circumference *c)
  * 
  * @param c Desired Circumference.
  * 
- * @returns Circumference's points. Center = 1st index, Border = 2nd index.
+ * @returns Circumference's points (a view, nothing is allocated). Center = 1st index, Border = 2nd index.
+*/
+const point_tt* circumference_get_points(const struct circumference *c)
+{
+    /* Sanity Check. */
+    assert( c != NULL );
+
+    return (c->points);
+}
+
+/**
+ * @brief Returns Circumference's matrix: its points' coordinates are mapped through it to the world (where Circumference is drawn).
+ * 
+ * @param c Desired Circumference.
+ * 
+ * @returns Circumference's matrix.
 */
-point_tt* circumference_get_points(const struct circumference *c)
+const struct affine *circumference_get_matrix(const struct circumference *c)
 {
     /* Sanity Check. */
     assert( c != NULL );
-    struct point **points = (point_tt*) malloc(sizeof(point_tt) * 2);
-    points[0] = c->center;
-    points[1] = c->border;
 
-    return (points);
+    return (&c->matrix);
+}
+
+/**
+ * @brief Transforms a Circumference in O(1): given matrix is composed with Circumference's one, points are not moved.
+ * 
+ * @param c Given Circumference.
+ * @param a Transformation, applied after every previous one.
+*/
+void circumference_transform(struct circumference *c, const struct affine *a)
+{
+    /* Sanity Check. */
+    assert( c != NULL && a != NULL );
+
+    affine_multiply(&c->matrix, a, &c->matrix);
+    c->box_epoch = 0;
 }
 
 /**
- * @brief Returns Circumference's radius. Distance between border point and center point.
+ * @brief Maps a Circumference through a matrix: its center and its border point are mapped, radius is the distance between them.
+ * Through an Object's matrix to world (its own one composed with its group's world matrix), it is the Circumference drawn in canvas.
+ * 
+ * @param c Given Circumference.
+ * @param m Matrix (e.g. Circumference's own matrix).
+ * @param x Output: center's X coordinate.
+ * @param y Output: center's Y coordinate.
+ * 
+ * @returns Radius.
+*/
+double circumference_map(const struct circumference *c, const struct affine *m, double *x, double *y)
+{
+    /* Sanity Check. */
+    assert( c != NULL && m != NULL );
+
+    double bx = point_x_coord(c->points[1]),
+           by = point_y_coord(c->points[1]);
+    *x = point_x_coord(c->points[0]);
+    *y = point_y_coord(c->points[0]);
+    affine_apply(m, x, y);
+    affine_apply(m, &bx, &by);
+
+    return sqrt(pow(bx - *x, 2) + pow(by - *y, 2));
+}
+
+/**
+ * @brief Returns Circumference's center, through its own matrix (in its group's coordinates, which are world's if it is not in a group).
+ * 
+ * @param c Given Circumference.
+ * @param x Output: center's X coordinate.
+ * @param y Output: center's Y coordinate.
+*/
+void circumference_get_center(const struct circumference *c, double *x, double *y)
+{
+    /* Sanity Check. */
+    assert( c != NULL );
+
+    circumference_map(c, &c->matrix, x, y);
+}
+
+/**
+ * @brief Returns Circumference's radius. Distance between border point and center point, through its own matrix (in its group's coordinates,
+ * a group's transformation may scale it, see circumference_map).
  * 
  * @param c Given Circumference.
  * 
@@ -81,20 +150,31 @@ double circumference_radius(const struct circumference *c)
 {
     /* Sanity Check. */
     assert( c != NULL );
-    return sqrt(pow(point_x_coord(c->border) - point_x_coord(c->center), 2) + pow(point_y_coord(c->border) - point_y_coord(c->center), 2));
+
+    double x, y;
+    return circumference_map(c, &c->matrix, &x, &y);
 }
 
 /**
- * @brief Returns circumference's id.
+ * @brief Returns the world box of the whole Circumference (center +- radius). It is cached and only computed again when points were moved or Circumference was transformed since (see point_epoch).
  * 
- * @param c Given circumference.
- * 
- * @returns Returns circumference's id.
+ * @param c   Given Circumference.
+ * @param box Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
 */
-int circumference_id(const struct circumference *c)
+void circumference_get_box(struct circumference *c, double *box)
 {
     /* Sanity Check. */
     assert( c != NULL );
 
-    return (c->c_id);
-}
\ No newline at end of file
+    if ( c->box_epoch != point_epoch() )
+    {
+        double x, y,
+               r = circumference_map(c, &c->matrix, &x, &y);
+        c->box[0] = x - r;
+        c->box[1] = y - r;
+        c->box[2] = x + r;
+        c->box[3] = y + r;
+        c->box_epoch = point_epoch();
+    }
+    for ( int i = 0; i < 4; i++ ) box[i] = c->box[i];
+}
@@ -1,43 +1,38 @@
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 
 #include "clipping.h"
+#include "memstat.h"
 
 struct clip
 {
-    int desired_algh; /** << Desired algorithm to draw. */
-    int cl_id;        /** << Clip identifier.           */
+    int      desired_algh;            /** << Desired algorithm to draw. */
 
-    array_tt points;  /** << Clip's points.             */
+    point_tt points[NUM_CLIP_POINTS]; /** << Clip's points.             */
 };
 
-/**
- * @brief Next available clip identification number.
-*/
-static int next_cl_id = 0;
-
 /**
  * @brief Initializes the Clip structure.
  * 
+ * @param arena  Arena that holds the clip.
  * @param points Array that contains all points of given Clip.
  * @param size   Number of points.
  * @param Algh   Drawing algorithm desired. 
  * 
  * @returns A Clip structure.
 */
-clip_tt clip_create(struct point **points, int size, int algh)
+clip_tt clip_create(arena_tt arena, const point_tt *points, int size, int algh)
 {
-    struct clip *cl = (struct clip*) malloc(sizeof(struct clip));
+    struct clip *cl = (struct clip*) arena_alloc(arena, sizeof(struct clip));
+    memstat_alloc(MEMSTAT_CLIPS, sizeof(struct clip));
 
     assert( size == NUM_CLIP_POINTS );
 
     cl->desired_algh = algh;
-    cl->cl_id = next_cl_id++;
-    cl->points = array_create(NUM_CLIP_POINTS);
-
     for ( int i = 0; i < size; i++ )
     {
-        array_set(cl->points, i, points[i]);
+        cl->points[i] = points[i];
     }
 
     return cl;
@@ -48,9 +43,9 @@ clip_tt clip_create(struct point **points, int size, int algh)
  * 
  * @param cl Desired Clip.
  * 
- * @returns Clip's points.
+ * @returns Clip's points (NUM_CLIP_POINTS of them).
 */
-array_tt clip_get_points(const struct clip *cl)
+const point_tt* clip_get_points(const struct clip *cl)
 {
     /* Sanity Check. */
     assert( cl != NULL );
@@ -59,7 +54,7 @@ array_tt clip_get_points(const struct clip *cl)
 }
 
 /**
- * @brief Destroys the Clip structure.
+ * @brief Destroys the Clip structure and its points. Its memory is given back when its arena is reset.
  * 
  * @param cl Given clip.
 */
@@ -67,65 +62,317 @@ void clip_destroy(struct clip *cl)
 {
     /* Sanity Check. */
     assert( cl != NULL );
-    array_destroy(cl->points);
 
-    free(cl);
+    for ( int i = 0; i < NUM_CLIP_POINTS; i++ ) point_destroy(cl->points[i]);
 }
 
 /**
- * @brief Calculate and returns the xmin xmax ymin ymax of clip based on its points.
+ * @brief Calculates the xmin xmax ymin ymax of clip based on its points.
  * 
- * @param cl Given clip.
- * 
- * @returns The xmin xmax ymin ymax of clip based on its points. 1st idx = xmin, 2nd idx = xmax, 3rd idx = ymin, 4th idx = ymax.
+ * @param cl     Given clip.
+ * @param result Where the 4 values are written. 1st idx = xmin, 2nd idx = xmax, 3rd idx = ymin, 4th idx = ymax.
 */
-double* clip_get_maxmin(const struct clip *cl)
+void clip_get_maxmin(const struct clip *cl,
+                     double            *result)
 {
     /* Sanity Check. */
     assert( cl != NULL );
-    double *result = (double*) malloc(sizeof(double) * 4);
-    double x_first = point_x_coord(array_get(cl->points, 0)),
-           x_third = point_x_coord(array_get(cl->points, 2)),
-           y_first = point_y_coord(array_get(cl->points, 0)),
-           y_third = point_y_coord(array_get(cl->points, 2));
+    assert( result != NULL );
+    double x_first = point_x_coord(cl->points[0]),
+           x_third = point_x_coord(cl->points[2]),
+           y_first = point_y_coord(cl->points[0]),
+           y_third = point_y_coord(cl->points[2]);
 
     if ( x_first < x_third) 
     {
-        result[0] = point_x_coord(array_get(cl->points, 0));
-        result[1] = point_x_coord(array_get(cl->points, 2));
+        result[0] = point_x_coord(cl->points[0]);
+        result[1] = point_x_coord(cl->points[2]);
     }
     else
     { 
-        result[0] = point_x_coord(array_get(cl->points, 2));
-        result[1] = point_x_coord(array_get(cl->points, 0));
+        result[0] = point_x_coord(cl->points[2]);
+        result[1] = point_x_coord(cl->points[0]);
     }
 
     if ( y_first < y_third )        
     {
-        result[2] = point_y_coord(array_get(cl->points, 0));
-        result[3] = point_y_coord(array_get(cl->points, 2));
+        result[2] = point_y_coord(cl->points[0]);
+        result[3] = point_y_coord(cl->points[2]);
     }
     else
     { 
-        result[2] = point_y_coord(array_get(cl->points, 2));
-        result[3] = point_y_coord(array_get(cl->points, 0));
+        result[2] = point_y_coord(cl->points[2]);
+        result[3] = point_y_coord(cl->points[0]);
     }
-    
+}
+
+/**
+ * @brief Initializes a segment from two points' coordinates. Because of Float-precision, values are truncated, otherwise clipping would not work.
+ * 
+ * @param seg Given segment.
+ * @param x1  Initial X coordinate.
+ * @param y1  Initial Y coordinate.
+ * @param x2  Final X coordinate.
+ * @param y2  Final Y coordinate.
+*/
+void clip_segment_init(struct clip_segment *seg,
+                       double               x1,
+                       double               y1,
+                       double               x2,
+                       double               y2)
+{
+    /* Sanity Check. */
+    assert( seg != NULL );
+
+    seg->x1 = (int) x1;
+    seg->y1 = (int) y1;
+    seg->x2 = (int) x2;
+    seg->y2 = (int) y2;
+    seg->accepted = 0;
+}
+
+/**
+ * @brief Clips a segment with given algorithm.
+ * 
+ * @param algorithm CLIP_COHEN_SUTHERLAND or CLIP_LIANG_BARSKY.
+ * @param seg       Given segment.
+ * @param xmin      Clip's XMIN.
+ * @param xmax      Clip's XMAX.
+ * @param ymin      Clip's YMIN.
+ * @param ymax      Clip's YMAX.
+ * 
+ * @returns If segment is inside Clip. 0 = No, 1 = Yes.
+*/
+int clip_segment(int                  algorithm,
+                 struct clip_segment *seg,
+                 int                  xmin,
+                 int                  xmax,
+                 int                  ymin,
+                 int                  ymax)
+{
+    if ( algorithm == CLIP_LIANG_BARSKY ) return clip_liang_barsky(seg, xmin, xmax, ymin, ymax);
+
+    return clip_cohen_sutherland(seg, xmin, xmax, ymin, ymax);
+}
+
+/**
+ * @brief Checks where a given DELTA(x) and DELTA(y) are related to CLIP area.
+ * 
+ * @param p  DELTA(X)
+ * @param q  DELTA(Y)
+ * 
+ * @return 1 if segment may still be inside CLIP area. 0 otherwise
+*/
+static int clip_test(double  p,
+                     double  q,
+                     double *u1,
+                     double *u2)
+{
+    int result = 1;
+    double r = 0.0f;
+
+    // Inwards - outwards
+    if ( p < 0.0f )
+    {
+        r = q / p;
+        if ( r > *u2 ) result = 0;
+        else if ( r > *u1 ) *u1 = r;
+    } 
+    // Outwards - Inwards
+    else if ( p > 0.0f )
+    {
+        r = q / p;
+        if ( r < *u1 ) result = 0;
+        else if ( r < *u2 ) *u2 = r;
+    } 
+    else if ( q < 0 ) result = 0;
 
     return result;
 }
 
 /**
- * @brief Returns clip's id.
+ * @brief Uses Liang Barsky's algorithm to recalculate a segment inside a Clipped area. 
  * 
- * @param cl Given clip.
+ * @param seg  Given segment.
+ * @param xmin Clip's XMIN.
+ * @param xmax Clip's XMAX.
+ * @param ymin Clip's YMIN.
+ * @param ymax Clip's YMAX.
  * 
- * @returns Returns clip's id.
+ * @return If segment is inside Clip. 0 = No, 1 = Yes.
 */
-int clip_id(const struct clip *cl)
+int clip_liang_barsky(struct clip_segment *seg,
+                      int                  xmin,
+                      int                  xmax,
+                      int                  ymin,
+                      int                  ymax)
 {
     /* Sanity Check. */
-    assert( cl != NULL );
+    assert( seg != NULL );
+
+    int x1 = seg->x1,
+        x2 = seg->x2,
+        y1 = seg->y1, 
+        y2 = seg->y2;
+
+    double u1 = 0.0f,
+           u2 = 1.0f;
+    double dx = (double) x2 - x1,
+           dy = (double) y2 - y1;
+
+    seg->accepted = 0;
+    if ( clip_test(-dx, x1 - xmin, &u1, &u2) &&
+         clip_test(dx, xmax - x1, &u1, &u2) &&
+         clip_test(-dy, y1 - ymin, &u1, &u2) &&
+         clip_test(dy, ymax - y1, &u1, &u2) )
+    {
+        if ( floor(u2) < 1.0f )
+        {
+            x2 = (int) x1 + u2 * dx;
+            y2 = (int) y1 + u2 * dy;
+        }
+        if ( ceil(u1) > 0.0f )
+        {
+            x1 = (int) x1 + u1 * dx;
+            y1 = (int) y1 + u1 * dy;
+        }
+        seg->x1 = x1;
+        seg->y1 = y1;
+        seg->x2 = x2;
+        seg->y2 = y2;
+        seg->accepted = 1;
+    }
+
+    return (seg->accepted);
+}
 
-    return (cl->cl_id);
-}
\ No newline at end of file
+/**
+ * @brief Calculate the "Binary" code based in Point XY and where they are related to CLIP area, used in Cohen Sutherland's algorithm.
+ * 
+ * @param x    Point's X coordinate.
+ * @param y    Point's Y coordinate.
+ * @param xmin Clips's XMIN.
+ * @param xmax Clips's XMAX.
+ * @param ymin Clips's YMIN.
+ * @param ymax Clips's YMAX.
+ * 
+ * @returns Region code. Bit 0 = Left, Bit 1 = Right, Bit 2 = Down, Bit 3 = Up.
+*/
+static int region_code(int x, 
+                       int y,
+                       int xmin,
+                       int xmax,
+                       int ymin, 
+                       int ymax)
+{
+    int codigo = 0;
+
+    // Left - Bit 0
+    if ( x < xmin ) codigo += 1;
+    // Right - Bit 1
+    if ( x > xmax ) codigo += 2;
+    // Down - Bit 2
+    if ( y < ymin ) codigo += 4;
+    // Up - Bit 3
+    if ( y > ymax ) codigo += 8;
+
+    return codigo;
+}
+
+/**
+ * @brief Uses Cohen Sutherland's algorithm to recalculate a segment inside a Clipped area. 
+ * 
+ * @param seg  Given segment.
+ * @param xmin Clip's XMIN.
+ * @param xmax Clip's XMAX.
+ * @param ymin Clip's YMIN.
+ * @param ymax Clip's YMAX.
+ * 
+ * @return If segment is inside Clip. 0 = No, 1 = Yes.
+*/
+int clip_cohen_sutherland(struct clip_segment *seg,
+                          int                  xmin,
+                          int                  xmax,
+                          int                  ymin,
+                          int                  ymax)
+{
+    /* Sanity Check. */
+    assert( seg != NULL );
+
+    int x1 = seg->x1,
+        x2 = seg->x2,
+        y1 = seg->y1, 
+        y2 = seg->y2;
+
+    int c1 = 0,
+        c2 = 0,
+        cfora = 0;
+    int xint = 0,
+        yint = 0;
+    int aceite = 0,
+        feito = 0;
+
+    while ( !feito )
+    {   
+        c1 = region_code(x1, y1, xmin, xmax, ymin, ymax);
+        c2 = region_code(x2, y2, xmin, xmax, ymin, ymax);
+        // Fully-in
+        if ( c1 == 0 && c2 == 0 )
+        {    
+            aceite = 1;
+            feito = 1;
+        } 
+        // Segment Fully-out
+        else if ( (c1 & c2) != 0 )
+        {
+            feito = 1;
+        } else 
+        {
+            if ( c1 != 0 ) cfora = c1;
+            else cfora = c2;
+
+            // Left Lim
+            if ( (cfora & 1) == 1 )
+            {
+                xint = xmin;
+                yint = (int) y1 + ( y2 - y1 ) * ( xmin - x1 ) / ( x2 - x1 );
+            }
+            // Right Lim
+            else if ( (cfora & 2) == 2 )
+            {
+                xint = xmax; 
+                yint = (int) y1 + ( y2 - y1 ) * ( xmax - x1 ) / ( x2 - x1 );
+            }
+            // Dowm Lim
+            else if ( (cfora & 4) == 4)
+            {
+                yint = ymin;
+                xint = (int) x1 + ( x2 - x1 ) * ( ymin - y1 ) / ( y2 - y1 );
+            }
+            // Up Lim.
+            else if ( (cfora & 8) == 8)
+            {
+                yint = ymax;
+                xint = (int) x1 + ( x2 - x1 ) * ( ymax - y1 ) / ( y2 - y1 );
+            }
+
+            if ( cfora == c1 )
+            {
+                x1 = round(xint);
+                y1 = round(yint);
+            } else
+            {
+                x2 = round(xint);
+                y2 = round(yint);
+            }
+        }
+    }
+
+    seg->x1 = x1;
+    seg->y1 = y1;
+    seg->x2 = x2;
+    seg->y2 = y2;
+    seg->accepted = aceite;
+
+    return (seg->accepted);
+}
@@ -1,64 +1,208 @@
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 #include "color.h"
+#include "memstat.h"
 
-struct color
+#define PALETTE_INITIAL_SIZE 16 /** << Initial number of colors that fit (palette grows when needed). */
+
+/**
+ * @brief Distinct colors, each one stored once and referred to by its 16 bits index.
+ * Index 0 is always COLOR_BLACK, so an uncolored entity is black.
+*/
+struct palette
 {
-    double red_value;   /** << Red value.   */
-    double green_value; /** << Green value. */
-    double blue_value;  /** << Blue value.  */
+    uint32_t *colors;    /** << Packed colors, by index.                                         */
+    int       size;      /** << Number of colors.                                                */
+    int       capacity;  /** << Number of colors that fit.                                       */
+    int      *slots;     /** << Open addressing table (2 * capacity slots): index + 1, 0 = empty. */
+    size_t    accounted; /** << Bytes reported to memstat.                                       */
 };
 
 /**
- * @brief Initializes the Color structure.
- * 
- * @param r Red value.
- * @param g Green value.
- * @param b Blue value.
- * 
- * @returns A color.
+ * @brief Packs a RGB color. Channels are in [0, 1] (as cairo's), out of range values are clamped.
+ *
+ * @param r RED.
+ * @param g GREEN.
+ * @param b BLUE.
+ *
+ * @returns Packed color (opaque).
+*/
+uint32_t color_pack(double r,
+                    double g,
+                    double b)
+{
+    double rgb[3] = { r, g, b };
+    uint32_t c[3];
+
+    for ( int i = 0; i < 3; i++ )
+    {
+        double v = ( rgb[i] < 0.0 ) ? 0.0 : ( rgb[i] > 1.0 ) ? 1.0 : rgb[i];
+        c[i] = (uint32_t) (v * 255.0 + 0.5);
+    }
+
+    return COLOR_RGBA(c[0], c[1], c[2], 255);
+}
+
+/**
+ * @brief Finds the slot of a color in palette's table.
+ *
+ * @param p Given palette.
+ * @param c Packed color.
+ *
+ * @returns Slot that holds c, or the empty slot where c should be.
 */
-color_tt color_create(double r, 
-                      double g, 
-                      double b)
+static int palette_slot(const struct palette *p,
+                        uint32_t              c)
 {
-    struct color *c = (struct color*) malloc(sizeof(struct color));
+    int mask = (2 * p->capacity) - 1,
+        s = (int) ((c * 2654435761u) >> 16) & mask;
 
-    c->red_value = r;
-    c->green_value = g;
-    c->blue_value = b;
+    while ( p->slots[s] != 0 && p->colors[p->slots[s] - 1] != c ) s = (s + 1) & mask;
 
-    return (c);
+    return (s);
 }
 
 /**
- * @brief Destroy given Color.
- * 
- * @param c Given color.
+ * @brief Reports to memstat how much colors and table take now.
+ *
+ * @param p Given palette.
 */
-void color_destroy(struct color *c)
+static void palette_account(struct palette *p)
+{
+    size_t bytes = sizeof(uint32_t) * p->capacity + sizeof(int) * 2 * p->capacity;
+
+    memstat_resize(MEMSTAT_COLORS, p->accounted, bytes);
+    p->accounted = bytes;
+}
+
+/**
+ * @brief Doubles palette's capacity, rebuilding its table.
+ *
+ * @param p Given palette.
+*/
+static void palette_grow(struct palette *p)
+{
+    p->capacity *= 2;
+    p->colors = (uint32_t*) realloc(p->colors, sizeof(uint32_t) * p->capacity);
+    p->slots = (int*) realloc(p->slots, sizeof(int) * 2 * p->capacity);
+    memset(p->slots, 0, sizeof(int) * 2 * p->capacity);
+
+    for ( int i = 0; i < p->size; i++ ) p->slots[palette_slot(p, p->colors[i])] = i + 1;
+    palette_account(p);
+}
+
+/**
+ * @brief Initializes the Palette structure, holding only COLOR_BLACK (index 0).
+ *
+ * @returns A palette.
+*/
+palette_tt palette_create(void)
+{
+    struct palette *p = (struct palette*) malloc(sizeof(struct palette));
+
+    p->size = 0;
+    p->capacity = PALETTE_INITIAL_SIZE;
+    p->colors = (uint32_t*) malloc(sizeof(uint32_t) * p->capacity);
+    p->slots = (int*) calloc(2 * p->capacity, sizeof(int));
+    p->accounted = 0;
+    palette_account(p);
+    palette_intern(p, COLOR_BLACK);
+
+    return (p);
+}
+
+/**
+ * @brief Destroys the Palette structure.
+ *
+ * @param p Given palette.
+*/
+void palette_destroy(struct palette *p)
+{
+    /* Sanity Check. */
+    assert( p != NULL );
+
+    memstat_resize(MEMSTAT_COLORS, p->accounted, 0);
+    free(p->colors);
+    free(p->slots);
+    free(p);
+}
+
+/**
+ * @brief Removes all colors but COLOR_BLACK (index 0). Memory is kept to be reused.
+ *
+ * @param p Given palette.
+*/
+void palette_clear(struct palette *p)
+{
+    /* Sanity Check. */
+    assert( p != NULL );
+
+    p->size = 0;
+    memset(p->slots, 0, sizeof(int) * 2 * p->capacity);
+    palette_intern(p, COLOR_BLACK);
+}
+
+/**
+ * @brief Returns the index of a color, adding it to the palette if it is not there yet (O(1) expected).
+ *
+ * @param p Given palette.
+ * @param c Packed color.
+ *
+ * @returns Index of color.
+*/
+uint16_t palette_intern(struct palette *p,
+                        uint32_t        c)
 {
     /* Sanity Check. */
-    assert( c != NULL );
-    free(c);
+    assert( p != NULL );
+
+    int s = palette_slot(p, c);
+    if ( p->slots[s] != 0 ) return (uint16_t) (p->slots[s] - 1);
+
+    assert( p->size < PALETTE_MAX_COLORS );
+    if ( p->size == p->capacity )
+    {
+        palette_grow(p);
+        s = palette_slot(p, c);
+    }
+    p->colors[p->size] = c;
+    p->slots[s] = ++p->size;
+
+    return (uint16_t) (p->size - 1);
 }
 
 /**
- * @brief Returns RGB values from current color
- * 
- * @param c Given color.
- * 
- * @returns Array that contains RBG values from color. 1st Position = Red, 2nd Position = Green, 3rd Position = Blue.
+ * @brief Returns a color of the palette.
+ *
+ * @param p   Given palette.
+ * @param idx Index of color.
+ *
+ * @returns Packed color.
 */
-double* color_get_colors(struct color *c)
+uint32_t palette_get(const struct palette *p,
+                     uint16_t              idx)
 {
-    double *rgb = (double*) malloc(sizeof(double) * 3);
+    /* Sanity Check. */
+    assert( p != NULL );
+    assert( idx < p->size );
 
-    rgb[0] = c->red_value;
-    rgb[1] = c->green_value;
-    rgb[2] = c->blue_value;
+    return (p->colors[idx]);
+}
+
+/**
+ * @brief Returns the number of colors in the palette.
+ *
+ * @param p Given palette.
+ *
+ * @returns Number of colors.
+*/
+int palette_size(const struct palette *p)
+{
+    /* Sanity Check. */
+    assert( p != NULL );
 
-    return rgb;
+    return (p->size);
 }
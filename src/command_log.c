@@ -0,0 +1,293 @@
+#include <assert.h>
+#include <stdlib.h>
+
+
+#include "command_log.h"
+#include "memstat.h"
+#include "vector.h"
+
+#define INITIAL_COMMANDS 64 /** << Commands reserved when a log is created. */
+
+/**
+ * @brief A command in log: its kind and its ranges in log's arrays.
+*/
+struct command_entry
+{
+    int type;          /** << COMMAND_*.                   */
+    int first_handle;  /** << First handle, in handles.   */
+    int num_handles;   /** << Number of handles.          */
+    int first_matrix;  /** << First matrix, in matrices.  */
+    int num_matrices;  /** << Number of matrices.         */
+};
+
+struct command_log
+{
+    VECTOR(struct command_entry) entries;   /** << Commands, oldest first.                                   */
+    handle_list_tt               handles;   /** << Handles of all commands, in commands' order.               */
+    VECTOR(struct affine)        matrices;  /** << Matrices of all commands, in commands' order.              */
+    int                          position;  /** << Commands before it are done, those after it are undone.    */
+    size_t                       accounted; /** << Bytes reported to memstat.                                */
+};
+
+/**
+ * @brief Reports to memstat how much log's arrays take now.
+ *
+ * @param l Given log.
+*/
+static void command_log_account(struct command_log *l)
+{
+    size_t bytes = sizeof(struct command_entry) * l->entries.capacity + sizeof(handle_tt) * l->handles.capacity +
+                   sizeof(struct affine) * l->matrices.capacity;
+
+    memstat_resize(MEMSTAT_COMMANDS, l->accounted, bytes);
+    l->accounted = bytes;
+}
+
+/**
+ * @brief Fills a command with an entry's data.
+ *
+ * @param l Given log.
+ * @param e Given entry.
+ * @param c Output: command (pointers into log's arrays).
+*/
+static void command_log_fill(const struct command_log   *l,
+                             const struct command_entry *e,
+                             struct command             *c)
+{
+    c->type = e->type;
+    c->handles = &l->handles.data[e->first_handle];
+    c->num_handles = e->num_handles;
+    c->matrices = &l->matrices.data[e->first_matrix];
+    c->num_matrices = e->num_matrices;
+}
+
+/**
+ * @brief Initializes the Command Log structure, with no commands.
+ *
+ * @returns A command log.
+*/
+command_log_tt command_log_create(void)
+{
+    struct command_log *l = (struct command_log*) malloc(sizeof(struct command_log));
+
+    vector_init(&l->entries);
+    vector_init(&l->handles);
+    vector_init(&l->matrices);
+    vector_reserve(&l->entries, INITIAL_COMMANDS);
+    l->position = 0;
+    l->accounted = 0;
+    command_log_account(l);
+
+    return (l);
+}
+
+/**
+ * @brief Destroys the Command Log structure.
+ *
+ * @param l Given log.
+*/
+void command_log_destroy(struct command_log *l)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    memstat_resize(MEMSTAT_COMMANDS, l->accounted, 0);
+    vector_free(&l->entries);
+    vector_free(&l->handles);
+    vector_free(&l->matrices);
+    free(l);
+}
+
+/**
+ * @brief Removes every command, keeping memory to be reused.
+ *
+ * @param l Given log.
+*/
+void command_log_clear(struct command_log *l)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    vector_clear(&l->entries);
+    vector_clear(&l->handles);
+    vector_clear(&l->matrices);
+    l->position = 0;
+}
+
+/**
+ * @brief Returns the number of commands (done and undone).
+ *
+ * @param l Given log.
+ *
+ * @returns Number of commands.
+*/
+int command_log_size(const struct command_log *l)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    return (l->entries.size);
+}
+
+/**
+ * @brief Returns the number of commands done: commands [0, position) can be undone, commands [position, size) can be redone.
+ *
+ * @param l Given log.
+ *
+ * @returns Position.
+*/
+int command_log_position(const struct command_log *l)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    return (l->position);
+}
+
+/**
+ * @brief Returns the ith command (e.g. to release what undone ones hold before they are dropped).
+ *
+ * @param l Given log.
+ * @param i Position, in [0, command_log_size).
+ * @param c Output: command. Valid until log changes.
+*/
+void command_log_get(const struct command_log *l,
+                     int                       i,
+                     struct command           *c)
+{
+    /* Sanity Check. */
+    assert( l != NULL && c != NULL );
+    assert( i >= 0 && i < l->entries.size );
+
+    command_log_fill(l, &l->entries.data[i], c);
+}
+
+/**
+ * @brief Returns how much memory log takes (its arrays' capacity).
+ *
+ * @param l Given log.
+ *
+ * @returns Bytes.
+*/
+size_t command_log_bytes(const struct command_log *l)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    return (l->accounted);
+}
+
+/**
+ * @brief Starts recording a command, with no handles nor matrices yet. Undone commands are dropped, they cannot be redone anymore.
+ *
+ * @param l    Given log.
+ * @param type COMMAND_*.
+*/
+void command_log_begin(struct command_log *l,
+                       int                 type)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    struct command_entry e = { type, 0, 0, 0, 0 };
+
+    l->entries.size = l->position;
+    if ( l->position > 0 )
+    {
+        const struct command_entry *last = &l->entries.data[l->position - 1];
+        e.first_handle = last->first_handle + last->num_handles;
+        e.first_matrix = last->first_matrix + last->num_matrices;
+    }
+    l->handles.size = e.first_handle;
+    l->matrices.size = e.first_matrix;
+
+    vector_push(&l->entries, e);
+    l->position = l->entries.size;
+    command_log_account(l);
+}
+
+/**
+ * @brief Adds handles to the command being recorded (see command_log_begin).
+ *
+ * @param l Given log.
+ * @param n Number of handles.
+ *
+ * @returns Where handles must be written. Valid until log changes.
+*/
+handle_tt *command_log_add_handles(struct command_log *l,
+                                   int                 n)
+{
+    /* Sanity Check. */
+    assert( l != NULL && n >= 0 );
+    assert( l->position > 0 && l->position == l->entries.size );
+
+    int first = l->handles.size;
+    vector_reserve(&l->handles, first + n);
+    l->handles.size += n;
+    l->entries.data[l->position - 1].num_handles += n;
+    command_log_account(l);
+
+    return &l->handles.data[first];
+}
+
+/**
+ * @brief Adds matrices to the command being recorded (see command_log_begin).
+ *
+ * @param l Given log.
+ * @param n Number of matrices.
+ *
+ * @returns Where matrices must be written. Valid until log changes.
+*/
+struct affine *command_log_add_matrices(struct command_log *l,
+                                        int                 n)
+{
+    /* Sanity Check. */
+    assert( l != NULL && n >= 0 );
+    assert( l->position > 0 && l->position == l->entries.size );
+
+    int first = l->matrices.size;
+    vector_reserve(&l->matrices, first + n);
+    l->matrices.size += n;
+    l->entries.data[l->position - 1].num_matrices += n;
+    command_log_account(l);
+
+    return &l->matrices.data[first];
+}
+
+/**
+ * @brief Steps back over the last command done, which can be redone afterwards. Nothing is reverted: caller does it with command's data.
+ *
+ * @param l Given log.
+ * @param c Output: command to be undone. Valid until log changes.
+ *
+ * @returns 1 if there was a command to undo, 0 otherwise.
+*/
+int command_log_undo(struct command_log *l,
+                     struct command     *c)
+{
+    /* Sanity Check. */
+    assert( l != NULL && c != NULL );
+
+    if ( l->position == 0 ) return (0);
+    command_log_fill(l, &l->entries.data[--l->position], c);
+    return (1);
+}
+
+/**
+ * @brief Steps forward over the last command undone. Nothing is applied: caller does it with command's data.
+ *
+ * @param l Given log.
+ * @param c Output: command to be redone. Valid until log changes.
+ *
+ * @returns 1 if there was a command to redo, 0 otherwise.
+*/
+int command_log_redo(struct command_log *l,
+                     struct command     *c)
+{
+    /* Sanity Check. */
+    assert( l != NULL && c != NULL );
+
+    if ( l->position == l->entries.size ) return (0);
+    command_log_fill(l, &l->entries.data[l->position++], c);
+    return (1);
+}
@@ -0,0 +1,303 @@
+#include <assert.h>
+#include <stdlib.h>
+
+
+#include "color.h"
+#include "display_list.h"
+
+#define DISPLAY_LIST_INITIAL_SIZE 64
+
+struct display_list
+{
+    int                center_x;  /** << Canvas' center X (in pixels), where X coordinate 0 is. */
+    int                center_y;  /** << Canvas' center Y (in pixels), where Y coordinate 0 is. */
+    int                size;      /** << Number of recorded operations.                       */
+    int                capacity;  /** << Number of operations that fit in ops.                */
+    struct display_op *ops;       /** << Recorded operations.                                 */
+    int                damaged;   /** << If only damage is rasterized again. 0 = No, 1 = Yes. */
+    double             damage[4]; /** << Area (xmin, ymin, xmax, ymax) rasterized again.      */
+};
+
+/**
+ * @brief Initializes the Display List structure. A display list is a snapshot of what must be drawn,
+ * so it can be rasterized away from the structures (Points, Lines...) that generated it.
+ *
+ * @param center_x Canvas' center X, in pixels.
+ * @param center_y Canvas' center Y, in pixels.
+ *
+ * @returns A display list.
+*/
+display_list_tt display_list_create(int center_x,
+                                    int center_y)
+{
+    struct display_list *dl = (struct display_list*) malloc(sizeof(struct display_list));
+    dl->center_x = center_x;
+    dl->center_y = center_y;
+    dl->size = 0;
+    dl->damaged = 0;
+    dl->capacity = DISPLAY_LIST_INITIAL_SIZE;
+    dl->ops = (struct display_op*) malloc(sizeof(struct display_op) * dl->capacity);
+
+    return (dl);
+}
+
+/**
+ * @brief Destroys the Display List structure.
+ *
+ * @param dl Given display list.
+*/
+void display_list_destroy(struct display_list *dl)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+
+    free(dl->ops);
+    free(dl);
+}
+
+/**
+ * @brief Removes all recorded operations. Memory is kept to be reused.
+ *
+ * @param dl Given display list.
+*/
+void display_list_clear(struct display_list *dl)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+
+    dl->size = 0;
+    dl->damaged = 0;
+}
+
+/**
+ * @brief Removes all recorded operations and sets a new canvas' center, so a display list can be recorded again
+ * without being reallocated. Memory is kept to be reused.
+ *
+ * @param dl       Given display list.
+ * @param center_x Canvas' center X, in pixels.
+ * @param center_y Canvas' center Y, in pixels.
+*/
+void display_list_reset(struct display_list *dl,
+                        int                  center_x,
+                        int                  center_y)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+
+    dl->size = 0;
+    dl->damaged = 0;
+    dl->center_x = center_x;
+    dl->center_y = center_y;
+}
+
+/**
+ * @brief Limits a display list to an area of canvas: only that area is rasterized again, the rest of canvas is kept as it was
+ * (see renderer.c). Operations must include everything that shows up in that area.
+ *
+ * @param dl  Given display list.
+ * @param box Area: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax (same coordinates used by Points).
+*/
+void display_list_set_damage(struct display_list *dl,
+                             const double        *box)
+{
+    /* Sanity Check. */
+    assert( dl != NULL && box != NULL );
+
+    dl->damaged = 1;
+    for ( int i = 0; i < 4; i++ ) dl->damage[i] = box[i];
+}
+
+/**
+ * @brief Returns the area a display list is limited to, if any.
+ *
+ * @param dl  Given display list.
+ * @param box Output: area (xmin, ymin, xmax, ymax). Untouched if display list covers whole canvas.
+ *
+ * @returns 1 if display list is limited to an area, 0 if it covers whole canvas.
+*/
+int display_list_get_damage(const struct display_list *dl,
+                            double                    *box)
+{
+    /* Sanity Check. */
+    assert( dl != NULL && box != NULL );
+
+    if ( !dl->damaged ) return (0);
+    for ( int i = 0; i < 4; i++ ) box[i] = dl->damage[i];
+    return (1);
+}
+
+/**
+ * @brief Returns the number of recorded operations.
+ *
+ * @param dl Given display list.
+ *
+ * @returns Number of recorded operations.
+*/
+int display_list_size(const struct display_list *dl)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+
+    return (dl->size);
+}
+
+/**
+ * @brief Returns canvas' center X used by this display list.
+ *
+ * @param dl Given display list.
+ *
+ * @returns Canvas' center X, in pixels.
+*/
+int display_list_center_x(const struct display_list *dl)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+
+    return (dl->center_x);
+}
+
+/**
+ * @brief Returns canvas' center Y used by this display list.
+ *
+ * @param dl Given display list.
+ *
+ * @returns Canvas' center Y, in pixels.
+*/
+int display_list_center_y(const struct display_list *dl)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+
+    return (dl->center_y);
+}
+
+/**
+ * @brief Returns the ith recorded operation.
+ *
+ * @param dl  Given display list.
+ * @param idx Index.
+ *
+ * @returns The ith recorded operation.
+*/
+const struct display_op *display_list_get(const struct display_list *dl,
+                                          int                        idx)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+    assert( (idx >= 0) && (idx < dl->size) );
+
+    return (&dl->ops[idx]);
+}
+
+/**
+ * @brief Reserves a new operation at the end of the display list, growing it if needed.
+ *
+ * @param dl   Given display list.
+ * @param type Type of operation.
+ * @param c    Color of operation (packed RGBA).
+ *
+ * @returns The new operation.
+*/
+static struct display_op *display_list_push(struct display_list *dl,
+                                            int                  type,
+                                            uint32_t             c)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+
+    if ( dl->size == dl->capacity )
+    {
+        dl->capacity *= 2;
+        dl->ops = (struct display_op*) realloc(dl->ops, sizeof(struct display_op) * dl->capacity);
+    }
+
+    struct display_op *op = &dl->ops[dl->size++];
+    op->type = type;
+    op->algh = 0;
+    op->x0 = op->y0 = op->x1 = op->y1 = 0.0;
+    op->color = c;
+
+    return (op);
+}
+
+/**
+ * @brief Records a brush (6x6 square) at given position.
+ *
+ * @param dl  Given display list.
+ * @param x   X coordinate.
+ * @param y   Y coordinate.
+ * @param c   Color of brush (packed RGBA).
+*/
+void display_list_add_brush(struct display_list *dl,
+                            double               x,
+                            double               y,
+                            uint32_t             c)
+{
+    struct display_op *op = display_list_push(dl, DISPLAY_BRUSH, c);
+    op->x0 = x;
+    op->y0 = y;
+}
+
+/**
+ * @brief Records a line between two positions.
+ *
+ * @param dl   Given display list.
+ * @param x0   Initial X coordinate.
+ * @param y0   Initial Y coordinate.
+ * @param x1   Final X coordinate.
+ * @param y1   Final Y coordinate.
+ * @param algh Drawing algorithm. 1 = DDA, 2 = Bresenham.
+ * @param c    Color of line (packed RGBA).
+*/
+void display_list_add_line(struct display_list *dl,
+                           double               x0,
+                           double               y0,
+                           double               x1,
+                           double               y1,
+                           int                  algh,
+                           uint32_t             c)
+{
+    struct display_op *op = display_list_push(dl, DISPLAY_LINE, c);
+    op->algh = algh;
+    op->x0 = x0;
+    op->y0 = y0;
+    op->x1 = x1;
+    op->y1 = y1;
+}
+
+/**
+ * @brief Records a circumference.
+ *
+ * @param dl     Given display list.
+ * @param x      Center X coordinate.
+ * @param y      Center Y coordinate.
+ * @param radius Circumference's radius.
+ * @param c      Color of circumference (packed RGBA).
+*/
+void display_list_add_circumference(struct display_list *dl,
+                                    double               x,
+                                    double               y,
+                                    double               radius,
+                                    uint32_t             c)
+{
+    struct display_op *op = display_list_push(dl, DISPLAY_CIRCUMFERENCE, c);
+    op->x0 = x;
+    op->y0 = y;
+    op->x1 = radius;
+}
+
+/**
+ * @brief Records the "(X, Y)" label of a point.
+ *
+ * @param dl Given display list.
+ * @param x  X coordinate of point.
+ * @param y  Y coordinate of point.
+*/
+void display_list_add_label(struct display_list *dl,
+                            double               x,
+                            double               y)
+{
+    struct display_op *op = display_list_push(dl, DISPLAY_LABEL, COLOR_BLACK);
+    op->x0 = x;
+    op->y0 = y;
+}
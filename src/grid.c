@@ -0,0 +1,445 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#include "grid.h"
+
+#define GRID_TABLE_MIN_SIZE 64        /** << Minimum number of entries of cells' hash table.          */
+#define GRID_MAX_COORD      (1 << 28) /** << Cells farther than this (in cells) are never created. */
+
+/**
+ * @brief A cell of the grid: handles of entries whose box touches it.
+*/
+struct grid_cell
+{
+    int            cx;    /** << Column of cell. */
+    int            cy;    /** << Row of cell.    */
+    handle_list_tt items; /** << Entries in it.  */
+};
+
+/**
+ * @brief An entry of the grid, kept by its handle's index.
+*/
+struct grid_item
+{
+    handle_tt handle;    /** << Entry's handle, HANDLE_NONE if index is not in the grid.      */
+    double    box[4];    /** << Entry's box.                                                  */
+    int       range[4];  /** << Cells covered: first column, first row, last column, last row. */
+    int       oversized; /** << If entry covers more than GRID_MAX_CELLS cells.               */
+    unsigned  stamp;     /** << Last query that reported it, so each query reports it once.   */
+};
+
+struct grid
+{
+    double                     cell_size; /** << Side of a cell, in world units.                             */
+    VECTOR(struct grid_cell)   cells;     /** << Cells in use.                                               */
+    int                        num_init;  /** << Cells (in use or not) whose items were initialized.         */
+    int                       *table;     /** << Hash table of cells (open addressing), cell's index + 1.    */
+    int                        mask;      /** << Table size - 1 (size is a power of 2).                      */
+    VECTOR(struct grid_item)   items;     /** << Entries, by handle's index.                                 */
+    handle_list_tt             oversized; /** << Entries covering too many cells, tested by every query.     */
+    unsigned                   stamp;     /** << Current query.                                              */
+    int                        count;     /** << Number of entries.                                          */
+};
+
+/**
+ * @brief Hash of a cell.
+ *
+ * @param cx Column.
+ * @param cy Row.
+ *
+ * @returns Hash.
+*/
+static unsigned grid_hash(int cx,
+                          int cy)
+{
+    return ((unsigned) cx * 73856093u) ^ ((unsigned) cy * 19349663u);
+}
+
+/**
+ * @brief Looks up a cell.
+ *
+ * @param g  Given grid.
+ * @param cx Column.
+ * @param cy Row.
+ *
+ * @returns Index of cell, -1 if it is not in use.
+*/
+static int grid_find(const struct grid *g,
+                     int                cx,
+                     int                cy)
+{
+    if ( g->table == NULL ) return -1;
+
+    for ( unsigned h = grid_hash(cx, cy) & g->mask; g->table[h] != 0; h = (h + 1) & g->mask )
+    {
+        const struct grid_cell *c = &g->cells.data[g->table[h] - 1];
+        if ( c->cx == cx && c->cy == cy ) return g->table[h] - 1;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Doubles the hash table (or creates it) and puts cells in use back in it.
+ *
+ * @param g Given grid.
+*/
+static void grid_rehash(struct grid *g)
+{
+    int size = ( g->table == NULL ) ? GRID_TABLE_MIN_SIZE : (g->mask + 1) * 2;
+
+    free(g->table);
+    g->table = (int*) calloc(size, sizeof(int));
+    g->mask = size - 1;
+    for ( int i = 0; i < g->cells.size; i++ )
+    {
+        unsigned h = grid_hash(g->cells.data[i].cx, g->cells.data[i].cy) & g->mask;
+        while ( g->table[h] != 0 ) h = (h + 1) & g->mask;
+        g->table[h] = i + 1;
+    }
+}
+
+/**
+ * @brief Looks up a cell, putting it in use if needed. Table is kept at most half full.
+ *
+ * @param g  Given grid.
+ * @param cx Column.
+ * @param cy Row.
+ *
+ * @returns The cell.
+*/
+static struct grid_cell *grid_cell(struct grid *g,
+                                   int          cx,
+                                   int          cy)
+{
+    int i = grid_find(g, cx, cy);
+    if ( i >= 0 ) return &g->cells.data[i];
+
+    if ( g->table == NULL || (g->cells.size + 1) * 2 > g->mask + 1 ) grid_rehash(g);
+
+    // Cells taken out of use by grid_clear keep their items' memory.
+    vector_reserve(&g->cells, g->cells.size + 1);
+    struct grid_cell *c = &g->cells.data[g->cells.size++];
+    if ( g->cells.size > g->num_init )
+    {
+        vector_init(&c->items);
+        g->num_init = g->cells.size;
+    }
+    c->cx = cx;
+    c->cy = cy;
+    vector_clear(&c->items);
+
+    unsigned h = grid_hash(cx, cy) & g->mask;
+    while ( g->table[h] != 0 ) h = (h + 1) & g->mask;
+    g->table[h] = g->cells.size;
+
+    return (c);
+}
+
+/**
+ * @brief Computes which cells a box covers.
+ *
+ * @param g     Given grid.
+ * @param box   Given box.
+ * @param range First column, first row, last column, last row.
+ * @param limit Maximum number of cells.
+ *
+ * @returns If box covers at most limit cells (and coordinates are finite). 0 = No, 1 = Yes.
+*/
+static int grid_range(const struct grid *g,
+                      const double      *box,
+                      int               *range,
+                      double             limit)
+{
+    double c[4];
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        c[i] = floor(box[i] / g->cell_size);
+        if ( !(fabs(c[i]) < GRID_MAX_COORD) ) return 0;
+    }
+    if ( (c[2] - c[0] + 1) * (c[3] - c[1] + 1) > limit ) return 0;
+    for ( int i = 0; i < 4; i++ ) range[i] = (int) c[i];
+
+    return 1;
+}
+
+/**
+ * @brief Removes a handle from a list (order is not kept).
+ *
+ * @param list Given list.
+ * @param h    Handle.
+*/
+static void grid_list_remove(handle_list_tt *list,
+                             handle_tt       h)
+{
+    for ( int i = 0; i < list->size; i++ )
+        if ( list->data[i] == h )
+        {
+            list->data[i] = list->data[--list->size];
+            return;
+        }
+}
+
+/**
+ * @brief Initializes the Grid structure: a uniform grid over the (unbounded) world. Only cells in use are kept, in a hash table,
+ * so memory depends on how many cells entries touch and not on the scene's extent.
+ *
+ * @param cell_size Side of a cell, in world units. If 0, GRID_CELL_SIZE is used.
+ *
+ * @returns A grid.
+*/
+grid_tt grid_create(double cell_size)
+{
+    /* Sanity Check. */
+    assert( cell_size >= 0.0 );
+
+    struct grid *g = (struct grid*) malloc(sizeof(struct grid));
+
+    g->cell_size = ( cell_size > 0.0 ) ? cell_size : GRID_CELL_SIZE;
+    vector_init(&g->cells);
+    g->num_init = 0;
+    g->table = NULL;
+    g->mask = 0;
+    vector_init(&g->items);
+    vector_init(&g->oversized);
+    g->stamp = 0;
+    g->count = 0;
+
+    return (g);
+}
+
+/**
+ * @brief Destroys the Grid structure.
+ *
+ * @param g Given grid.
+*/
+void grid_destroy(struct grid *g)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    for ( int i = 0; i < g->num_init; i++ ) vector_free(&g->cells.data[i].items);
+    vector_free(&g->cells);
+    free(g->table);
+    vector_free(&g->items);
+    vector_free(&g->oversized);
+    free(g);
+}
+
+/**
+ * @brief Removes all entries. Memory is kept to be reused.
+ *
+ * @param g Given grid.
+*/
+void grid_clear(struct grid *g)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    g->cells.size = 0;
+    if ( g->table ) memset(g->table, 0, sizeof(int) * (g->mask + 1));
+    for ( int i = 0; i < g->items.size; i++ ) g->items.data[i].handle = HANDLE_NONE;
+    vector_clear(&g->oversized);
+    g->count = 0;
+}
+
+/**
+ * @brief Returns the number of entries.
+ *
+ * @param g Given grid.
+ *
+ * @returns Number of entries.
+*/
+int grid_size(const struct grid *g)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    return (g->count);
+}
+
+/**
+ * @brief Adds an entry. Its handle is added to every cell its box touches.
+ *
+ * @param g   Given grid.
+ * @param h   Entry's handle, must not be in grid.
+ * @param box Entry's box.
+*/
+void grid_insert(struct grid     *g,
+                 handle_tt        h,
+                 const double    *box)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+    assert( h != HANDLE_NONE );
+
+    int idx = HANDLE_INDEX(h);
+    if ( idx >= g->items.size )
+    {
+        vector_reserve(&g->items, idx + 1);
+        while ( g->items.size <= idx ) g->items.data[g->items.size++].handle = HANDLE_NONE;
+    }
+
+    struct grid_item *item = &g->items.data[idx];
+    assert( item->handle == HANDLE_NONE );
+    item->handle = h;
+    item->stamp = g->stamp;
+    for ( int i = 0; i < 4; i++ ) item->box[i] = box[i];
+
+    item->oversized = !grid_range(g, box, item->range, GRID_MAX_CELLS);
+    if ( item->oversized ) vector_push(&g->oversized, h);
+    else
+    {
+        for ( int cy = item->range[1]; cy <= item->range[3]; cy++ )
+            for ( int cx = item->range[0]; cx <= item->range[2]; cx++ )
+                vector_push(&grid_cell(g, cx, cy)->items, h);
+    }
+    g->count++;
+}
+
+/**
+ * @brief Removes an entry.
+ *
+ * @param g Given grid.
+ * @param h Entry's handle, must be in grid.
+*/
+void grid_remove(struct grid *g,
+                 handle_tt    h)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+    assert( HANDLE_INDEX(h) < g->items.size && g->items.data[HANDLE_INDEX(h)].handle == h );
+
+    struct grid_item *item = &g->items.data[HANDLE_INDEX(h)];
+    if ( item->oversized ) grid_list_remove(&g->oversized, h);
+    else
+    {
+        for ( int cy = item->range[1]; cy <= item->range[3]; cy++ )
+            for ( int cx = item->range[0]; cx <= item->range[2]; cx++ )
+            {
+                int c = grid_find(g, cx, cy);
+                if ( c >= 0 ) grid_list_remove(&g->cells.data[c].items, h);
+            }
+    }
+    item->handle = HANDLE_NONE;
+    g->count--;
+}
+
+/**
+ * @brief Changes the box of an entry (e.g. after its object was transformed). Cells are only touched if the box moved to other cells.
+ *
+ * @param g   Given grid.
+ * @param h   Entry's handle, must be in grid.
+ * @param box Entry's new box.
+*/
+void grid_update(struct grid  *g,
+                 handle_tt     h,
+                 const double *box)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+    assert( HANDLE_INDEX(h) < g->items.size && g->items.data[HANDLE_INDEX(h)].handle == h );
+
+    struct grid_item *item = &g->items.data[HANDLE_INDEX(h)];
+    int range[4],
+        fits = grid_range(g, box, range, GRID_MAX_CELLS);
+
+    if ( fits ? ( !item->oversized && memcmp(range, item->range, sizeof(range)) == 0 ) : item->oversized )
+    {
+        for ( int i = 0; i < 4; i++ ) item->box[i] = box[i];
+        return;
+    }
+    grid_remove(g, h);
+    grid_insert(g, h, box);
+}
+
+/**
+ * @brief Checks if a box overlaps a rectangle (borders included).
+ *
+ * @param box  Given box.
+ * @param rect Given rectangle.
+ *
+ * @returns If they overlap. 0 = No, 1 = Yes.
+*/
+static int grid_overlaps(const double *box,
+                         const double *rect)
+{
+    return ( box[0] <= rect[2] && box[2] >= rect[0] && box[1] <= rect[3] && box[3] >= rect[1] );
+}
+
+/**
+ * @brief Reports entries of a cell that overlap a rectangle and were not reported yet by current query.
+ *
+ * @param g    Given grid.
+ * @param c    Index of cell.
+ * @param rect Given rectangle.
+ * @param out  Where handles are appended.
+*/
+static void grid_query_cell(struct grid    *g,
+                            int             c,
+                            const double   *rect,
+                            handle_list_tt *out)
+{
+    const handle_list_tt *items = &g->cells.data[c].items;
+
+    for ( int i = 0; i < items->size; i++ )
+    {
+        struct grid_item *item = &g->items.data[HANDLE_INDEX(items->data[i])];
+        if ( item->stamp == g->stamp ) continue;
+        item->stamp = g->stamp;
+        if ( grid_overlaps(item->box, rect) ) vector_push(out, item->handle);
+    }
+}
+
+/**
+ * @brief Reports each entry whose box overlaps a rectangle, once. Only cells the rectangle touches are visited (or, if it touches more
+ * cells than there are in use, cells in use), so cost depends on entries near the rectangle and not on all entries.
+ *
+ * @param g    Given grid.
+ * @param rect Given rectangle (a box).
+ * @param out  Where handles are appended.
+ *
+ * @returns Number of handles appended.
+*/
+int grid_query(struct grid    *g,
+               const double   *rect,
+               handle_list_tt *out)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+    assert( out != NULL );
+
+    int before = out->size,
+        range[4];
+
+    if ( ++g->stamp == 0 )
+    {
+        for ( int i = 0; i < g->items.size; i++ ) g->items.data[i].stamp = 0;
+        g->stamp = 1;
+    }
+
+    if ( grid_range(g, rect, range, g->cells.size) )
+    {
+        for ( int cy = range[1]; cy <= range[3]; cy++ )
+            for ( int cx = range[0]; cx <= range[2]; cx++ )
+            {
+                int c = grid_find(g, cx, cy);
+                if ( c >= 0 ) grid_query_cell(g, c, rect, out);
+            }
+    } else
+    {
+        for ( int c = 0; c < g->cells.size; c++ ) grid_query_cell(g, c, rect, out);
+    }
+
+    for ( int i = 0; i < g->oversized.size; i++ )
+    {
+        const struct grid_item *item = &g->items.data[HANDLE_INDEX(g->oversized.data[i])];
+        if ( grid_overlaps(item->box, rect) ) vector_push(out, item->handle);
+    }
+
+    return (out->size - before);
+}
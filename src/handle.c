@@ -0,0 +1,202 @@
+#include <assert.h>
+#include <stdlib.h>
+
+
+#include "handle.h"
+
+#define HANDLE_FREE_END -1 /** << End of free list. */
+
+/**
+ * @brief A slot of the table. While free, next_free links it to the next free slot.
+*/
+struct handle_slot
+{
+    void    *data;       /** << Referenced entity, NULL if slot is free.     */
+    int      kind;       /** << Kind of entity, defined by whoever allocates. */
+    int      next_free;  /** << Next free slot (HANDLE_FREE_END if last).     */
+    uint8_t  generation; /** << Bumped whenever slot is released.             */
+};
+
+struct handle_table
+{
+    VECTOR(struct handle_slot) slots;     /** << Every slot ever used (kept between clears). */
+    int                        free_head; /** << First free slot (HANDLE_FREE_END if none).  */
+    int                        live;      /** << Number of slots in use.                     */
+};
+
+/**
+ * @brief Initializes the Handle Table structure.
+ *
+ * @param capacity Initial number of slots. Table grows when needed.
+ *
+ * @returns A handle table.
+*/
+handle_table_tt handle_table_create(int capacity)
+{
+    struct handle_table *t = (struct handle_table*) malloc(sizeof(struct handle_table));
+
+    vector_init(&t->slots);
+    vector_reserve(&t->slots, capacity);
+    t->free_head = HANDLE_FREE_END;
+    t->live = 0;
+
+    return (t);
+}
+
+/**
+ * @brief Destroys the Handle Table structure. Referenced entities are not touched.
+ *
+ * @param t Given handle table.
+*/
+void handle_table_destroy(struct handle_table *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    vector_free(&t->slots);
+    free(t);
+}
+
+/**
+ * @brief Releases every slot at once, so every handle handed out so far goes stale. Free list is rebuilt in index order,
+ * so slots are reused from index 0 again.
+ *
+ * @param t Given handle table.
+*/
+void handle_table_clear(struct handle_table *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    t->free_head = HANDLE_FREE_END;
+    for ( int i = t->slots.size - 1; i >= 0; i-- )
+    {
+        struct handle_slot *s = &t->slots.data[i];
+        if ( s->data != NULL ) s->generation++;
+        s->data = NULL;
+        s->next_free = t->free_head;
+        t->free_head = i;
+    }
+    t->live = 0;
+}
+
+/**
+ * @brief Returns the number of slots in use.
+ *
+ * @param t Given handle table.
+ *
+ * @returns Number of valid handles.
+*/
+int handle_table_size(const struct handle_table *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    return (t->live);
+}
+
+/**
+ * @brief References an entity, reusing a released slot if there is one. O(1).
+ *
+ * @param t    Given handle table.
+ * @param kind Kind of entity.
+ * @param data Entity. Must not be NULL.
+ *
+ * @returns A handle to entity.
+*/
+handle_tt handle_alloc(struct handle_table *t,
+                       int                  kind,
+                       void                *data)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+    assert( data != NULL );
+
+    int i = t->free_head;
+    if ( i != HANDLE_FREE_END ) t->free_head = t->slots.data[i].next_free;
+    else
+    {
+        assert( t->slots.size < HANDLE_MAX_SLOTS );
+        struct handle_slot s = { NULL, 0, HANDLE_FREE_END, 0 };
+        vector_push(&t->slots, s);
+        i = t->slots.size - 1;
+    }
+
+    struct handle_slot *s = &t->slots.data[i];
+    s->data = data;
+    s->kind = kind;
+    s->next_free = HANDLE_FREE_END;
+    t->live++;
+
+    return HANDLE_MAKE(i, s->generation);
+}
+
+/**
+ * @brief Releases the slot of a handle, which goes stale. O(1).
+ *
+ * @param t Given handle table.
+ * @param h Valid handle.
+*/
+void handle_release(struct handle_table *t,
+                    handle_tt            h)
+{
+    /* Sanity Check. */
+    assert( handle_is_valid(t, h) );
+
+    int i = HANDLE_INDEX(h);
+    struct handle_slot *s = &t->slots.data[i];
+    s->data = NULL;
+    s->generation++;
+    s->next_free = t->free_head;
+    t->free_head = i;
+    t->live--;
+}
+
+/**
+ * @brief Checks if a handle still references an entity.
+ *
+ * @param t Given handle table.
+ * @param h Given handle.
+ *
+ * @returns If handle is valid. 0 = No (stale or HANDLE_NONE), 1 = Yes.
+*/
+int handle_is_valid(const struct handle_table *t,
+                    handle_tt                  h)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    int i = HANDLE_INDEX(h);
+    if ( h == HANDLE_NONE || i >= t->slots.size ) return 0;
+
+    const struct handle_slot *s = &t->slots.data[i];
+    return ( s->data != NULL && s->generation == HANDLE_GENERATION(h) ) ? 1 : 0;
+}
+
+/**
+ * @brief Returns the entity referenced by a handle. O(1).
+ *
+ * @param t Given handle table.
+ * @param h Given handle.
+ *
+ * @returns Entity, or NULL if handle is stale.
+*/
+void *handle_get(const struct handle_table *t,
+                 handle_tt                  h)
+{
+    return handle_is_valid(t, h) ? t->slots.data[HANDLE_INDEX(h)].data : NULL;
+}
+
+/**
+ * @brief Returns the kind of the entity referenced by a handle.
+ *
+ * @param t Given handle table.
+ * @param h Given handle.
+ *
+ * @returns Kind given to handle_alloc, or 0 if handle is stale.
+*/
+int handle_kind(const struct handle_table *t,
+                handle_tt                  h)
+{
+    return handle_is_valid(t, h) ? t->slots.data[HANDLE_INDEX(h)].kind : 0;
+}
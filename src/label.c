@@ -0,0 +1,283 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+
+#include "label.h"
+#include "vector.h"
+
+/**
+ * @brief Bounds of a placed label (x0, y0, x1, y1), in canvas pixels.
+*/
+struct label_box
+{
+    double box[4]; /** << Left, top, right and bottom of label. */
+};
+
+struct label_layout
+{
+    int  cols;                      /** << Number of columns of occupancy grid.                                  */
+    int  rows;                      /** << Number of rows of occupancy grid.                                     */
+    int  max_labels;                /** << Density cap, maximum number of labels placed per pass.                */
+    int  lod;                       /** << Highest label kind accepted in current pass (level of detail).        */
+    int  placed;                    /** << Number of labels placed in current pass.                              */
+    int  stamp;                     /** << Current pass. A cell is occupied if its stamp equals this.            */
+    int *cells;                     /** << Occupancy grid. Each cell holds the pass that last took it.           */
+    int  complete;                  /** << If a complete pass was laid out since creation (or a cap change).     */
+    int  limited;                   /** << If current pass is limited to area. 0 = No, 1 = Yes.                  */
+    double area[4];                 /** << Area of a limited pass (x0, y0, x1, y1), in canvas pixels.            */
+    VECTOR(struct label_box) boxes; /** << Placed labels, so a limited pass can remove the ones inside its area. */
+};
+
+/**
+ * @brief Finds cells of occupancy grid covered by a label, clamped to canvas.
+ *
+ * @param l     Given label layout.
+ * @param box   Label's bounds (x0, y0, x1, y1), in canvas pixels.
+ * @param cells Output: first column, first row, last column and last row.
+ *
+ * @returns If label is on canvas. 0 = No, 1 = Yes.
+*/
+static int label_layout_cells(const struct label_layout *l,
+                              const double              *box,
+                              int                       *cells)
+{
+    cells[0] = (int) floor(box[0] / LABEL_CELL_SIZE);
+    cells[1] = (int) floor(box[1] / LABEL_CELL_SIZE);
+    cells[2] = (int) floor(box[2] / LABEL_CELL_SIZE);
+    cells[3] = (int) floor(box[3] / LABEL_CELL_SIZE);
+
+    // Labels outside canvas are never seen.
+    if ( cells[2] < 0 || cells[3] < 0 || cells[0] >= l->cols || cells[1] >= l->rows ) return 0;
+    if ( cells[0] < 0 ) cells[0] = 0;
+    if ( cells[1] < 0 ) cells[1] = 0;
+    if ( cells[2] >= l->cols ) cells[2] = l->cols - 1;
+    if ( cells[3] >= l->rows ) cells[3] = l->rows - 1;
+
+    return 1;
+}
+
+/**
+ * @brief Chooses level of detail based on how many labels are going to be requested in a pass.
+ *
+ * @param l          Given label layout.
+ * @param candidates Number of labels that may be requested.
+ *
+ * @returns Highest label kind accepted.
+*/
+static int label_layout_lod(const struct label_layout *l,
+                            int                        candidates)
+{
+    if ( candidates <= l->max_labels ) return LABEL_CLIPPED;
+    if ( candidates <= l->max_labels * LABEL_LOD_FACTOR ) return LABEL_POINT;
+    return LABEL_VERTEX;
+}
+
+/**
+ * @brief Initializes the Label Layout structure. Canvas is split into cells of LABEL_CELL_SIZE pixels.
+ *
+ * @param width      Canvas width, in pixels.
+ * @param height     Canvas height, in pixels.
+ * @param max_labels Maximum number of labels placed per pass.
+ *
+ * @returns A label layout.
+*/
+label_layout_tt label_layout_create(int width,
+                                    int height,
+                                    int max_labels)
+{
+    /* Sanity Check. */
+    assert( width >= 0 && height >= 0 );
+    assert( max_labels >= 0 );
+
+    struct label_layout *l = (struct label_layout*) malloc(sizeof(struct label_layout));
+    l->cols = (width / LABEL_CELL_SIZE) + 1;
+    l->rows = (height / LABEL_CELL_SIZE) + 1;
+    l->max_labels = max_labels;
+    l->lod = LABEL_CLIPPED;
+    l->placed = 0;
+    l->stamp = 1;
+    l->cells = (int*) calloc(l->cols * l->rows, sizeof(int));
+    l->complete = 0;
+    l->limited = 0;
+    vector_init(&l->boxes);
+
+    return (l);
+}
+
+/**
+ * @brief Destroys the Label Layout structure.
+ *
+ * @param l Given label layout.
+*/
+void label_layout_destroy(struct label_layout *l)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    vector_free(&l->boxes);
+    free(l->cells);
+    free(l);
+}
+
+/**
+ * @brief Starts a new layout pass. Clearing the grid is O(1), since old stamps just stop matching.
+ * Level of detail is chosen based on how many labels are going to be requested in this pass.
+ *
+ * @param l          Given label layout.
+ * @param candidates Number of labels that may be requested in this pass.
+*/
+void label_layout_reset(struct label_layout *l,
+                        int                  candidates)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    l->placed = 0;
+    if ( ++l->stamp == 0 )
+    {
+        for ( int i = 0; i < l->cols * l->rows; i++ ) l->cells[i] = 0;
+        l->stamp = 1;
+    }
+
+    l->lod = label_layout_lod(l, candidates);
+    l->complete = 1;
+    l->limited = 0;
+    vector_clear(&l->boxes);
+}
+
+/**
+ * @brief Starts a layout pass limited to an area (e.g. damaged area of a redraw), keeping labels laid out outside it: labels inside area
+ * are removed (their cells cleared), new labels are only placed inside it, and labels crossing its border are kept, so requesting them
+ * again succeeds. Refused if level of detail would change or no complete pass (see label_layout_reset) was laid out yet, since labels
+ * outside area would not match a new layout: a complete pass is needed then.
+ *
+ * @param l          Given label layout.
+ * @param area       Area of pass (x0, y0, x1, y1), in canvas pixels.
+ * @param candidates Number of labels in whole canvas that may be requested.
+ *
+ * @returns If pass was started. 0 = No, 1 = Yes.
+*/
+int label_layout_damage(struct label_layout *l,
+                        const double        *area,
+                        int                  candidates)
+{
+    /* Sanity Check. */
+    assert( l != NULL && area != NULL );
+
+    if ( !l->complete || label_layout_lod(l, candidates) != l->lod ) return 0;
+
+    for ( int i = 0; i < l->boxes.size; )
+    {
+        const double *box = l->boxes.data[i].box;
+        int cells[4];
+
+        if ( box[0] < area[0] || box[1] < area[1] || box[2] > area[2] || box[3] > area[3] )
+        {
+            i++;
+            continue;
+        }
+
+        // Labels never share a cell, so cells of a removed label are free again
+        if ( label_layout_cells(l, box, cells) )
+            for ( int r = cells[1]; r <= cells[3]; r++ )
+                for ( int c = cells[0]; c <= cells[2]; c++ )
+                    l->cells[r * l->cols + c] = 0;
+
+        l->boxes.data[i] = l->boxes.data[--l->boxes.size];
+        l->placed--;
+    }
+
+    for ( int i = 0; i < 4; i++ ) l->area[i] = area[i];
+    l->limited = 1;
+
+    return 1;
+}
+
+/**
+ * @brief Tries to place a label. A label is placed only if its kind is visible at current level of detail,
+ * density cap was not reached and it does not collide with an already placed label. In a pass limited to an
+ * area (see label_layout_damage), a label must be inside area, unless it is a kept label crossing area's border.
+ *
+ * @param l    Given label layout.
+ * @param x    Left coordinate of label, in canvas pixels.
+ * @param y    Top coordinate of label, in canvas pixels.
+ * @param w    Width of label, in pixels.
+ * @param h    Height of label, in pixels.
+ * @param kind Kind of label (LABEL_VERTEX, LABEL_POINT or LABEL_CLIPPED).
+ *
+ * @returns If label was placed. 0 = No, 1 = Yes.
+*/
+int label_layout_place(struct label_layout *l,
+                       double               x,
+                       double               y,
+                       double               w,
+                       double               h,
+                       int                  kind)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    struct label_box label = { { x, y, x + w, y + h } };
+    int cells[4];
+
+    if ( l->limited && ( x < l->area[0] || y < l->area[1] || x + w > l->area[2] || y + h > l->area[3] ) )
+    {
+        // Labels crossing area's border are drawn again as they were laid out, any other one outside area is kept or refused
+        if ( x > l->area[2] || y > l->area[3] || x + w < l->area[0] || y + h < l->area[1] ) return 0;
+        for ( int i = 0; i < l->boxes.size; i++ )
+        {
+            const double *box = l->boxes.data[i].box;
+            if ( box[0] == label.box[0] && box[1] == label.box[1] && box[2] == label.box[2] && box[3] == label.box[3] ) return 1;
+        }
+        return 0;
+    }
+
+    if ( kind > l->lod || l->placed >= l->max_labels ) return 0;
+    if ( !label_layout_cells(l, label.box, cells) ) return 0;
+
+    for ( int r = cells[1]; r <= cells[3]; r++ )
+        for ( int c = cells[0]; c <= cells[2]; c++ )
+            if ( l->cells[r * l->cols + c] == l->stamp ) return 0;
+
+    for ( int r = cells[1]; r <= cells[3]; r++ )
+        for ( int c = cells[0]; c <= cells[2]; c++ )
+            l->cells[r * l->cols + c] = l->stamp;
+
+    vector_push(&l->boxes, label);
+    l->placed++;
+    return 1;
+}
+
+/**
+ * @brief Returns how many labels were placed in current pass (kept ones included, in a limited pass).
+ *
+ * @param l Given label layout.
+ *
+ * @returns Number of placed labels.
+*/
+int label_layout_count(const struct label_layout *l)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    return (l->placed);
+}
+
+/**
+ * @brief Sets the density cap (maximum number of labels placed per pass).
+ *
+ * @param l          Given label layout.
+ * @param max_labels New density cap.
+*/
+void label_layout_set_max(struct label_layout *l,
+                          int                  max_labels)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+    assert( max_labels >= 0 );
+
+    // Labels laid out under another cap need a complete pass
+    if ( max_labels != l->max_labels ) l->complete = 0;
+    l->max_labels = max_labels;
+}
@@ -1,52 +1,55 @@
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 
 
+#include "affine.h"
+#include "arena.h"
 #include "line.h"
+#include "memstat.h"
 
 struct line
 {
-    int      desired_algh;    /** << Desired algorithm to draw. */
-    int      l_id;            /** << Line identifier.           */
-    int      was_clipped;     /** << If line was clipped.       */
+    int      desired_algh;      /** << Desired algorithm to draw.        */
+    int      was_clipped;       /** << If line was clipped.              */
 
-    point_tt initial;         /** << Initial point.             */
-    point_tt final;           /** << Final point.               */
+    point_tt points[2];         /** << Initial and final points.         */
+    point_tt clipped_points[2]; /** << Clipped initial and final points. */
 
-    point_tt clipped_initial; /** << clipped initial point.     */
-    point_tt clipped_final;   /** << clipped final point.       */
-};
+    struct affine matrix;       /** << Points' coordinates to world: every transformation applied so far. */
 
-/**
- * @brief Next available line identification number.
-*/
-static int next_l_id = 0;
+    double   box[4];            /** << Cached world box of initial and final points.       */
+    unsigned box_epoch;         /** << Points' epoch when box was computed (0 = invalid).  */
+};
 
 /**
  * @brief Initializes the Line structure.
  * 
+ * @param arena   Arena that holds the line.
  * @param initial Initial point of a line.
  * @param final   Final point of a line.
  * @param algh    Desired algorithm to draw given line.
  * 
  * @returns A line.
 */
-line_tt line_create(struct point *initial, struct point *final, int algh)
+line_tt line_create(arena_tt arena, point_tt initial, point_tt final, int algh)
 {
-    struct line *l = (struct line*) malloc(sizeof(struct line));
+    struct line *l = (struct line*) arena_alloc(arena, sizeof(struct line));
+    memstat_alloc(MEMSTAT_LINES, sizeof(struct line));
     l->desired_algh = algh;
     l->was_clipped = 0;
-    l->l_id = next_l_id++;
-    l->initial = initial;
-    l->final = final;
-    l->clipped_initial = NULL;
-    l->clipped_final = NULL;
+    l->points[0] = initial;
+    l->points[1] = final;
+    l->clipped_points[0] = POINT_NONE;
+    l->clipped_points[1] = POINT_NONE;
+    affine_identity(&l->matrix);
+    l->box_epoch = 0;
 
     return (l);
 }
 
 /**
- * @brief Destroys the Line structure.
+ * @brief Destroys the Line structure and its points. Its memory is given back when its arena is reset.
  * 
  * @param l Given line.
 */
@@ -54,34 +57,31 @@ void line_destroy(struct line *l)
 {
     /* Sanity Check. */
     assert( l != NULL );
-    if ( l->was_clipped )
+    if ( l->was_clipped == 1 )
     {
-        point_destroy(l->clipped_initial);
-        point_destroy(l->clipped_final);
+        point_destroy(l->clipped_points[0]);
+        point_destroy(l->clipped_points[1]);
     }
-    point_destroy(l->initial);
-    point_destroy(l->final);
-
-    free(l);
+    point_destroy(l->points[0]);
+    point_destroy(l->points[1]);
 }
 
 /**
- * @brief Adds new points to a line whenever it gets clipped. If points are NULL, it implies that line won't be clipped anymore.
+ * @brief Adds new points to a line whenever it gets clipped. If points are POINT_NONE, it implies that line won't be clipped anymore.
  * 
  * @param l       Given line.
  * @param initial Initial clipped point of a line.
  * @param final   Final clipped point of a line.
  * @param flag    Defines which type of clipping ocurred. 0 = None, 1 = Clipped, 2 = Clipped but not drawn
 */
-void line_add_clipped_points(struct line *l, struct point *c_i, struct point *c_f, int flag)
+void line_add_clipped_points(struct line *l, point_tt c_i, point_tt c_f, int flag)
 {
     /* Sanity Check. */
     assert( l != NULL );
 
     l->was_clipped = flag;
-    l->clipped_initial = c_i;
-    l->clipped_final = c_f;
-    
+    l->clipped_points[0] = c_i;
+    l->clipped_points[1] = c_f;
 }
 
 /**
@@ -89,17 +89,14 @@ void line_add_clipped_points(struct line *l, struct point *c_i, struct point *c_
  * 
  * @param l Desired Line.
  * 
- * @returns Line's original points. Initial = 1st index, Final = 2nd index.
+ * @returns Line's original points (a view, nothing is allocated). Initial = 1st index, Final = 2nd index.
 */
-point_tt* line_get_points(const struct line *l)
+const point_tt* line_get_points(const struct line *l)
 {
     /* Sanity Check. */
     assert( l != NULL );
-    struct point **points = (point_tt*) malloc(sizeof(point_tt) * 2);
-    points[0] = l->initial;
-    points[1] = l->final;
 
-    return (points);
+    return (l->points);
 }
 
 /**
@@ -107,60 +104,101 @@ point_tt* line_get_points(const struct line *l)
  * 
  * @param l Desired Line.
  * 
- * @returns Line's clipped points. Initial = 1st index, Final = 2nd index.
+ * @returns Line's clipped points (a view, nothing is allocated). Initial = 1st index, Final = 2nd index.
 */
-point_tt* line_get_clipped_points(const struct line *l)
+const point_tt* line_get_clipped_points(const struct line *l)
 {
     /* Sanity Check. */
     assert( l != NULL );
-    struct point **points = (point_tt*) malloc(sizeof(point_tt) * 2);
-    points[0] = l->clipped_initial;
-    points[1] = l->clipped_final;
 
-    return (points);
+    return (l->clipped_points);
 }
 
 /**
- * @brief Returns Line's drawing algh.
+ * @brief Returns Line's matrix: its points' coordinates are mapped through it to the world (where Line is drawn and clipped).
  * 
  * @param l Desired Line.
  * 
- * @returns Line's drawing algh. 1 = DDA, 2 = Bresenham.
+ * @returns Line's matrix.
 */
-int line_get_algh(const struct line *l)
+const struct affine *line_get_matrix(const struct line *l)
 {
     /* Sanity Check. */
     assert( l != NULL );
 
-    return (l->desired_algh);
+    return (&l->matrix);
 }
 
 /**
- * @brief Checks if line was clipped.
+ * @brief Transforms a Line in O(1): given matrix is composed with Line's one, points are not moved.
+ * 
+ * @param l Given Line.
+ * @param a Transformation, applied after every previous one.
+*/
+void line_transform(struct line *l, const struct affine *a)
+{
+    /* Sanity Check. */
+    assert( l != NULL && a != NULL );
+
+    affine_multiply(&l->matrix, a, &l->matrix);
+    l->box_epoch = 0;
+}
+
+/**
+ * @brief Returns the world box of Line's original points. It is cached and only computed again when points were moved or Line was transformed since (see point_epoch).
+ * 
+ * @param l   Desired Line.
+ * @param box Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+*/
+void line_get_box(struct line *l, double *box)
+{
+    /* Sanity Check. */
+    assert( l != NULL );
+
+    if ( l->box_epoch != point_epoch() )
+    {
+        double x[2], y[2];
+        for ( int i = 0; i < 2; i++ )
+        {
+            x[i] = point_x_coord(l->points[i]);
+            y[i] = point_y_coord(l->points[i]);
+            affine_apply(&l->matrix, &x[i], &y[i]);
+        }
+        l->box[0] = fmin(x[0], x[1]);
+        l->box[1] = fmin(y[0], y[1]);
+        l->box[2] = fmax(x[0], x[1]);
+        l->box[3] = fmax(y[0], y[1]);
+        l->box_epoch = point_epoch();
+    }
+    for ( int i = 0; i < 4; i++ ) box[i] = l->box[i];
+}
+
+/**
+ * @brief Returns Line's drawing algh.
  * 
  * @param l Desired Line.
  * 
- * @returns If line was clipped.
+ * @returns Line's drawing algh. 1 = DDA, 2 = Bresenham.
 */
-int line_was_clipped(const struct line *l)
+int line_get_algh(const struct line *l)
 {
     /* Sanity Check. */
     assert( l != NULL );
 
-    return (l->was_clipped);
+    return (l->desired_algh);
 }
 
 /**
- * @brief Returns line's id.
+ * @brief Checks if line was clipped.
  * 
- * @param l Given line.
+ * @param l Desired Line.
  * 
- * @returns Returns line's id.
+ * @returns If line was clipped.
 */
-int line_id(const struct line *l)
+int line_was_clipped(const struct line *l)
 {
     /* Sanity Check. */
     assert( l != NULL );
 
-    return (l->l_id);
-}
\ No newline at end of file
+    return (l->was_clipped);
+}
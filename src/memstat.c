@@ -0,0 +1,190 @@
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#include "memstat.h"
+
+/**
+ * @brief Counters of a module. Updated with relaxed atomics: each counter is exact, but a snapshot is not taken atomically as a whole.
+*/
+struct memstat_module
+{
+    atomic_llong live_bytes;   /** << Bytes in use.                   */
+    atomic_llong peak_bytes;   /** << Most bytes ever in use at once. */
+    atomic_llong live_allocs;  /** << Allocations in use.             */
+    atomic_llong total_allocs; /** << Allocations ever made.          */
+};
+
+/**
+ * @brief Counters of every module.
+*/
+static struct memstat_module modules[MEMSTAT_NUM_MODULES];
+
+/**
+ * @brief Names of modules, by MEMSTAT_* module.
+*/
+static const char *names[MEMSTAT_NUM_MODULES] = { "points", "colors", "lines", "polygons", "circumferences", "clips", "temporary", "commands" };
+
+/**
+ * @brief Adds bytes to a module, raising its peak if needed.
+ *
+ * @param m     Given module.
+ * @param bytes Bytes added (negative if removed).
+*/
+static void memstat_add(struct memstat_module *m,
+                        long long              bytes)
+{
+    long long live = atomic_fetch_add_explicit(&m->live_bytes, bytes, memory_order_relaxed) + bytes,
+              peak = atomic_load_explicit(&m->peak_bytes, memory_order_relaxed);
+
+    while ( live > peak && !atomic_compare_exchange_weak_explicit(&m->peak_bytes, &peak, live, memory_order_relaxed, memory_order_relaxed) );
+}
+
+/**
+ * @brief Accounts a new allocation of a module.
+ *
+ * @param module MEMSTAT_* module.
+ * @param bytes  Size of allocation.
+*/
+void memstat_alloc(int    module,
+                   size_t bytes)
+{
+    /* Sanity Check. */
+    assert( module >= 0 && module < MEMSTAT_NUM_MODULES );
+
+    struct memstat_module *m = &modules[module];
+    atomic_fetch_add_explicit(&m->live_allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&m->total_allocs, 1, memory_order_relaxed);
+    memstat_add(m, (long long) bytes);
+}
+
+/**
+ * @brief Accounts that an allocation of a module was freed.
+ *
+ * @param module MEMSTAT_* module.
+ * @param bytes  Size of allocation (as given to memstat_alloc).
+*/
+void memstat_release(int    module,
+                     size_t bytes)
+{
+    /* Sanity Check. */
+    assert( module >= 0 && module < MEMSTAT_NUM_MODULES );
+
+    struct memstat_module *m = &modules[module];
+    atomic_fetch_sub_explicit(&m->live_allocs, 1, memory_order_relaxed);
+    memstat_add(m, -(long long) bytes);
+}
+
+/**
+ * @brief Accounts that an allocation of a module changed its size (e.g. a growing array). Size 0 means no allocation,
+ * so going from 0 is an allocation and going to 0 is a release.
+ *
+ * @param module MEMSTAT_* module.
+ * @param before Previous size.
+ * @param after  New size.
+*/
+void memstat_resize(int    module,
+                    size_t before,
+                    size_t after)
+{
+    /* Sanity Check. */
+    assert( module >= 0 && module < MEMSTAT_NUM_MODULES );
+
+    if ( before == 0 && after != 0 ) memstat_alloc(module, after);
+    else if ( before != 0 && after == 0 ) memstat_release(module, before);
+    else if ( before != after ) memstat_add(&modules[module], (long long) after - (long long) before);
+}
+
+/**
+ * @brief Accounts that all allocations of a module were freed at once (e.g. its arena was reset). Peak and total are kept.
+ *
+ * @param module MEMSTAT_* module.
+*/
+void memstat_release_all(int module)
+{
+    /* Sanity Check. */
+    assert( module >= 0 && module < MEMSTAT_NUM_MODULES );
+
+    atomic_store_explicit(&modules[module].live_bytes, 0, memory_order_relaxed);
+    atomic_store_explicit(&modules[module].live_allocs, 0, memory_order_relaxed);
+}
+
+/**
+ * @brief Copies current counters of every module.
+ *
+ * @param snapshot Output.
+*/
+void memstat_snapshot(struct memstat_snapshot *snapshot)
+{
+    /* Sanity Check. */
+    assert( snapshot != NULL );
+
+    memset(&snapshot->total, 0, sizeof(struct memstat_counters));
+    for ( int i = 0; i < MEMSTAT_NUM_MODULES; i++ )
+    {
+        struct memstat_counters *c = &snapshot->modules[i];
+        c->live_bytes = atomic_load_explicit(&modules[i].live_bytes, memory_order_relaxed);
+        c->peak_bytes = atomic_load_explicit(&modules[i].peak_bytes, memory_order_relaxed);
+        c->live_allocs = atomic_load_explicit(&modules[i].live_allocs, memory_order_relaxed);
+        c->total_allocs = atomic_load_explicit(&modules[i].total_allocs, memory_order_relaxed);
+
+        snapshot->total.live_bytes += c->live_bytes;
+        snapshot->total.peak_bytes += c->peak_bytes;
+        snapshot->total.live_allocs += c->live_allocs;
+        snapshot->total.total_allocs += c->total_allocs;
+    }
+}
+
+/**
+ * @brief Returns the name of a module.
+ *
+ * @param module MEMSTAT_* module.
+ *
+ * @returns Module's name.
+*/
+const char *memstat_module_name(int module)
+{
+    /* Sanity Check. */
+    assert( module >= 0 && module < MEMSTAT_NUM_MODULES );
+
+    return (names[module]);
+}
+
+/**
+ * @brief Writes a table with current counters of every module.
+ *
+ * @param out Where table is written.
+*/
+void memstat_dump(FILE *out)
+{
+    struct memstat_snapshot s;
+    memstat_snapshot(&s);
+
+    fprintf(out, "%-16s %14s %14s %12s %12s\n", "module", "live bytes", "peak bytes", "live allocs", "allocs");
+    for ( int i = 0; i <= MEMSTAT_NUM_MODULES; i++ )
+    {
+        const struct memstat_counters *c = ( i < MEMSTAT_NUM_MODULES ) ? &s.modules[i] : &s.total;
+        fprintf(out, "%-16s %14lld %14lld %12lld %12lld\n", ( i < MEMSTAT_NUM_MODULES ) ? names[i] : "total",
+                c->live_bytes, c->peak_bytes, c->live_allocs, c->total_allocs);
+    }
+}
+
+/**
+ * @brief (EXIT) Writes counters to stderr.
+*/
+static void memstat_dump_stderr(void)
+{
+    memstat_dump(stderr);
+}
+
+/**
+ * @brief Writes counters to stderr when program exits, if MEMSTAT_ENV is set (and is not "0").
+*/
+void memstat_dump_on_exit(void)
+{
+    const char *env = getenv(MEMSTAT_ENV);
+
+    if ( env != NULL && strcmp(env, "0") != 0 ) atexit(memstat_dump_stderr);
+}
@@ -1,181 +1,313 @@
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 
 
 #include "point.h"
-#include "color.h"
+#include "point_store.h"
 
-struct point
+#define POINT_INITIAL_SIZE 256 /** << Initial number of points that fit in the scene's store. */
+
+/**
+ * @brief Scene's points. Every point_tt is a handle to a slot of it.
+*/
+static point_store_tt store = NULL;
+
+/**
+ * @brief Returns scene's point store, creating it on first use.
+ *
+ * @returns Scene's point store.
+*/
+point_store_tt point_get_store(void)
+{
+    if ( store == NULL ) store = point_store_create(POINT_INITIAL_SIZE);
+
+    return (store);
+}
+
+/**
+ * @brief Returns the number of slots in scene's store (free ones included). Points are the valid ones of point_at(0), ..., point_at(point_count - 1).
+ *
+ * @returns Number of slots.
+*/
+int point_count(void)
 {
-    int      p_id;    /** << Point identifier.                        */
-    int      taken;   /** << If point is already taken by any object. */
-    double   coord_x; /** << X coordinate of drawn point.             */
-    double   coord_y; /** << Y coordinate of drawn point.             */
-    color_tt pcolor;  /** << Desired color for given Point.           */  
-};
+    return point_store_size(point_get_store());
+}
 
 /**
- * @brief Next available point identification number.
+ * @brief Returns the number of live points in scene's store (free slots are not counted).
+ *
+ * @returns Number of points.
 */
-static int next_p_id = 0;
+int point_live_count(void)
+{
+    return point_store_live(point_get_store());
+}
+
+/**
+ * @brief Returns the handle of the point in a slot of scene's store. Slot may be free (see point_flags).
+ *
+ * @param i Index of slot, in [0, point_count).
+ *
+ * @returns Handle of slot's current point.
+*/
+point_tt point_at(int i)
+{
+    /* Sanity Check. */
+    assert( i >= 0 && i < point_count() );
+
+    return HANDLE_MAKE(i, point_store_generation(store)[i]);
+}
 
 /**
- * @brief Initializes the Point structure.
- * 
+ * @brief Removes all points of the scene, next point created is index 0 again. Handles of removed points go stale.
+*/
+void point_clear(void)
+{
+    point_store_clear(point_get_store());
+}
+
+/**
+ * @brief Checks if a handle still references a slot of scene's store, i.e. slot was not reused since.
+ *
+ * @param p Given point.
+ *
+ * @returns If point is valid. 0 = No, 1 = Yes.
+*/
+int point_is_valid(point_tt p)
+{
+    int i = HANDLE_INDEX(p);
+
+    if ( p == POINT_NONE || i >= point_count() ) return 0;
+    return ( point_store_generation(store)[i] == HANDLE_GENERATION(p) ) ? 1 : 0;
+}
+
+/**
+ * @brief Returns the slot of a point in scene's store, where its coordinates, flags and color are.
+ *
+ * @param p Given point.
+ *
+ * @returns Index in store's arrays.
+*/
+int point_index(point_tt p)
+{
+    /* Sanity Check. */
+    assert( point_is_valid(p) );
+
+    return HANDLE_INDEX(p);
+}
+
+/**
+ * @brief Initializes a Point in scene's point store.
+ *
  * @param x X coordinate.
  * @param y Y coordinate.
- * 
+ *
  * @returns A point.
 */
 point_tt point_create(double x,
                       double y)
 {
-    struct point *p = (struct point*) malloc(sizeof(struct point));
-    p->p_id = next_p_id++;
-    p->taken = 0;
-    p->coord_x = x;
-    p->coord_y = y;
-    p->pcolor = NULL;
+    int i = point_store_add(point_get_store(), x, y, POINT_ALIVE);
 
-    return (p);
+    return HANDLE_MAKE(i, point_store_generation(store)[i]);
 }
 
 /**
- * @brief Destroy given Point.
- * 
+ * @brief Destroy given Point. Its slot is reused by a later point_create, and its handle goes stale.
+ *
  * @param p Given point.
 */
-void point_destroy(struct point *p)
+void point_destroy(point_tt p)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
-
-    color_destroy(p->pcolor);
-    free(p);
+    point_store_remove(store, point_index(p));
 }
 
 /**
  * @brief Returns X coordinate of a given point.
- * 
+ *
  * @param p Given point.
- * 
+ *
  * @returns X coordinate of given point.
 */
-double point_x_coord(const struct point *p)
+double point_x_coord(point_tt p)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
-
-    return (p->coord_x);
+    return (point_store_x(store)[point_index(p)]);
 }
 
 /**
  * @brief Returns Y coordinate of a given point.
- * 
+ *
  * @param p Given point.
- * 
+ *
  * @returns Y coordinate of given point.
 */
-double point_y_coord(const struct point *p)
+double point_y_coord(point_tt p)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
-
-
-    return (p->coord_y);
+    return (point_store_y(store)[point_index(p)]);
 }
 
 /**
  * @brief Sets a new coordinate to a given point.
- * 
+ *
  * @param p Given point.
  * @param x X coordinate.
- * @param y Y coordinate. 
+ * @param y Y coordinate.
 */
-void point_set_coord(struct point *p,
-                     double        x, 
-                     double        y)
+void point_set_coord(point_tt p,
+                     double   x,
+                     double   y)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
+    int i = point_index(p);
 
-    p->coord_x = x;
-    p->coord_y = y;
+    point_store_x(store)[i] = x;
+    point_store_y(store)[i] = y;
+    point_store_touch(store);
 }
 
 /**
- * @brief Returns Point id.
- * 
- * @param p Given point.
- * 
- * @returns Returns Point id.
+ * @brief Copies coordinates of some points into contiguous arrays (e.g. to transform them at once, see affine_kernel.h).
+ *
+ * @param points Given points.
+ * @param n      Number of points.
+ * @param x      Output: X coordinates, one per point.
+ * @param y      Output: Y coordinates, one per point.
 */
-int point_id(const struct point *p)
+void point_gather(const point_tt *points,
+                  int             n,
+                  double         *x,
+                  double         *y)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
+    const double *sx = point_store_x(store),
+                 *sy = point_store_y(store);
+
+    for ( int i = 0; i < n; i++ )
+    {
+        int k = point_index(points[i]);
+        x[i] = sx[k];
+        y[i] = sy[k];
+    }
+}
 
-    return (p->p_id);
+/**
+ * @brief Returns the epoch of scene's store. Boxes cached by objects are valid while it does not change.
+ *
+ * @returns Current epoch (see point_store_epoch).
+*/
+unsigned point_epoch(void)
+{
+    return point_store_epoch(point_get_store());
+}
+
+/**
+ * @brief Computes the box of some points. Box of no points is empty (xmin > xmax).
+ *
+ * @param points Given points.
+ * @param n      Number of points.
+ * @param box    Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+*/
+void point_get_box(const point_tt *points,
+                   int             n,
+                   double         *box)
+{
+    const double *x = point_store_x(store),
+                 *y = point_store_y(store);
+
+    box[0] = box[1] = INFINITY;
+    box[2] = box[3] = -INFINITY;
+    for ( int i = 0; i < n; i++ )
+    {
+        int k = point_index(points[i]);
+        if ( x[k] < box[0] ) box[0] = x[k];
+        if ( y[k] < box[1] ) box[1] = y[k];
+        if ( x[k] > box[2] ) box[2] = x[k];
+        if ( y[k] > box[3] ) box[3] = y[k];
+    }
 }
 
 /**
  * @brief Sets a point as taken by an object.
- * 
+ *
  * @param p Given point.
 */
-void point_take(struct point *p)
+void point_take(point_tt p)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
-
-    p->taken = 1;
+    point_mark(p, POINT_TAKEN);
 }
 
 /**
  * @brief Returns if given point is already taken by any object.
- * 
+ *
  * @param p Given point.
- * 
+ *
  * @returns If given point is already taken. 0 = No, 1 = Yes.
 */
-int point_is_taken(const struct point *p)
+int point_is_taken(point_tt p)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
+    return ( point_flags(p) & POINT_TAKEN ) ? 1 : 0;
+}
 
-    return (p->taken);
+/**
+ * @brief Adds flags to a point (e.g. POINT_CLIP).
+ *
+ * @param p     Given point.
+ * @param flags POINT_* flags.
+*/
+void point_mark(point_tt      p,
+                unsigned char flags)
+{
+    point_store_flags(store)[point_index(p)] |= flags;
+}
+
+/**
+ * @brief Removes flags from a point (e.g. POINT_TAKEN, when the object that took it is undone).
+ *
+ * @param p     Given point.
+ * @param flags POINT_* flags.
+*/
+void point_unmark(point_tt      p,
+                  unsigned char flags)
+{
+    point_store_flags(store)[point_index(p)] &= (unsigned char) ~flags;
 }
 
 /**
- * @brief Defines which color a point should have (RGB-based).
- * 
+ * @brief Returns the flags of a point.
+ *
+ * @param p Given point.
+ *
+ * @returns POINT_* flags.
+*/
+unsigned char point_flags(point_tt p)
+{
+    return (point_store_flags(store)[point_index(p)]);
+}
+
+/**
+ * @brief Defines which color a point should have (RGB-based, channels in [0, 1]). Color is interned in store's palette, point keeps its index.
+ *
  * @param p Specified point.
  * @param r RED.
  * @param g GREEN.
  * @param b BLUE.
 */
-void point_define_color(struct point *p,
-                        double        r,
-                        double        g,
-                        double        b)
+void point_define_color(point_tt p,
+                        double   r,
+                        double   g,
+                        double   b)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
-    p->pcolor = color_create(r, g, b);
+    point_store_color_index(store)[point_index(p)] = point_store_intern_color(store, color_pack(r, g, b));
 }
 
 /**
  * @brief Returns the pre-defined color from a defined point.
- * 
+ *
  * @param p Given point.
- * 
- * @returns Returns the color from a point.
+ *
+ * @returns Packed color (RGBA) of point.
 */
-color_tt point_color(const struct point *p)
+uint32_t point_color(point_tt p)
 {
-    /* Sanity Check. */
-    assert( p != NULL );
-    assert( p->pcolor != NULL );
-
-    return (p->pcolor);
-}
\ No newline at end of file
+    return point_store_color(store, point_store_color_index(store)[point_index(p)]);
+}
@@ -0,0 +1,342 @@
+#include <assert.h>
+#include <stdlib.h>
+
+
+#include "memstat.h"
+#include "point_store.h"
+#include "vector.h"
+
+/**
+ * @brief Points kept as a structure of arrays: the i-th point is (x[i], y[i]), with flags[i] and color_index[i].
+ * Loops that only need coordinates stream through two contiguous arrays of doubles.
+ * Slots of removed points are reused, generation[i] tells apart handles (see handle.h) of each use of slot i.
+*/
+struct point_store
+{
+    VECTOR(double)        x;           /** << X coordinates.                                   */
+    VECTOR(double)        y;           /** << Y coordinates.                                   */
+    VECTOR(unsigned char) flags;       /** << POINT_* flags, 0 if slot is free.                */
+    VECTOR(uint16_t)      color_index; /** << Index in palette, 0 (black) if not defined.      */
+    VECTOR(uint8_t)       generation;  /** << Generation of each slot (kept between clears).   */
+    VECTOR(int)           free;        /** << Slots of removed points, reused first.           */
+    palette_tt            palette;     /** << Distinct colors used by points (packed RGBA).    */
+    unsigned              epoch;       /** << Bumped whenever coordinates may have changed.    */
+    size_t                accounted;   /** << Bytes of arrays reported to memstat.             */
+};
+
+/**
+ * @brief Reports to memstat how much the arrays take now (their capacity, not their size).
+ *
+ * @param s Given point store.
+*/
+static void point_store_account(struct point_store *s)
+{
+    size_t bytes = sizeof(double) * (s->x.capacity + s->y.capacity) + sizeof(unsigned char) * s->flags.capacity +
+                   sizeof(uint16_t) * s->color_index.capacity + sizeof(uint8_t) * s->generation.capacity + sizeof(int) * s->free.capacity;
+
+    memstat_resize(MEMSTAT_POINTS, s->accounted, bytes);
+    s->accounted = bytes;
+}
+
+/**
+ * @brief Initializes the Point Store structure.
+ *
+ * @param capacity Initial number of points that fit. Store grows when needed.
+ *
+ * @returns A point store.
+*/
+point_store_tt point_store_create(int capacity)
+{
+    struct point_store *s = (struct point_store*) malloc(sizeof(struct point_store));
+
+    vector_init(&s->x);
+    vector_init(&s->y);
+    vector_init(&s->flags);
+    vector_init(&s->color_index);
+    vector_init(&s->generation);
+    vector_init(&s->free);
+    s->palette = palette_create();
+    s->epoch = 1;
+    vector_reserve(&s->x, capacity);
+    vector_reserve(&s->y, capacity);
+    vector_reserve(&s->flags, capacity);
+    vector_reserve(&s->color_index, capacity);
+    vector_reserve(&s->generation, capacity);
+    s->accounted = 0;
+    point_store_account(s);
+
+    return (s);
+}
+
+/**
+ * @brief Destroys the Point Store structure.
+ *
+ * @param s Given point store.
+*/
+void point_store_destroy(struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    memstat_resize(MEMSTAT_POINTS, s->accounted, 0);
+    vector_free(&s->x);
+    vector_free(&s->y);
+    vector_free(&s->flags);
+    vector_free(&s->color_index);
+    vector_free(&s->generation);
+    vector_free(&s->free);
+    palette_destroy(s->palette);
+    free(s);
+}
+
+/**
+ * @brief Removes all points (and colors). Memory is kept to be reused.
+ * Generations of all slots are bumped, so handles of removed points stay stale when slots are used again.
+ *
+ * @param s Given point store.
+*/
+void point_store_clear(struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    for ( int i = 0; i < s->x.size; i++ ) s->generation.data[i]++;
+    vector_clear(&s->free);
+    vector_clear(&s->x);
+    vector_clear(&s->y);
+    vector_clear(&s->flags);
+    vector_clear(&s->color_index);
+    palette_clear(s->palette);
+    point_store_touch(s);
+}
+
+/**
+ * @brief Adds a point in the slot of the last removed point or, if there is none, at the end of the store.
+ * Arrays may move when the store grows, so pointers returned by point_store_x (and others) must not be kept across additions.
+ *
+ * @param s     Given point store.
+ * @param x     X coordinate.
+ * @param y     Y coordinate.
+ * @param flags POINT_* flags.
+ *
+ * @returns Index of the new point.
+*/
+int point_store_add(struct point_store *s,
+                    double              x,
+                    double              y,
+                    unsigned char       flags)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    if ( s->free.size > 0 )
+    {
+        int i = s->free.data[--s->free.size];
+        s->x.data[i] = x;
+        s->y.data[i] = y;
+        s->flags.data[i] = flags;
+        s->color_index.data[i] = 0;
+        return (i);
+    }
+
+    assert( s->x.size < HANDLE_MAX_SLOTS );
+    int capacity = s->x.capacity;
+    vector_push(&s->x, x);
+    vector_push(&s->y, y);
+    vector_push(&s->flags, flags);
+    vector_push(&s->color_index, 0);
+    if ( s->generation.size < s->x.size ) vector_push(&s->generation, 0);
+    if ( s->x.capacity != capacity ) point_store_account(s);
+
+    return (s->x.size - 1);
+}
+
+/**
+ * @brief Removes a point. Its slot gets a new generation and is reused by the next point_store_add.
+ *
+ * @param s Given point store.
+ * @param i Index of point.
+*/
+void point_store_remove(struct point_store *s,
+                        int                 i)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+    assert( i >= 0 && i < s->x.size );
+    assert( s->flags.data[i] != 0 );
+
+    s->flags.data[i] = 0;
+    s->generation.data[i]++;
+    int capacity = s->free.capacity;
+    vector_push(&s->free, i);
+    if ( s->free.capacity != capacity ) point_store_account(s);
+}
+
+/**
+ * @brief Returns the number of points in the store.
+ *
+ * @param s Given point store.
+ *
+ * @returns Number of points.
+*/
+int point_store_size(const struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->x.size);
+}
+
+/**
+ * @brief Returns the number of live points: slots minus free ones (waiting to be reused).
+ *
+ * @param s Given point store.
+ *
+ * @returns Number of live points.
+*/
+int point_store_live(const struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->x.size - s->free.size);
+}
+
+/**
+ * @brief Returns X coordinates of all points.
+ *
+ * @param s Given point store.
+ *
+ * @returns Array of point_store_size X coordinates.
+*/
+double* point_store_x(struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->x.data);
+}
+
+/**
+ * @brief Returns Y coordinates of all points.
+ *
+ * @param s Given point store.
+ *
+ * @returns Array of point_store_size Y coordinates.
+*/
+double* point_store_y(struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->y.data);
+}
+
+/**
+ * @brief Returns flags of all points.
+ *
+ * @param s Given point store.
+ *
+ * @returns Array of point_store_size POINT_* flags.
+*/
+unsigned char* point_store_flags(struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->flags.data);
+}
+
+/**
+ * @brief Tells the store that coordinates were changed, so anything computed from them (e.g. objects' boxes) is outdated.
+ * Whoever writes through point_store_x or point_store_y must call it once, after writing.
+ *
+ * @param s Given point store.
+*/
+void point_store_touch(struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    // Epoch 0 is never used, so caches starting at 0 are always outdated
+    if ( ++s->epoch == 0 ) s->epoch = 1;
+}
+
+/**
+ * @brief Returns store's epoch, which changes whenever coordinates may have changed (see point_store_touch).
+ *
+ * @param s Given point store.
+ *
+ * @returns Current epoch, never 0.
+*/
+unsigned point_store_epoch(const struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->epoch);
+}
+
+/**
+ * @brief Returns generations of all slots.
+ *
+ * @param s Given point store.
+ *
+ * @returns Array of point_store_size generations.
+*/
+const uint8_t* point_store_generation(const struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->generation.data);
+}
+
+/**
+ * @brief Returns palette indexes of all points.
+ *
+ * @param s Given point store.
+ *
+ * @returns Array of point_store_size palette indexes (0, black, if point has no color).
+*/
+uint16_t* point_store_color_index(struct point_store *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->color_index.data);
+}
+
+/**
+ * @brief Returns the palette index of a color, adding it to store's palette if needed.
+ *
+ * @param s Given point store.
+ * @param c Packed color.
+ *
+ * @returns Index of color in palette.
+*/
+uint16_t point_store_intern_color(struct point_store *s,
+                                  uint32_t            c)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return palette_intern(s->palette, c);
+}
+
+/**
+ * @brief Returns a color of store's palette.
+ *
+ * @param s   Given point store.
+ * @param idx Index in palette.
+ *
+ * @returns Packed color.
+*/
+uint32_t point_store_color(const struct point_store *s,
+                           uint16_t                  idx)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return palette_get(s->palette, idx);
+}
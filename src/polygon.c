@@ -1,82 +1,92 @@
 #include <assert.h>
 #include <stdlib.h>
 
+#include "affine.h"
+#include "arena.h"
+#include "memstat.h"
 #include "polygon.h"
 
 struct polygon
 {
-    int      desired_algh;   /** << Desired algorithm to draw. */
-    int      pl_id;          /** << Polygon identifier.        */
-    int      was_clipped;    /** << If polygon was clipped.    */
+    int       desired_algh;       /** << Desired algorithm to draw.   */
+    int       was_clipped;        /** << If polygon was clipped.      */
 
 
-    array_tt points;         /** << Polygon's points.          */
-    array_tt clipped_points; /** << Polygon's croppped points. */
-};
+    point_tt *points;             /** << Polygon's points.            */
+    int       num_points;         /** << Number of Polygon's points.  */
+    point_tt *clipped_points;     /** << Polygon's croppped points.   */
+    int       num_clipped_points; /** << Number of croppped points.   */
 
-/**
- * @brief Next available polygon identification number.
-*/
-static int next_pl_id = 0;
+    struct affine matrix;         /** << Points' coordinates to world: every transformation applied so far. */
+
+    double    local_box[4];       /** << Cached box of Polygon's points (not transformed).     */
+    unsigned  local_epoch;        /** << Points' epoch when local_box was computed.            */
+    double    box[4];             /** << Cached world box (local_box through matrix).          */
+    unsigned  box_epoch;          /** << Points' epoch when box was computed (0 = invalid).    */
+};
 
 /**
  * @brief Initializes the Polygon structure.
  * 
+ * @param arena  Arena that holds the polygon (and its points' indexes).
  * @param points Array that contains all points of given Polygon.
  * @param size   Number of points.
  * @param Algh   Drawing algorithm desired. 
  * 
  * @returns A Polygon.
 */
-polygon_tt polygon_create(struct point **points, int size, int algh)
+polygon_tt polygon_create(arena_tt arena, const point_tt *points, int size, int algh)
 {
-    struct polygon *pl = (struct polygon*) malloc(sizeof(struct polygon));
+    struct polygon *pl = (struct polygon*) arena_alloc(arena, sizeof(struct polygon));
 
-    assert( size < MAX_POINTS );
+    assert( size > 0 );
     
     pl->desired_algh = algh;
-    pl->pl_id = next_pl_id++;
     pl->was_clipped = 0;
-    pl->points = array_create(MAX_POINTS);
-    pl->clipped_points = array_create(MAX_POINTS);
-    
+    pl->points = (point_tt*) arena_alloc(arena, sizeof(point_tt) * size);
+    memstat_alloc(MEMSTAT_POLYGONS, sizeof(struct polygon) + sizeof(point_tt) * size);
+    pl->num_points = size;
+    pl->clipped_points = NULL;
+    pl->num_clipped_points = 0;
+    affine_identity(&pl->matrix);
+    pl->local_epoch = 0;
+    pl->box_epoch = 0;
 
     for ( int i = 0; i < size; i++ )
     {
-        array_set(pl->points, i, points[i]);
+        pl->points[i] = points[i];
     }
 
     return (pl);
 }
 
 /**
- * @brief Adds new points to a polygon whenever it gets clipped. If size == 0, it imples that polygon won't be clipped anymore
+ * @brief Sets the clipped points of a polygon whenever it gets clipped. If flag is not 1, polygon has no clipped points.
  * 
  * @param pl     Given polygon.
+ * @param arena  Arena that holds the clipped points' indexes.
+ * @param points Clipped points of a polygon, in the same order Polygon's edges are clipped.
  * @param size   Number of clipped points.
- * @param points Clipped points of a polygon.
- * @param flag    Defines which type of clipping ocurred. 0 = None, 1 = Clipped, 2 = Clipped but not drawn
+ * @param flag   Defines which type of clipping ocurred. 0 = None, 1 = Clipped, 2 = Clipped but not drawn
 */
-void polygon_add_clipped_points(struct polygon *pl, struct point **points, int size, int flag)
+void polygon_add_clipped_points(struct polygon *pl, arena_tt arena, const point_tt *points, int size, int flag)
 {
     /* Sanity Check. */
     assert( pl != NULL );
-    assert( size < MAX_POINTS );
     
     pl->was_clipped = flag;
+    pl->num_clipped_points = 0;
 
-    if ( pl->was_clipped == 1 )
+    if ( pl->was_clipped == 1 && size > 0 )
     {
+        pl->clipped_points = (point_tt*) arena_alloc(arena, sizeof(point_tt) * size);
+        memstat_alloc(MEMSTAT_POLYGONS, sizeof(point_tt) * size);
         for ( int i = 0; i < size ; i++ )
         {
-            array_set(pl->clipped_points, i + (array_get_curr_num(pl->clipped_points) - 1), points[i++]);
+            pl->clipped_points[i] = points[i];
         }
+        pl->num_clipped_points = size;
     } 
-    else if ( pl->was_clipped == 0 )
-    {
-        array_set_curr_num(pl->clipped_points, 0);
-    }
-     
 }
 
 /**
@@ -84,9 +94,9 @@ void polygon_add_clipped_points(struct polygon *pl, struct point **points, int s
  * 
  * @param pl Desired Polygon.
  * 
- * @returns Polygon's original points.
+ * @returns Polygon's original points (polygon_num_points of them).
 */
-array_tt polygon_get_points(const struct polygon *pl)
+const point_tt* polygon_get_points(const struct polygon *pl)
 {
     /* Sanity Check. */
     assert( pl != NULL );
@@ -94,14 +104,84 @@ array_tt polygon_get_points(const struct polygon *pl)
     return (pl->points);
 }
 
+/**
+ * @brief Returns the number of Polygon's original points.
+ * 
+ * @param pl Desired Polygon.
+ * 
+ * @returns Number of Polygon's original points.
+*/
+int polygon_num_points(const struct polygon *pl)
+{
+    /* Sanity Check. */
+    assert( pl != NULL );
+    
+    return (pl->num_points);
+}
+
+/**
+ * @brief Returns Polygon's matrix: its points' coordinates are mapped through it to the world (where Polygon is drawn and clipped).
+ * 
+ * @param pl Desired Polygon.
+ * 
+ * @returns Polygon's matrix.
+*/
+const struct affine *polygon_get_matrix(const struct polygon *pl)
+{
+    /* Sanity Check. */
+    assert( pl != NULL );
+
+    return (&pl->matrix);
+}
+
+/**
+ * @brief Transforms a Polygon in O(1), no matter how many points it has: given matrix is composed with Polygon's one, points are not moved.
+ * 
+ * @param pl Given Polygon.
+ * @param a  Transformation, applied after every previous one.
+*/
+void polygon_transform(struct polygon *pl, const struct affine *a)
+{
+    /* Sanity Check. */
+    assert( pl != NULL && a != NULL );
+
+    affine_multiply(&pl->matrix, a, &pl->matrix);
+    pl->box_epoch = 0;
+}
+
+/**
+ * @brief Returns the world box of Polygon's original points. Box of points is cached until they are moved (see point_epoch), and the world box
+ * is its corners through Polygon's matrix, so it is O(1) after a transformation (it holds every point, but it is not the tightest one when rotated).
+ * 
+ * @param pl  Desired Polygon.
+ * @param box Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+*/
+void polygon_get_box(struct polygon *pl, double *box)
+{
+    /* Sanity Check. */
+    assert( pl != NULL );
+
+    if ( pl->box_epoch != point_epoch() )
+    {
+        if ( pl->local_epoch != point_epoch() )
+        {
+            point_get_box(pl->points, pl->num_points, pl->local_box);
+            pl->local_epoch = point_epoch();
+        }
+        affine_apply_box(&pl->matrix, pl->local_box, pl->box);
+        pl->box_epoch = point_epoch();
+    }
+    for ( int i = 0; i < 4; i++ ) box[i] = pl->box[i];
+}
+
 /**
  * @brief Returns Polygons's clipped points.
  * 
  * @param pl Desired Polygons.
  * 
- * @returns Polygons's clipped points.
+ * @returns Polygons's clipped points (polygon_num_clipped_points of them).
 */
-array_tt polygon_get_clipped_points(const struct polygon *pl)
+const point_tt* polygon_get_clipped_points(const struct polygon *pl)
 {
     /* Sanity Check. */
     assert( pl != NULL );
@@ -109,9 +189,24 @@ array_tt polygon_get_clipped_points(const struct polygon *pl)
     return (pl->clipped_points);
 }
 
+/**
+ * @brief Returns the number of Polygons's clipped points.
+ * 
+ * @param pl Desired Polygons.
+ * 
+ * @returns Number of Polygons's clipped points.
+*/
+int polygon_num_clipped_points(const struct polygon *pl)
+{
+    /* Sanity Check. */
+    assert( pl != NULL );
+    
+    return (pl->num_clipped_points);
+}
+
 
 /**
- * @brief Destroys the Polygon structure.
+ * @brief Destroys the Polygon structure and its points. Its memory is given back when its arena is reset.
  * 
  * @param pl Given polygon.
 */
@@ -119,10 +214,9 @@ void polygon_destroy(struct polygon *pl)
 {
     /* Sanity Check. */
     assert( pl != NULL );
-    array_destroy(pl->clipped_points);
-    array_destroy(pl->points);
 
-    free(pl);
+    for ( int i = 0; i < pl->num_clipped_points; i++ ) point_destroy(pl->clipped_points[i]);
+    for ( int i = 0; i < pl->num_points; i++ ) point_destroy(pl->points[i]);
 }
 
 /**
@@ -154,19 +248,3 @@ int polygon_was_clipped(const struct polygon *pl)
 
     return (pl->was_clipped);
 }
-
-/**
- * @brief Returns polygon's id.
- * 
- * @param pl Given polygon.
- * 
- * @returns Returns polygon's id.
-*/
-int polygon_id(const struct polygon *pl)
-{
-    /* Sanity Check. */
-    assert( pl != NULL );
-
-    return (pl->pl_id);
-}
-
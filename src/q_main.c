@@ -11,18 +11,117 @@
 #include <X11/Xlib.h>
 #include <X11/extensions/Xrandr.h>
 
-#include "array.h"
+#include "affine.h"
+#include "affine_kernel.h"
+#include "arena.h"
+#include "bvh.h"
+#include "color.h"
+#include "command_log.h"
+#include "handle.h"
 #include "line.h"
 #include "point.h"
+#include "point_store.h"
 #include "polygon.h"
 #include "circumference.h"
 #include "clipping.h"
+#include "display_list.h"
+#include "grid.h"
+#include "label.h"
+#include "memstat.h"
+#include "raster.h"
+#include "renderer.h"
+#include "scene_graph.h"
+#include "scheduler.h"
+#include "transform_script.h"
 
-// #define MAX_POINTS 10
+#define INITIAL_OBJECTS 64 /** << Initial size of Objects' arrays, they grow when needed. */
+
+#define OBJECTS_PER_JOB 64 /** << Objects processed by each scheduler's job. */
+
+#define POINTS_PER_JOB 4096 /** << Points (of Objects) processed by each scheduler's job. */
+
+#define WORLD_BLOCK 256 /** << Points gathered (on stack) and transformed at once when computing world coordinates. */
+
+#define VIEW_MARGIN (RASTER_LABEL_SIZE * 8) /** << Objects this close to canvas' border are still drawn, so their labels are not cut. */
+
+#define SELECT_TOLERANCE 4.0 /** << A click this close (in pixels) to an Object's box selects it. Shorter drags are clicks too. */
+
+#define SELECT_COLOR COLOR_RGBA(0, 120, 255, 255) /** << Color of selected Objects' boxes. */
+
+/**
+ * @brief What a left-click in Drawing Area does.
+*/
+/**@(*/
+#define MODE_DRAW   0 /** << Creates a point.                                               */
+#define MODE_SELECT 1 /** << Selects the Object clicked, or those inside a dragged rectangle. */
+/**@)*/
+
+/**
+ * @brief Kinds of Objects in the handle table.
+*/
+/**@(*/
+#define OBJECT_LINE          1
+#define OBJECT_POLYGON       2
+#define OBJECT_CIRCUMFERENCE 3
+#define OBJECT_CLIP          4
+#define OBJECT_GROUP         5
+/**@)*/
+
+#define SCRIPT_TIMED_STEPS 8 /** << Steps whose timings are written in "label" after running a script (others are summed up). */
+
+#define ANIMATION_STEP_TIME 500000 /** << Time (in microseconds) each step (keyframe) of an animated script takes.                              */
+#define ANIMATION_BUDGET    12000  /** << Time (in microseconds) a frame of an animation may take, a frame that takes longer skips the next one. */
 
-static cairo_surface_t *surface = NULL;
 static int algh = 0;
 
+static int mode = MODE_DRAW;
+
+/**
+ * @brief Memory of all Objects (Lines, Polygons, Circumferences, Clips) of the scene. Cleaning canvas rewinds it at once.
+*/
+static arena_tt arena = NULL;
+
+/**
+ * @brief Runs geometry operations (transformations, clipping) and tiled rasterization as chunked jobs.
+*/
+static scheduler_tt scheduler = NULL;
+
+/**
+ * @brief Rasterizes drawings in a background thread and presents them in drawing area.
+*/
+static renderer_tt renderer = NULL;
+
+/**
+ * @brief Screen-space layout of "(X, Y)" labels. Prevents overlapping labels and bounds how many are drawn.
+*/
+static label_layout_tt labels = NULL;
+
+/**
+ * @brief Allocates a temporary buffer (only alive during an operation), accounting it in memstat.
+ *
+ * @param bytes Size of buffer.
+ *
+ * @returns Buffer.
+*/
+static void *temp_alloc(size_t bytes)
+{
+    memstat_alloc(MEMSTAT_TEMPORARY, bytes);
+    return malloc(bytes);
+}
+
+/**
+ * @brief Frees a temporary buffer allocated by temp_alloc.
+ *
+ * @param buffer Given buffer.
+ * @param bytes  Size given to temp_alloc.
+*/
+static void temp_free(void   *buffer,
+                      size_t  bytes)
+{
+    memstat_release(MEMSTAT_TEMPORARY, bytes);
+    free(buffer);
+}
+
 /**
  * @brief All Widgets from our interface.
 */
@@ -37,6 +136,9 @@ struct {
                    *dropdown_algorithms,
                    *dropdown_drawings,
                    *dropdown_croppings,
+                   *dropdown_renderings,
+                   *dropdown_modes,
+                   *dropdown_edits,
                    *main_input,
                    *label;
     GtkGesture     *drag, 
@@ -46,1973 +148,3219 @@ struct {
 
 
 /**
- * @brief Current clicked Points.
+ * @brief Every drawn Object (Line, Polygon, Circumference, Clip). Objects are referenced by handles, lists below hold handles.
 */
-static array_tt arr_points;
+static handle_table_tt objects = NULL;
+
+/**
+ * @brief Groups of Objects (and of other groups). An Object's points go through its own matrix and then through its groups' world matrix.
+ * Groups' handles are also taken from "objects" (their data is the scene graph itself).
+*/
+static scene_graph_tt scene = NULL;
 
 /**
  * @brief Current drawn Lines.
 */
-static array_tt arr_lines;
+static handle_list_tt arr_lines;
 
 /**
  * @brief Current drawn Polygons.
 */
-static array_tt arr_polygons;
+static handle_list_tt arr_polygons;
 
 /**
  * @brief Current drawn Circumferences.
 */
-static array_tt arr_circumferences;
+static handle_list_tt arr_circumferences;
 
 /**
  * @brief Current drawn Clips.
 */
-static array_tt arr_clips;
+static handle_list_tt arr_clips;
 
 /**
- * @brief Removes all points drawn in canvas.
+ * @brief Spatial index of every Object's box. Clipping and redrawing only go through Objects it returns.
 */
-static void clear_surface(int flag)
-{
-    cairo_t *cr = cairo_create(surface);
-    cairo_set_source_rgb(cr, 1, 1, 1);
-    cairo_paint(cr);
-
-    cairo_destroy(cr);
-    gtk_label_set_label(GTK_LABEL(Widgets.label), "Debug informations here...");
-
-    if ( flag ) 
-    {
-        // Recreating array that contains all points
-        array_destroy(arr_points);
-        arr_points = array_create(MAX_POINTS);
-        array_destroy(arr_lines);
-        arr_lines = array_create(MAX_POINTS);
-        array_destroy(arr_polygons);
-        arr_polygons = array_create(MAX_POINTS);
-        array_destroy(arr_circumferences);
-        arr_circumferences = array_create(MAX_POINTS);
-        array_destroy(arr_clips);
-        arr_clips = array_create(MAX_POINTS);
-    }
-}
+static grid_tt grid = NULL;
 
 /**
- * @brief Whenever screen is resized, remove current points to prevent a bug in visualization.
- * 
- * @param widget Drawing area that contains the drawn points
+ * @brief Spatial index of free points (not taken by any Object), by their handles. Redrawing only goes through free points it returns.
 */
-static void resize_cb(GtkWidget *widget,
-                      int        width,
-                      int        height,
-                      gpointer   data)
-{
-    if ( surface )
-    {
-        cairo_surface_destroy(surface);
-        surface = NULL;
-    }
+static grid_tt free_points = NULL;
 
-    if ( gtk_native_get_surface(gtk_widget_get_native(widget)) ) 
-    {
-        surface = gdk_surface_create_similar_surface(gtk_native_get_surface(gtk_widget_get_native(widget)), CAIRO_CONTENT_COLOR, gtk_widget_get_width(widget), gtk_widget_get_height(widget));
+/**
+ * @brief World coordinates (X and Y) of every point taken by a Line, Polygon or Circumference, by point's index in store.
+ * Computed all at once, in parallel, by materialize_world() before drawing or clipping.
+*/
+static VECTOR(double) world_x, world_y;
 
+/**
+ * @brief First point of each Object, counting Lines' points, then Polygons' and then Circumferences', plus the total. See materialize_world().
+*/
+static VECTOR(int) world_offsets;
 
+/**
+ * @brief If world coordinates must be computed again (Objects were added or transformed since), and points' epoch when they were computed.
+*/
+/**@(*/
+static int      world_stale = 1;
+static unsigned world_epoch = 0;
+/**@)*/
 
-        clear_surface(1);
-    }
-}
+/**
+ * @brief Transformations pushed and not applied yet, composed as 3x3 matrices. Flushed by "transform_objects" in a single pass.
+*/
+static affine_chain_tt chain = NULL;
 
 /**
- * @brief (CALL_BACK) Function that is linked with Drawing Area that lets you draw in drawing_area
- * 
- * @param cairo Object used to draw points
+ * @brief Last script run from "Transformation" entry. Its steps are kept, so parsing reuses their memory.
 */
-static void draw_cb(GtkDrawingArea *drawing_area,
-                    cairo_t        *cr,
-                    int             width, 
-                    int             height, 
-                    gpointer        data)
-{
-    cairo_set_source_surface(cr, surface, 0, 0);
-    cairo_paint(cr);
-}
+static transform_script_tt script = NULL;
 
+/**
+ * @brief Bounding volume hierarchy of every Line's and Polygon's box. Bulk loaded when clipping after Objects were added, and refit after transformations,
+ * so clipping accepts or rejects whole subtrees against Clip. Suits scenes where Objects are far from uniformly spread.
+*/
+static bvh_tt bvh = NULL;
 
 /**
- * @brief Receives two points in canvas and converts it into a string pattern that will be drawn whenever a point is drawn by user
- * 
- * @param x X coordinate in canvas.
- * @param y Y coordinate in canvas.
- * 
- * @returns String pattern. (X, Y)
+ * @brief Handles returned by grid's and bvh's queries. Reused, so queries do not allocate.
 */
-char* create_string(double x, 
-                    double y)
-{
-    int size  = 0,
-        aux_x = (int)round(x), 
-        aux_y = (int)round(y);
+static handle_list_tt candidates;
 
-    char *char_x = (char*) malloc (sizeof(char*) * 8),
-         *char_y = (char*) malloc (sizeof(char*) * 8);
+/**
+ * @brief Handles of Objects found inside Clip by bvh's queries. Reused, so queries do not allocate.
+*/
+static handle_list_tt accepted;
 
+/**
+ * @brief Handles of selected Objects (Lines, Polygons, Circumferences). If any, transformations only apply to them.
+*/
+static handle_list_tt selection;
 
-    sprintf(char_x, "%d", aux_x);
-    sprintf(char_y, "%d", aux_y);
-    char_x[7] = char_y[7] = '\0';
+/**
+ * @brief Objects under transformed groups (and transformed Objects). Reused, so transformations do not allocate.
+*/
+static handle_list_tt leaves;
 
-    // Text example: (X, Y)
-    size += strlen(char_x) + strlen(char_y) + 8;
-    char* result = (char*) malloc(sizeof(char) * size);
+/**
+ * @brief Every root (Object not in a group, or outermost group), when each one gets its own matrix. Reused, so transformations do not allocate.
+*/
+static handle_list_tt roots;
 
-    strcat(char_x, ", ");
-    strcat(char_x, char_y);
-    strcpy(result, "(");
-    strcat(result, char_x);
-    result[strlen(char_x) + 1] = ')';
-    result[strlen(char_x) + 2] = '\0';
-    free(char_x);
-    free(char_y);
-    return result;
-}
+/**
+ * @brief Commands that can be undone and redone (transformations, created Objects, grouping), as deltas (see command_log.h).
+ * Clipping and cleaning canvas cannot be undone, they empty it.
+*/
+static command_log_tt history = NULL;
 
 /**
- * @brief Using Cairo, writes the position of drawn x and y in canvas
+ * @brief A root being animated (see "animate_script").
 */
-void draw_text(GtkWidget *widget,
-               cairo_t   *cr,
-               point_tt   p)
+struct animated_root
 {
-    int center_x = 0,
-        center_y = 0; 
-    gtk_widget_get_size_request(Widgets.drawing_area, &center_x, &center_y);
-    double x = point_x_coord(p),
-           y = point_y_coord(p);
-    char *result = create_string(x, y);
-    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_set_font_size(cr, 12.0);
+    double        x, y;    /** << Root's first point in world when animation started (pinned by Rotations). */
+    struct affine applied; /** << Matrix applied to root so far.                                              */
+};
 
-    cairo_move_to(cr, (x + (center_x/2)) - 34, ((center_y/2) - y ) + 15 );
-    cairo_show_text(cr, result);
+/**
+ * @brief Animation of a script (see "animate_script"): its steps are keyframes, played one after another on GTK's frame clock.
+*/
+struct animation
+{
+    VECTOR(struct transform_step) steps;   /** << Script's steps, copied (script is reused by other transformations). */
+    handle_list_tt                roots;   /** << Animated roots. Empty when nothing is animated.                   */
+    VECTOR(struct animated_root)  states;  /** << State of each root.                                               */
+    VECTOR(struct affine)         deltas;  /** << Matrix applied to each root in current frame.                     */
+    affine_chain_tt               chain;   /** << Steps' chain at current frame.                                     */
+    guint                         tick;    /** << Tick callback id, 0 when nothing is animated.                      */
+    gint64                        start;   /** << Frame time of first frame, -1 before it.                           */
+    gint64                        work;    /** << Time spent in frames drawn.                                        */
+    int                           frames;  /** << Frames drawn.                                                      */
+    int                           skipped; /** << Frames skipped (renderer busy, or previous frame over budget).     */
+    int                           late;    /** << If last frame took longer than ANIMATION_BUDGET.                   */
+};
+
+static struct animation animation;
 
-    gtk_widget_queue_draw(widget);
-}
+/**
+ * @brief If bvh's nodes must be refit before its next query (Objects were transformed since).
+*/
+static int bvh_stale = 0;
 
 /**
- * @brief Using Cairo, draws a rectangle in given positions with thickness of 6
+ * @brief Returns an Object of a list (arr_lines, arr_polygons...). O(1).
+ *
+ * @param list Given list.
+ * @param i    Position in list.
+ *
+ * @returns Object referenced by ith handle of list.
 */
-static void draw_brush(GtkWidget *area,
-                       cairo_t   *cr,
-                       double     x, 
-                       double     y,
-                       double    *c)
+static void *object_get(const handle_list_tt *list,
+                        int                   i)
 {
-    int center_x = 0,
-        center_y = 0; 
-    gtk_widget_get_size_request(Widgets.drawing_area, &center_x, &center_y);
-    cairo_set_source_rgb(cr, c[0], c[1], c[2]);
-    cairo_rectangle(cr, (x + (center_x/2))- 3, ((center_y/2) - y ) - 3, 6, 6);
-    cairo_fill(cr);
-    gtk_widget_queue_draw(area);
+    return handle_get(objects, vector_get(list, i));
 }
 
 /**
- * @brief (CALL_BACK) Function called whenever user clicks into canvas
+ * @brief Returns the coordinates in world of some points of an Object, as contiguous arrays: through Object's matrix (points are never moved
+ * by transformations). They are gathered from point store and go through matrix at once, with the vectorized kernel (see affine_kernel.h).
  * 
- * @param x    X coordinate in canvas.
- * @param y    Y coordinate in canvas.
- * @param area Drawing area that point will be added
+ * @param m      Object's matrix. NULL if points are not transformed (free, Clip's and clipped points).
+ * @param points Given points.
+ * @param n      Number of points.
+ * @param x      Output: X coordinates, one per point.
+ * @param y      Output: Y coordinates, one per point.
 */
-static void draw(GtkGestureDrag *gesture,
-                 double          x,
-                 double          y,
-                 GtkWidget      *area)
+static void world_coords(const struct affine *m,
+                         const point_tt      *points,
+                         int                  n,
+                         double              *x,
+                         double              *y)
 {
-    if ( array_get_curr_num(arr_points) == MAX_POINTS )
-    {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You have reached maximum amount of Points.");
-        return;
-    }
-    // Redefining center point to be exactly the center of canvas. In canvas 0,0 is in the top-left corner.
-    int center_x = 0,
-        center_y = 0; 
-    gtk_widget_get_size_request(Widgets.drawing_area, &center_x, &center_y);
-    x = x - (double)(center_x / 2);
-    y = (double)(center_y / 2) - y;
-    struct point *p = point_create(x, y);
-    array_set(arr_points, array_get_curr_num(arr_points), p);
-
-    point_define_color(p, 0.0, 0.0, 0.0);
-
-    cairo_t *cr;
-
-    cr = cairo_create(surface);
-    draw_brush(area, cr, x, y, color_get_colors(point_color(p)));
-    draw_text(area, cr, p);
-    cairo_destroy(cr);
+    point_gather(points, n, x, y);
+    if ( m ) affine_kernel_apply(m, x, y, x, y, n);
 }
 
 /**
- * @brief Uses bresenham algorithm to draw a line between two points. 
+ * @brief Flags of points that go through their Object's matrix: alive points taken by a Line, Polygon or Circumference (not Clip's nor clipped ones).
+*/
+#define WORLD_MASK   (POINT_ALIVE | POINT_TAKEN | POINT_CLIP | POINT_CLIPPED)
+#define WORLD_SELECT (POINT_ALIVE | POINT_TAKEN)
+
+/**
+ * @brief Returns the points of an Object (Line, Polygon or Circumference) and its own matrix.
  * 
- * @param pInit  Initial point of Line.
- * @param pFinal Final point of Line.
- * @param area   Drawing area.
+ * @param h      Object's handle.
+ * @param points Output: Object's points.
+ * @param m      Output: Object's matrix.
+ * 
+ * @returns Number of points. 0 if handle is not a Line, Polygon nor Circumference.
 */
-void Bresenham(point_tt pInit, 
-               point_tt pFinal,
-               GtkWidget *area)
-{
-    cairo_t *cr;
-    cr = cairo_create(surface);
-    int xi = (int) point_x_coord(pInit),
-        yi = (int) point_y_coord(pInit),
-        xf = (int) point_x_coord(pFinal),
-        yf = (int) point_y_coord(pFinal);
-
-    int dx     = xf - xi,
-        dy     = yf - yi,
-        x      = xi,
-        y      = yi,
-        i      = 0,
-        p      = 0,
-        const1 = 0,
-        const2 = 0,
-        incrx  = 0,
-        incry  = 0;
-
-    if ( dx >= 0 ) incrx = 1;
-    else { incrx = -1; dx = (-dx); }
-
-    if ( dy >= 0 ) incry = 1;
-    else { incry = -1; dy = (-dy); }
-
-    if ( dy < dx )
-    {
-        p = 2 * dy - dx;
-        const1 = 2 * dy;
-        const2 = 2 * (dy - dx);
-
-        for ( int i = 0; i < dx; i++ )
-        {
-            x += incrx;
-            if ( p < 0 ) p += const1;
-            else { y += incry; p += const2; }
-            draw_brush(area, cr, (double) round(x), (double) round(y), color_get_colors(point_color(pInit)));
-        }
-    } else 
-    {
-        p = 2 * dx - dy;
-        const1 = 2 * dx;
-        const2 = 2 * (dx - dy);
+static int object_geometry(handle_tt             h,
+                           const point_tt      **points,
+                           const struct affine **m)
+{
+    void *foo = handle_get(objects, h);
 
-        for ( int i = 0; i < dy; i++ )
-        {
-            y += incry;
-            if ( p < 0 ) p += const1;
-            else { x += incrx; p += const2; }
-            draw_brush(area, cr, (double) round(x), (double) round(y), color_get_colors(point_color(pInit)));
-        }
+    switch ( handle_kind(objects, h) )
+    {
+        case OBJECT_LINE:
+            *points = line_get_points(foo);
+            *m = line_get_matrix(foo);
+            return 2;
+        case OBJECT_POLYGON:
+            *points = polygon_get_points(foo);
+            *m = polygon_get_matrix(foo);
+            return polygon_num_points(foo);
+        case OBJECT_CIRCUMFERENCE:
+            *points = circumference_get_points(foo);
+            *m = circumference_get_matrix(foo);
+            return 2;
     }
-
+    return 0;
 }
 
 /**
- * @brief Uses DDA algorithm to draw a line between two points. 
+ * @brief Returns an Object's matrix to world: its own matrix, composed with its group's world matrix if it is in a group (see scene_graph.h).
  * 
- * @param pInit  Initial point of Line.
- * @param pFinal Final point of Line.
- * @param area   Drawing area.
+ * @param h   Object's handle.
+ * @param m   Object's own matrix.
+ * @param tmp Storage for the composed matrix.
+ * 
+ * @returns m itself if Object is not in a group, tmp otherwise.
 */
-void DDA(point_tt pInit,
-         point_tt pFinal,
-         GtkWidget *area)
-{ 
-    double xi = point_x_coord(pInit),
-           yi = point_y_coord(pInit),
-           xf = point_x_coord(pFinal),
-           yf = point_y_coord(pFinal);
-
-    cairo_t *cr;
-    cr = cairo_create(surface);
-    double x_var = xf - xi,
-           y_var = yf - yi,
-           x_incr = 0.0f,
-           y_incr = 0.0f,
-           x_aux = xi,
-           y_aux = yi;
-    int    iterations = 0;
-
-    if ( abs(x_var) > abs(y_var) ) iterations = abs(x_var);
-    else iterations = abs(y_var);
-
-    x_incr = x_var / iterations;
-    y_incr = y_var / iterations;
+static const struct affine *object_matrix(handle_tt            h,
+                                          const struct affine *m,
+                                          struct affine       *tmp)
+{
+    handle_tt g = scene_graph_parent(scene, h);
 
-    for ( int i = 1; i <= iterations; i++ )
-    {
-        x_aux += x_incr;
-        y_aux += y_incr;
-        draw_brush(area, cr, (double) round(x_aux), (double) round(y_aux), color_get_colors(point_color(pInit)));
-    }
-        
-    cairo_destroy(cr);
+    if ( g == HANDLE_NONE ) return m;
+    affine_multiply(tmp, scene_graph_world(scene, g), m);
+    return tmp;
 }
 
 /**
- * @brief (CALL_BACK) Function called whenever user wants to clear canvas
+ * @brief Returns the handle of the kth Object, counting Lines, then Polygons and then Circumferences (as world_offsets).
  * 
- * @param area Drawing area that will be cleaned
+ * @param k Given Object.
+ * 
+ * @returns Object's handle.
 */
-static void clean(GtkGestureClick *gesture,
-                  int              n_press,
-                  double           x, 
-                  double           y,
-                  GtkWidget        *area)
+static handle_tt world_object(int k)
 {
-    clear_surface(1);
-    gtk_widget_queue_draw(area);
+    if ( k < arr_lines.size ) return vector_get(&arr_lines, k);
+    k -= arr_lines.size;
+    if ( k < arr_polygons.size ) return vector_get(&arr_polygons, k);
+    k -= arr_polygons.size;
+    return vector_get(&arr_circumferences, k);
 }
 
 /**
- * @brief (CALL_BACK) Function called whenever user closes main window
+ * @brief Grows world coordinates' arrays, so every point of store fits.
 */
-static void close_window(void)
+static void world_reserve(void)
 {
-    array_destroy(arr_points);
-    array_destroy(arr_lines);
-    array_destroy(arr_polygons);
-    array_destroy(arr_circumferences);
-    array_destroy(arr_clips);
-    if ( surface ) cairo_surface_destroy(surface);
-}
+    int before = world_x.capacity;
 
+    vector_reserve(&world_x, point_count());
+    vector_reserve(&world_y, point_count());
+    memstat_resize(MEMSTAT_POINTS, sizeof(double) * 2 * before, sizeof(double) * 2 * world_x.capacity);
+}
 
 /**
- * @brief (CALL_BACK) Function called whenever an option in "Algorithms"drop-down is sellected.
- * Defines which line-drawing (DDA or Bresenham) algorithm should be used to draw.
+ * @brief Returns if world coordinates are up to date: no Object was added without them, nor transformed, since they were computed
+ * (and no point moved).
  * 
- * @param dropdown Dropdown selected
- * @param entry 
+ * @returns 1 if they are, 0 otherwise.
 */
-static void algorithms_execution(GtkDropDown *dropdown,
-                                 gpointer     user_data)
+static int world_is_valid(void)
 {
-    algh = gtk_drop_down_get_selected(dropdown);
+    return ( !world_stale && world_epoch == point_epoch() );
 }
 
-int number_taken_points()
+/**
+ * @brief Computes world coordinates of some points of an Object, [from, to), and writes them by point's index. Points are gathered in blocks
+ * and go through matrix with the vectorized kernel.
+ * 
+ * @param m      Object's matrix.
+ * @param points Object's points.
+ * @param from   First point.
+ * @param to     One past last point.
+*/
+static void world_write(const struct affine *m,
+                        const point_tt      *points,
+                        int                  from,
+                        int                  to)
 {
-    int num = 0;
+    double x[WORLD_BLOCK],
+           y[WORLD_BLOCK];
 
-    for ( int i = 0; i < array_get_curr_num(arr_points); i++ )
-        if ( point_is_taken(array_get(arr_points, i)) ) num++;
+    for ( int j = from; j < to; j += WORLD_BLOCK )
+    {
+        int n = ( to - j < WORLD_BLOCK ) ? to - j : WORLD_BLOCK;
 
-    return num;
+        world_coords(m, &points[j], n, x, y);
+        for ( int i = 0; i < n; i++ )
+        {
+            int p = point_index(points[j + i]);
+            world_x.data[p] = x[i];
+            world_y.data[p] = y[i];
+        }
+    }
 }
 
 /**
- * @brief Using equality of points, plotting a circumference.
+ * @brief (JOB) Computes world coordinates of Objects' points [begin, end) (see world_offsets). A range may start or end inside an Object,
+ * so a single huge Polygon is split among all threads too (see world_write()).
  * 
- * @param area   Drawing area.
- * @param center Circumference's center point.
- * @param x_calc X coordinate to be plotted.
- * @param y_calc Y coordinate to be plotted.
- *
+ * @param begin First point.
+ * @param end   One past last point.
+ * @param arg   Unused.
 */
-void plot_circle_points(GtkWidget *area,
-                       point_tt   center,
-                       double     x_calc,
-                       double     y_calc)
+static void materialize_job(int   begin,
+                            int   end,
+                            void *arg)
 {
-    double x_center = point_x_coord(center),
-           y_center = point_y_coord(center);
+    const int *offsets = world_offsets.data;
+    int last = world_offsets.size - 2,
+        lo = 0,
+        hi = last;
 
+    // Object that holds first point: last one that starts at or before it
+    while ( lo < hi )
+    {
+        int mid = (lo + hi + 1) / 2;
+        if ( offsets[mid] <= begin ) lo = mid;
+        else hi = mid - 1;
+    }
 
-    cairo_t *cr;
-    cr = cairo_create(surface);
-    draw_brush(area, cr, (double) (round(x_center) + round(x_calc)), (double) (round(y_center) + round(y_calc)), color_get_colors(point_color(center)));
-    draw_brush(area, cr, (double) (round(x_center) - round(x_calc)), (double) (round(y_center) + round(y_calc)), color_get_colors(point_color(center)));
-    draw_brush(area, cr, (double) (round(x_center) + round(x_calc)), (double) (round(y_center) - round(y_calc)), color_get_colors(point_color(center)));
-    draw_brush(area, cr, (double) (round(x_center) - round(x_calc)), (double) (round(y_center) - round(y_calc)), color_get_colors(point_color(center)));
-
-    draw_brush(area, cr, (double) (round(x_center) + round(y_calc)), (double) (round(y_center) + round(x_calc)), color_get_colors(point_color(center)));
-    draw_brush(area, cr, (double) (round(x_center) - round(y_calc)), (double) (round(y_center) + round(x_calc)), color_get_colors(point_color(center)));
-    draw_brush(area, cr, (double) (round(x_center) + round(y_calc)), (double) (round(y_center) - round(x_calc)), color_get_colors(point_color(center)));
-    draw_brush(area, cr, (double) (round(x_center) - round(y_calc)), (double) (round(y_center) - round(x_calc)), color_get_colors(point_color(center)));
+    for ( int k = lo; k <= last && offsets[k] < end; k++ )
+    {
+        const point_tt *points;
+        const struct affine *m;
+        struct affine tmp;
+        handle_tt h = world_object(k);
+        int from = ( begin > offsets[k] ) ? begin - offsets[k] : 0,
+            to = (( end < offsets[k + 1] ) ? end : offsets[k + 1]) - offsets[k];
+
+        object_geometry(h, &points, &m);
+        world_write(object_matrix(h, m, &tmp), points, from, to);
+    }
+}
 
-    cairo_destroy(cr);
+/**
+ * @brief Computes world coordinates of every point taken by a Line, Polygon or Circumference, if Objects were added or transformed
+ * (or points moved) since last time. Points of all Objects are split in chunks of POINTS_PER_JOB among scheduler's threads,
+ * no matter how they are spread among Objects. Each point is written by a single job, so results do not depend on the number of threads.
+ * Objects in groups go through their groups' world matrices too, which are computed first (see scene_graph_resolve).
+*/
+static void materialize_world(void)
+{
+    // Groups' world matrices are read by jobs (and by clipping's ones)
+    scene_graph_resolve(scene);
+    if ( world_is_valid() ) return;
+
+    int num_objects = arr_lines.size + arr_polygons.size + arr_circumferences.size;
+    int before = world_offsets.capacity;
+
+    vector_clear(&world_offsets);
+    vector_reserve(&world_offsets, num_objects + 1);
+    int total = 0;
+    vector_push(&world_offsets, total);
+    for ( int i = 0; i < arr_lines.size; i++ ) vector_push(&world_offsets, total += 2);
+    for ( int i = 0; i < arr_polygons.size; i++ ) vector_push(&world_offsets, total += polygon_num_points(object_get(&arr_polygons, i)));
+    for ( int i = 0; i < arr_circumferences.size; i++ ) vector_push(&world_offsets, total += 2);
+
+    memstat_resize(MEMSTAT_POINTS, sizeof(int) * before, sizeof(int) * world_offsets.capacity);
+    world_reserve();
+
+    scheduler_parallel_for(scheduler, total, POINTS_PER_JOB, materialize_job, NULL);
+    world_stale = 0;
+    world_epoch = point_epoch();
 }
 
 /**
- * @brief Uses the idea of Bresenham's circumference algorithm to identify all points.
+ * @brief Returns a point's coordinates in world. Points of Lines, Polygons and Circumferences are read from world coordinates (see materialize_world()),
+ * any other one (free, Clip's and clipped points) is never transformed.
  * 
- * @param area Area to draw points.
- * @param c    Given circumference to draw.
+ * @param p Given point.
+ * @param x Output: X coordinate.
+ * @param y Output: Y coordinate.
 */
-void calculate_circumference_points(GtkWidget *area,
-                                    struct circumference *c)
+static void world_point(point_tt  p,
+                        double   *x,
+                        double   *y)
 {
-    int x = 0,
-        y = 0, 
-        p = 0,
-        r = 0;
-
-    r = circumference_radius(c);
-    y = r;
-    p = 3 - 2 * r;
-
-    struct point *center = circumference_get_points(c)[0];
-
-    plot_circle_points(area, center, x, y);
+    int i = point_index(p);
 
-    while ( x < y )
+    if ( (point_flags(p) & WORLD_MASK) == WORLD_SELECT )
     {
-        if ( p < 0 )
-        {
-            p = p + 4 * x + 6;
-        } else 
-        {
-            p = p + 4 * (x-y) + 10;
-            y--;
-        }
-        x++;
-        plot_circle_points(area, center, x, y);    
+        *x = world_x.data[i];
+        *y = world_y.data[i];
+    }
+    else
+    {
+        *x = point_x_coord(p);
+        *y = point_y_coord(p);
     }
 }
 
 /**
- * @brief Creates and draws Circumferences with Bresenham's circumference algorithm.
- * 
- * @param area Drawing Area.
+ * @brief Writes world coordinates of a new Object's points, so they need not be computed again for all Objects. New Objects are
+ * not transformed yet, so they are their points' coordinates. If world coordinates are stale anyway, nothing is done.
  * 
- * @returns True if code was correctly executed, False otherwise.
+ * @param kind   OBJECT_LINE, OBJECT_POLYGON, OBJECT_CIRCUMFERENCE or OBJECT_CLIP.
+ * @param object Given object.
 */
-Bool Circumference(GtkWidget *area)
+static void world_add(int   kind,
+                      void *object)
 {
+    const point_tt *points = NULL;
+    int n = 0;
 
-    int controller = number_taken_points(),
-        size_p = array_get_curr_num(arr_points);
+    if ( !world_is_valid() ) return;
 
-
-    if ( (size_p - controller) < 2 ) 
+    switch ( kind )
     {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: There must be atleast 2 free points to draw a Circumference.");
-        return False;
+        case OBJECT_LINE:
+            points = line_get_points(object);
+            n = 2;
+            break;
+        case OBJECT_POLYGON:
+            points = polygon_get_points(object);
+            n = polygon_num_points(object);
+            break;
+        case OBJECT_CIRCUMFERENCE:
+            points = circumference_get_points(object);
+            n = 2;
+            break;
+        default:
+            return;
     }
 
-    while( controller < size_p )
+    world_reserve();
+    for ( int i = 0; i < n; i++ )
     {
-        /**
-         * Must have atleast 2 points to draw a line,
-         * If there is only one, "ignore it".
-         */
-        if ( (size_p - controller) >= 2 )
-        {  
-            struct point *pCenter = array_get(arr_points, controller);
-            struct point *pBorder = array_get(arr_points, controller + 1);
-
-            if ( point_is_taken(pCenter) ) continue;
-
-            struct circumference *new_circumference = circumference_create(pCenter, pBorder);
-            array_set(arr_circumferences, array_get_curr_num(arr_circumferences), new_circumference);
-            point_take(pCenter);
-            point_take(pBorder);
-
-            calculate_circumference_points(area, new_circumference);
-            controller++;
-        } 
-        controller++;
+        int p = point_index(points[i]);
+        world_x.data[p] = point_x_coord(points[i]);
+        world_y.data[p] = point_y_coord(points[i]);
     }
-    return True;
-    
 }
 
 /**
- * @brief Creates and draws Polygons with previously specified Drawing Algorithm.
+ * @brief Grows a box so it holds another one.
  * 
- * @param area Drawing Area.
+ * @param box   Given box (xmin, ymin, xmax, ymax). Output: grown box.
+ * @param other Other box.
+*/
+static void box_union(double       *box,
+                      const double *other)
+{
+    box[0] = fmin(box[0], other[0]);
+    box[1] = fmin(box[1], other[1]);
+    box[2] = fmax(box[2], other[2]);
+    box[3] = fmax(box[3], other[3]);
+}
+
+/**
+ * @brief Computes the world box of an Object's original points (not clipped ones). Boxes are cached by Objects, in their groups' coordinates,
+ * so an Object in a group only maps its cached box through group's world matrix: a transformed group never reads its Objects' points
+ * (but a Circumference's two, its radius is only known in world, see circumference_map).
  * 
- * @returns True if code was correctly executed, False otherwise.
+ * @param h   Object's handle (Line, Polygon, Circumference or Clip).
+ * @param box Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
 */
-Bool Polygon(GtkWidget *area)
+static void object_box(handle_tt  h,
+                       double    *box)
 {
-    // If no algorithm selected, "Error".
-    if ( algh == 0 )
+    void *object = handle_get(objects, h);
+
+    switch ( handle_kind(objects, h) )
     {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide the drawing algorithm.");
-        return False;
+        case OBJECT_LINE:
+            line_get_box(object, box);
+            break;
+        case OBJECT_POLYGON:
+            polygon_get_box(object, box);
+            break;
+        case OBJECT_CIRCUMFERENCE:
+            circumference_get_box(object, box);
+            break;
+        case OBJECT_CLIP:
+            point_get_box(clip_get_points(object), NUM_CLIP_POINTS, box);
+            return;
     }
-    int controller = number_taken_points(),
-        size_p = array_get_curr_num(arr_points),
-        iterator = 0;
-
-    struct point **points = (point_tt*) malloc(sizeof(point_tt) * (size_p - controller));
-    if ( (size_p - controller) >= 3 )
-    { 
-        // Adding all left points into polygon's structure.
-        while ( controller < size_p ) 
-        {
-            point_tt p = array_get(arr_points, controller++);
-            point_take(p);
-            points[iterator++] = p;
-        }
 
-        struct polygon *polygon = polygon_create(points, iterator, algh);
+    handle_tt g = scene_graph_parent(scene, h);
+    if ( g == HANDLE_NONE ) return;
+    if ( handle_kind(objects, h) == OBJECT_CIRCUMFERENCE )
+    {
+        // Drawn radius is the distance between its points in world: a non-uniform scale may make it wider than its mapped box
+        struct affine tmp;
+        double x, y,
+               r = circumference_map(object, object_matrix(h, circumference_get_matrix(object), &tmp), &x, &y);
+        box[0] = x - r;
+        box[1] = y - r;
+        box[2] = x + r;
+        box[3] = y + r;
+        return;
+    }
+    affine_apply_box(scene_graph_world(scene, g), box, box);
+}
 
-        array_set(arr_polygons, array_get_curr_num(arr_polygons), polygon);
+/**
+ * @brief Computes the box of an Object: all its points, clipped ones included. A group's box holds every Object under it.
+ *
+ * @param h   Object's handle (Line, Polygon, Circumference, Clip or group).
+ * @param box Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+*/
+static void object_bounds(handle_tt  h,
+                          double    *box)
+{
+    double clipped[4] = { INFINITY, INFINITY, -INFINITY, -INFINITY };
+    void *object = handle_get(objects, h);
 
-        for ( int i = 0; i < iterator - 1; i++ )
+    switch ( handle_kind(objects, h) )
+    {
+        case OBJECT_LINE:
+            if ( line_was_clipped(object) == 1 ) point_get_box(line_get_clipped_points(object), 2, clipped);
+            break;
+        case OBJECT_POLYGON:
+            if ( polygon_was_clipped(object) == 1 ) point_get_box(polygon_get_clipped_points(object), polygon_num_clipped_points(object), clipped);
+            break;
+        case OBJECT_GROUP:
         {
-            struct point *pInit = points[i];
-            struct point *pFinal = points[i + 1];
-
-            if ( algh == 1 ) DDA(pInit, pFinal, area);
-            else if ( algh == 2 ) Bresenham(pInit, pFinal, area);
+            const handle_list_tt *children = scene_graph_children(scene, h);
+            for ( int i = 0; i < children->size; i++ )
+            {
+                object_bounds(children->data[i], box);
+                box_union(clipped, box);
+            }
+            for ( int i = 0; i < 4; i++ ) box[i] = clipped[i];
+            return;
         }
-        // Closing Polygon
-        struct point *pInit = points[iterator - 1];
-        struct point *pFinal = points[0];
+    }
+
+    object_box(h, box);
+    box_union(box, clipped);
+}
+
+/**
+ * @brief Adds an Object to the scene: it gets a handle, which is appended to a list (arr_lines, arr_polygons...), and its box is indexed in grid (and in bvh, if it can be clipped).
+ *
+ * @param list   Given list.
+ * @param kind   OBJECT_LINE, OBJECT_POLYGON, OBJECT_CIRCUMFERENCE or OBJECT_CLIP.
+ * @param object Given object.
+ *
+ * @returns Handle of object.
+*/
+static handle_tt object_add(handle_list_tt *list,
+                            int             kind,
+                            void           *object)
+{
+    handle_tt h = handle_alloc(objects, kind, object);
+    double box[4];
+
+    vector_push(list, h);
+    world_add(kind, object);
+    object_bounds(h, box);
+    grid_insert(grid, h, box);
+    if ( kind == OBJECT_LINE || kind == OBJECT_POLYGON ) bvh_add(bvh, h, box);
+    return h;
+}
+
+/**
+ * @brief Refreshes the box of every Object of a list in grid and bvh, after points were moved (transformations).
+ * Objects whose cells did not change are left as they are, bvh's nodes are only fixed by bvh_refit.
+ *
+ * @param list Given list (of Lines, Polygons and Circumferences).
+*/
+static void index_objects(const handle_list_tt *list)
+{
+    double box[4];
+
+    for ( int i = 0; i < list->size; i++ )
+    {
+        object_bounds(vector_get(list, i), box);
+        grid_update(grid, vector_get(list, i), box);
+        bvh_update(bvh, vector_get(list, i), box);
+    }
+}
+
+/**
+ * @brief Returns the list that holds Objects of a kind.
+ * 
+ * @param kind OBJECT_LINE, OBJECT_POLYGON, OBJECT_CIRCUMFERENCE or OBJECT_CLIP.
+ * 
+ * @returns arr_lines, arr_polygons, arr_circumferences or arr_clips.
+*/
+static handle_list_tt *object_list(int kind)
+{
+    switch ( kind )
+    {
+        case OBJECT_LINE:
+            return &arr_lines;
+        case OBJECT_POLYGON:
+            return &arr_polygons;
+        case OBJECT_CIRCUMFERENCE:
+            return &arr_circumferences;
+    }
+    return &arr_clips;
+}
+
+/**
+ * @brief Puts a free point (not taken by any Object) in the free points' grid.
+ * 
+ * @param p Given point.
+*/
+static void free_point_add(point_tt p)
+{
+    double box[4] = { point_x_coord(p), point_y_coord(p), point_x_coord(p), point_y_coord(p) };
+
+    grid_insert(free_points, p, box);
+}
+
+/**
+ * @brief Takes a point for an Object (marks it POINT_TAKEN, and other flags), taking it out of the free points' grid if it was free.
+ * 
+ * @param p     Given point.
+ * @param flags Other POINT_* flags (e.g. POINT_CLIP).
+*/
+static void free_point_take(point_tt      p,
+                            unsigned char flags)
+{
+    if ( ( point_flags(p) & (POINT_ALIVE | POINT_TAKEN) ) == POINT_ALIVE ) grid_remove(free_points, p);
+    point_mark(p, POINT_TAKEN | flags);
+}
+
+/**
+ * @brief Takes an Object (Line, Polygon or Circumference) out of the scene, undoing its creation: it leaves its list, grid and bvh, and its points
+ * are free again. It must be the last one of its list (commands are undone in reverse order). Its handle and memory are kept, so it can be put back.
+ * 
+ * @param h Object's handle.
+*/
+static void object_remove(handle_tt h)
+{
+    handle_list_tt *list = object_list(handle_kind(objects, h));
+    const point_tt *points;
+    const struct affine *m;
+    int n = object_geometry(h, &points, &m);
+
+    /* Sanity Check. */
+    assert( list->size > 0 && list->data[list->size - 1] == h );
+
+    list->size--;
+    for ( int i = 0; i < n; i++ )
+    {
+        point_unmark(points[i], POINT_TAKEN);
+        free_point_add(points[i]);
+    }
+    grid_remove(grid, h);
+    bvh_remove(bvh, h);
+}
+
+/**
+ * @brief Puts back an Object taken out by object_remove (redoing its creation): it takes its points again, and its world coordinates
+ * and box are computed with its current matrix.
+ * 
+ * @param h Object's handle.
+*/
+static void object_restore(handle_tt h)
+{
+    int kind = handle_kind(objects, h);
+    const point_tt *points;
+    const struct affine *m;
+    struct affine tmp;
+    double box[4];
+    int n = object_geometry(h, &points, &m);
+
+    vector_push(object_list(kind), h);
+    for ( int i = 0; i < n; i++ ) free_point_take(points[i], 0);
+    if ( world_is_valid() )
+    {
+        world_reserve();
+        world_write(object_matrix(h, m, &tmp), points, 0, n);
+    }
+    object_bounds(h, box);
+    grid_insert(grid, h, box);
+    if ( kind == OBJECT_LINE || kind == OBJECT_POLYGON ) bvh_add(bvh, h, box);
+}
+
+/**
+ * @brief Releases handles that only commands [from, to) of "history" still hold, before they are dropped: Objects whose creation was undone,
+ * groups whose grouping was undone, and groups that were ungrouped (kept so ungrouping could be undone).
+ * 
+ * @param from First command.
+ * @param to   One past last command.
+*/
+static void history_release(int from,
+                            int to)
+{
+    struct command c;
+    int position = command_log_position(history);
+
+    for ( int i = from; i < to; i++ )
+    {
+        command_log_get(history, i, &c);
+        if ( i >= position && c.type == COMMAND_CREATE )
+            for ( int j = 0; j < c.num_handles; j++ ) handle_release(objects, c.handles[j]);
+        else if ( i >= position && c.type == COMMAND_GROUP ) handle_release(objects, c.handles[0]);
+        else if ( i < position && c.type == COMMAND_UNGROUP )
+            for ( int j = 0; j < c.num_handles; j++ )
+                if ( j == 0 || c.handles[j - 1] == HANDLE_NONE ) handle_release(objects, c.handles[j]);
+    }
+}
+
+/**
+ * @brief Starts recording a command in "history" (see command_log_begin). Commands undone are dropped, so their handles are released first.
+ * 
+ * @param type COMMAND_*.
+*/
+static void history_begin(int type)
+{
+    history_release(command_log_position(history), command_log_size(history));
+    command_log_begin(history, type);
+}
+
+/**
+ * @brief Empties "history": what was done so far cannot be undone anymore (e.g. clipping, which creates points from every Object's position).
+*/
+static void history_reset(void)
+{
+    history_release(0, command_log_size(history));
+    command_log_clear(history);
+}
+
+/**
+ * @brief Records the creation of Objects: the last ones of a list, from a position on.
+ * 
+ * @param list Given list.
+ * @param from First Object created.
+*/
+static void history_created(const handle_list_tt *list,
+                            int                   from)
+{
+    if ( from == list->size ) return;
+    history_begin(COMMAND_CREATE);
+    memcpy(command_log_add_handles(history, list->size - from), &list->data[from], sizeof(handle_tt) * (list->size - from));
+}
+
+void redraw_objects(GtkWidget *area);
+static void redraw_region(GtkWidget *area, const double *damage);
+static void animation_finish(void);
+
+/**
+ * @brief Stops current animation, if any, where it is: nothing is applied nor recorded (e.g. canvas is being cleaned).
+*/
+static void animation_stop(void)
+{
+    if ( animation.tick ) gtk_widget_remove_tick_callback(Widgets.drawing_area, animation.tick);
+    animation.tick = 0;
+    vector_clear(&animation.roots);
+}
+
+/**
+ * @brief Removes all points drawn in canvas.
+*/
+static void clear_surface(int flag)
+{
+    gtk_label_set_label(GTK_LABEL(Widgets.label), "Debug informations here...");
+
+    if ( flag ) 
+    {
+        animation_stop();
+        // Removing all points and objects. Arena, point store, handle table and lists keep their memory, so cleaning does not allocate.
+        arena_reset(arena);
+        memstat_release_all(MEMSTAT_LINES);
+        memstat_release_all(MEMSTAT_POLYGONS);
+        memstat_release_all(MEMSTAT_CIRCUMFERENCES);
+        memstat_release_all(MEMSTAT_CLIPS);
+        point_clear();
+        handle_table_clear(objects);
+        vector_clear(&arr_lines);
+        vector_clear(&arr_polygons);
+        vector_clear(&arr_circumferences);
+        vector_clear(&arr_clips);
+        grid_clear(grid);
+        grid_clear(free_points);
+        bvh_clear(bvh);
+        scene_graph_clear(scene);
+        command_log_clear(history);
+        vector_clear(&selection);
+        world_stale = 1;
+    }
+}
+
+/**
+ * @brief Whenever screen is resized, remove current points to prevent a bug in visualization.
+ * 
+ * @param widget Drawing area that contains the drawn points
+*/
+static void resize_cb(GtkWidget *widget,
+                      int        width,
+                      int        height,
+                      gpointer   data)
+{
+    if ( renderer ) renderer_resize(renderer, gtk_widget_get_width(widget), gtk_widget_get_height(widget));
+
+    if ( labels ) label_layout_destroy(labels);
+    labels = label_layout_create(gtk_widget_get_width(widget), gtk_widget_get_height(widget), LABEL_MAX_LABELS);
+
+    clear_surface(1);
+    redraw_objects(widget);
+}
+
+/**
+ * @brief (CALL_BACK) Function that is linked with Drawing Area that lets you draw in drawing_area. Presents the last buffer rasterized by renderer.
+ * 
+ * @param cairo Object used to draw points
+*/
+static void draw_cb(GtkDrawingArea *drawing_area,
+                    cairo_t        *cr,
+                    int             width, 
+                    int             height, 
+                    gpointer        data)
+{
+    if ( renderer ) renderer_present(renderer, cr);
+}
+
+/**
+ * @brief Records a point in a display list: a rectangle with thickness of 6 and, if label layout accepts it, the position of x and y.
+ * 
+ * @param dl   Display list.
+ * @param p    Given point.
+ * @param kind Kind of label (LABEL_VERTEX, LABEL_POINT or LABEL_CLIPPED).
+*/
+static void display_point(display_list_tt dl,
+                          point_tt        p,
+                          int             kind)
+{
+    char   text[RASTER_LABEL_SIZE];
+    double x, y;
+    world_point(p, &x, &y);
+
+    double text_x = (x + display_list_center_x(dl)) - 34,
+           text_y = (display_list_center_y(dl) - y) + 15;
+
+    display_list_add_brush(dl, x, y, point_color(p));
+
+    int length = raster_label_text(text, x, y);
+    if ( labels && !label_layout_place(labels, text_x, text_y - LABEL_HEIGHT, length * LABEL_CHAR_WIDTH, LABEL_HEIGHT, kind) ) return;
+    display_list_add_label(dl, x, y);
+}
+
+/**
+ * @brief (CALL_BACK) Function called whenever user clicks into canvas
+ * 
+ * @param x    X coordinate in canvas.
+ * @param y    Y coordinate in canvas.
+ * @param area Drawing area that point will be added
+*/
+static void draw(GtkGestureDrag *gesture,
+                 double          x,
+                 double          y,
+                 GtkWidget      *area)
+{
+    // Redefining center point to be exactly the center of canvas. In canvas 0,0 is in the top-left corner.
+    int center_x = 0,
+        center_y = 0; 
+    gtk_widget_get_size_request(Widgets.drawing_area, &center_x, &center_y);
+    x = x - (double)(center_x / 2);
+    y = (double)(center_y / 2) - y;
+    // Selecting: see select_end
+    if ( mode == MODE_SELECT ) return;
+    point_tt p = point_create(x, y);
+
+    point_define_color(p, 0.0, 0.0, 0.0);
+    free_point_add(p);
+
+    redraw_objects(area);
+}
+
+/**
+ * @brief Computes the box that holds some Objects (or groups).
+ * 
+ * @param handles Given handles.
+ * @param n       Number of handles.
+ * @param box     Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax. Empty (inverted) if there are none.
+*/
+static void roots_bounds(const handle_tt *handles,
+                         int              n,
+                         double          *box)
+{
+    double other[4];
+
+    box[0] = box[1] = INFINITY;
+    box[2] = box[3] = -INFINITY;
+    for ( int i = 0; i < n; i++ )
+    {
+        object_bounds(handles[i], other);
+        box_union(box, other);
+    }
+}
+
+/**
+ * @brief Computes the box that holds every selected Object.
+ * 
+ * @param box Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax. Empty (inverted) if nothing is selected.
+*/
+static void selection_bounds(double *box)
+{
+    roots_bounds(selection.data, selection.size, box);
+}
+
+/**
+ * @brief Orders handles (qsort), so repeated ones end up together.
+*/
+static int handle_compare(const void *a,
+                          const void *b)
+{
+    handle_tt x = *(const handle_tt*) a,
+              y = *(const handle_tt*) b;
+
+    return ( x > y ) - ( x < y );
+}
+
+/**
+ * @brief Selects Objects (Lines, Polygons, Circumferences, never Clips) through the spatial grid, so only Objects near rect are tested,
+ * no matter how many exist. An Object in a group selects its outermost group instead (see scene_graph_root), which is selected once.
+ * Previous selection is replaced (nothing found clears it).
+ * 
+ * @param rect  Area (xmin, ymin, xmax, ymax).
+ * @param click If Objects whose box touches rect are selected (a click), instead of those whose box is inside it (a dragged rectangle).
+ * A group is only selected by a rectangle if all of it is inside.
+*/
+static void select_objects(const double *rect,
+                           int           click)
+{
+    double box[4];
+    handle_tt last = HANDLE_NONE;
+    int n = 0;
+
+    vector_clear(&selection);
+    vector_clear(&candidates);
+    grid_query(grid, rect, &candidates);
+    for ( int i = 0; i < candidates.size; i++ )
+    {
+        handle_tt h = candidates.data[i];
+
+        if ( handle_kind(objects, h) == OBJECT_CLIP ) continue;
+        object_bounds(h, box);
+        if ( click && (box[0] > rect[2] || box[2] < rect[0] || box[1] > rect[3] || box[3] < rect[1]) ) continue;
+        if ( !click && (box[0] < rect[0] || box[2] > rect[2] || box[1] < rect[1] || box[3] > rect[3]) ) continue;
+        vector_push(&selection, scene_graph_root(scene, h));
+    }
+
+    // Groups show up once per Object found
+    qsort(selection.data, selection.size, sizeof(handle_tt), handle_compare);
+    for ( int i = 0; i < selection.size; i++ )
+    {
+        handle_tt h = selection.data[i];
+
+        if ( h == last ) continue;
+        last = h;
+        if ( !click && handle_kind(objects, h) == OBJECT_GROUP )
+        {
+            object_bounds(h, box);
+            if ( box[0] < rect[0] || box[2] > rect[2] || box[1] < rect[1] || box[3] > rect[3] ) continue;
+        }
+        selection.data[n++] = h;
+    }
+    selection.size = n;
+}
+
+/**
+ * @brief CallBack function called whenever User releases left-click in Drawing Area. When selecting (see "mode_selection"), selects the Object clicked,
+ * or every Object inside the dragged rectangle, then redraws only the area of old and new selection (their boxes are highlighted).
+ * 
+ * @param gesture  Drag gesture.
+ * @param offset_x Drag's X offset (in pixels).
+ * @param offset_y Drag's Y offset (in pixels).
+ * @param area     Drawing area.
+*/
+static void select_end(GtkGestureDrag *gesture,
+                       double          offset_x,
+                       double          offset_y,
+                       GtkWidget      *area)
+{
+    double x,
+           y,
+           rect[4],
+           damage[4];
+    char result[100];
+
+    if ( mode != MODE_SELECT ) return;
+
+    // Same coordinates used by points: 0,0 at canvas' center and Y growing upwards
+    int center_x = 0,
+        center_y = 0; 
+    gtk_widget_get_size_request(Widgets.drawing_area, &center_x, &center_y);
+    gtk_gesture_drag_get_start_point(gesture, &x, &y);
+    x = x - (double)(center_x / 2);
+    y = (double)(center_y / 2) - y;
+
+    if ( fabs(offset_x) <= SELECT_TOLERANCE && fabs(offset_y) <= SELECT_TOLERANCE )
+    {
+        rect[0] = x - SELECT_TOLERANCE;
+        rect[1] = y - SELECT_TOLERANCE;
+        rect[2] = x + SELECT_TOLERANCE;
+        rect[3] = y + SELECT_TOLERANCE;
+    } else
+    {
+        rect[0] = fmin(x, x + offset_x);
+        rect[1] = fmin(y, y - offset_y);
+        rect[2] = fmax(x, x + offset_x);
+        rect[3] = fmax(y, y - offset_y);
+    }
+
+    selection_bounds(damage);
+    select_objects(rect, fabs(offset_x) <= SELECT_TOLERANCE && fabs(offset_y) <= SELECT_TOLERANCE);
+    selection_bounds(rect);
+    box_union(damage, rect);
+
+    if ( damage[0] <= damage[2] ) redraw_region(area, damage);
+    snprintf(result, sizeof(result), "Selected: %d Object(s).", selection.size);
+    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+}
+
+/**
+ * @brief (CALL_BACK) Function called whenever user wants to clear canvas
+ * 
+ * @param area Drawing area that will be cleaned
+*/
+static void clean(GtkGestureClick *gesture,
+                  int              n_press,
+                  double           x, 
+                  double           y,
+                  GtkWidget        *area)
+{
+    clear_surface(1);
+    redraw_objects(area);
+}
+
+/**
+ * @brief (CALL_BACK) Function called whenever user closes main window
+*/
+static void close_window(void)
+{
+    point_clear();
+    vector_free(&arr_lines);
+    vector_free(&arr_polygons);
+    vector_free(&arr_circumferences);
+    vector_free(&arr_clips);
+    vector_free(&candidates);
+    vector_free(&accepted);
+    vector_free(&selection);
+    vector_free(&leaves);
+    vector_free(&roots);
+    animation_stop();
+    vector_free(&animation.steps);
+    vector_free(&animation.roots);
+    vector_free(&animation.states);
+    vector_free(&animation.deltas);
+    affine_chain_destroy(animation.chain);
+    memstat_resize(MEMSTAT_POINTS, sizeof(double) * 2 * world_x.capacity, 0);
+    memstat_resize(MEMSTAT_POINTS, sizeof(int) * world_offsets.capacity, 0);
+    vector_free(&world_x);
+    vector_free(&world_y);
+    vector_free(&world_offsets);
+    grid_destroy(grid);
+    grid_destroy(free_points);
+    bvh_destroy(bvh);
+    scene_graph_destroy(scene);
+    command_log_destroy(history);
+    affine_chain_destroy(chain);
+    transform_script_destroy(script);
+    handle_table_destroy(objects);
+    arena_destroy(arena);
+    if ( labels ) label_layout_destroy(labels);
+    if ( renderer ) renderer_destroy(renderer);
+    renderer = NULL;
+    if ( scheduler ) scheduler_destroy(scheduler);
+    scheduler = NULL;
+}
+
+
+/**
+ * @brief (CALL_BACK) Function called whenever an option in "Algorithms"drop-down is sellected.
+ * Defines which line-drawing (DDA or Bresenham) algorithm should be used to draw.
+ * 
+ * @param dropdown Dropdown selected
+ * @param entry 
+*/
+static void algorithms_execution(GtkDropDown *dropdown,
+                                 gpointer     user_data)
+{
+    algh = gtk_drop_down_get_selected(dropdown);
+}
+
+/**
+ * @brief Counts points that are not taken by any object.
+ *
+ * @returns Number of free points.
+*/
+int number_free_points()
+{
+    return grid_size(free_points);
+}
+
+/**
+ * @brief Finds the next point that is not taken by any object, in point store's order.
+ * Slots of destroyed points are reused, so free points are not always the last ones of the store.
+ *
+ * @param from Slot where search starts. Updated to the slot after the point found.
+ *
+ * @returns A free point, or POINT_NONE if there is none.
+*/
+static point_tt next_free_point(int *from)
+{
+    while ( *from < point_count() )
+    {
+        point_tt p = point_at((*from)++);
+        if ( ( point_flags(p) & (POINT_ALIVE | POINT_TAKEN) ) == POINT_ALIVE ) return p;
+    }
+
+    return POINT_NONE;
+}
+
+/**
+ * @brief Creates and draws Circumferences with Bresenham's circumference algorithm.
+ * 
+ * @param area Drawing Area.
+ * 
+ * @returns True if code was correctly executed, False otherwise.
+*/
+Bool Circumference(GtkWidget *area)
+{
+    int num_free = number_free_points(),
+        from = 0,
+        before = arr_circumferences.size;
+
+    if ( num_free < 2 ) 
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: There must be atleast 2 free points to draw a Circumference.");
+        return False;
+    }
+
+    /**
+     * Free points are paired in store's order,
+     * If there is one left, "ignore it".
+     */
+    for ( int i = 0; i + 1 < num_free; i += 2 )
+    {
+        point_tt pCenter = next_free_point(&from),
+                 pBorder = next_free_point(&from);
+
+        struct circumference *new_circumference = circumference_create(arena, pCenter, pBorder);
+        object_add(&arr_circumferences, OBJECT_CIRCUMFERENCE, new_circumference);
+        free_point_take(pCenter, 0);
+        free_point_take(pBorder, 0);
+    }
+    history_created(&arr_circumferences, before);
+    redraw_objects(area);
+    return True;
+}
+
+/**
+ * @brief Creates and draws Polygons with previously specified Drawing Algorithm.
+ * 
+ * @param area Drawing Area.
+ * 
+ * @returns True if code was correctly executed, False otherwise.
+*/
+Bool Polygon(GtkWidget *area)
+{
+    // If no algorithm selected, "Error".
+    if ( algh == 0 )
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide the drawing algorithm.");
+        return False;
+    }
+    int num_free = number_free_points(),
+        from = 0;
+
+    if ( num_free >= 3 )
+    { 
+        // Adding all left points into polygon's structure.
+        point_tt *points = (point_tt*) temp_alloc(sizeof(point_tt) * num_free);
+        for ( int i = 0; i < num_free; i++ )
+        {
+            points[i] = next_free_point(&from);
+            free_point_take(points[i], 0);
+        }
+
+        struct polygon *polygon = polygon_create(arena, points, num_free, algh);
+
+        object_add(&arr_polygons, OBJECT_POLYGON, polygon);
+        history_created(&arr_polygons, arr_polygons.size - 1);
+        temp_free(points, sizeof(point_tt) * num_free);
+        redraw_objects(area);
+
+    }else
+    {   
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: There must be atleast 3 free points to draw a Polygon.");
+        return False;
+    }
+
+    return True;
+}
+
+/**
+ * @brief Creates and draws Lines with previously specified Drawing Algorithm.
+ * 
+ * @param area Drawing Area.
+ * 
+ * @returns True if code was correctly executed, False otherwise.
+*/
+Bool Line(GtkWidget *area)
+{
+    // If no algorithm selected, "Error".
+    if ( algh == 0 )
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide the drawing algorithm.");
+        return False;
+    }
+
+    int num_free = number_free_points(),
+        from = 0,
+        before = arr_lines.size;
+
+    if ( num_free < 2 ) 
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: There must be atleast 2 free points to draw a Line.");
+        return False;
+    }
+
+    /**
+     * Free points are paired in store's order,
+     * If there is one left, "ignore it".
+     */
+    for ( int i = 0; i + 1 < num_free; i += 2 )
+    {
+        point_tt pInit = next_free_point(&from),
+                 pFinal = next_free_point(&from);
+
+        struct line *new_line = line_create(arena, pInit, pFinal, algh);
+        object_add(&arr_lines, OBJECT_LINE, new_line);
+        free_point_take(pInit, 0);
+        free_point_take(pFinal, 0);
+    }
+    history_created(&arr_lines, before);
+    redraw_objects(area);
+    return True;
+}
+
+/**
+ * @brief Retrieves the elapsed time by a function and prints it in "label".
+ * 
+ * @param t Elapsed time
+*/
+void write_execution_time(double t)
+{
+    char template[100],
+         result[100];
+
+
+    sprintf(template, "%f", (((double)t)/CLOCKS_PER_SEC)*100);
+    strcpy(result, "Time Elapsed: ");
+    strcat(result, template);
+    strcat(result, "ms.\0");
+    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+}
+
+/**
+ * @brief Records a Line (its points and the line between them) in a display list. If it was clipped, its clipped points are recorded instead.
+ * 
+ * @param dl   Display list.
+ * @param line Given line.
+*/
+static void display_line(display_list_tt  dl,
+                         struct line     *line)
+{
+    const point_tt *points;
+
+    if ( line_was_clipped(line) == 0 ) 
+    {
+        points = line_get_points(line);
+    }
+    else if ( line_was_clipped(line) == 1 )
+    {
+        points = line_get_clipped_points(line);
+    }
+    // Implementation decision. Whenever one of polygon's side is not IN the clip area, don't draw the polygon at all
+    else return;
+
+    // Redrawing points
+    for ( int j = 0; j < 2; j++ )
+        display_point(dl, points[j], line_was_clipped(line) ? LABEL_CLIPPED : LABEL_VERTEX);
+
+    // Redrawing lines between points
+    double x0, y0, x1, y1;
+    world_point(points[0], &x0, &y0);
+    world_point(points[1], &x1, &y1);
+    display_list_add_line(dl, x0, y0, x1, y1, line_get_algh(line), point_color(points[0]));
+}
+
+/**
+ * @brief Records a Polygon (its points and the lines between them) in a display list. If it was clipped, its clipped points are recorded instead.
+ * 
+ * @param dl Display list.
+ * @param pl Given polygon.
+*/
+static void display_polygon(display_list_tt  dl,
+                            struct polygon  *pl)
+{
+    const point_tt *p_points;
+    int n = 0;
+
+    if ( polygon_was_clipped(pl) == 0 ) 
+    {
+        p_points = polygon_get_points(pl);
+        n = polygon_num_points(pl);
+    }
+    else if ( polygon_was_clipped(pl) == 1 )
+    {
+        p_points = polygon_get_clipped_points(pl);
+        n = polygon_num_clipped_points(pl);
+    } 
+    else return;
+
+    // Redrawing points
+    for ( int j = 0; j < n; j++ )
+        display_point(dl, p_points[j], polygon_was_clipped(pl) ? LABEL_CLIPPED : LABEL_VERTEX);
+
+    // Redrawing lines between points, last one closes the Polygon
+    for ( int j = 0; j < n; j++ )
+    {
+        point_tt pInit = p_points[j],
+                 pFinal = p_points[(j + 1) % n];
+        double x0, y0, x1, y1;
+
+        world_point(pInit, &x0, &y0);
+        world_point(pFinal, &x1, &y1);
+        display_list_add_line(dl, x0, y0, x1, y1, polygon_get_algh(pl), point_color(pInit));
+    }
+}
+
+/**
+ * @brief Records a Circumference (its points and the circumference itself) in a display list.
+ * 
+ * @param dl            Display list.
+ * @param circumference Given circumference.
+*/
+static void display_circumference(display_list_tt  dl,
+                                  circumference_tt circumference)
+{
+    const point_tt *points = circumference_get_points(circumference);
+    double x, y,
+           bx, by;
+
+    for ( int j = 0; j < 2; j++ )
+        display_point(dl, points[j], LABEL_VERTEX);
+
+    // Radius from both points in world, so a group's transformation (e.g. a scale) resizes it along with them
+    world_point(points[0], &x, &y);
+    world_point(points[1], &bx, &by);
+    display_list_add_circumference(dl, x, y, sqrt(pow(bx - x, 2) + pow(by - y, 2)), point_color(points[0]));
+}
+
+/**
+ * @brief Records a Clip (its points and its rectangle, always DDA) in a display list.
+ * 
+ * @param dl Display list.
+ * @param cl Given clip.
+*/
+static void display_clip(display_list_tt  dl,
+                         struct clip     *cl)
+{
+    const point_tt *p_points = clip_get_points(cl);
+
+    // Redrawing points
+    for ( int j = 0; j < NUM_CLIP_POINTS; j++ )
+        display_point(dl, p_points[j], LABEL_VERTEX);
+
+    // Redrawing lines between points (always DDA), last one closes the Clip
+    for ( int j = 0; j < NUM_CLIP_POINTS; j++ )
+    {
+        point_tt pInit = p_points[j],
+                 pFinal = p_points[(j + 1) % NUM_CLIP_POINTS];
+
+        display_list_add_line(dl, point_x_coord(pInit), point_y_coord(pInit), point_x_coord(pFinal), point_y_coord(pFinal), 1, point_color(pInit));
+    }
+}
+
+/**
+ * @brief Records the box of a selected Object in a display list, so it shows up as selected.
+ * 
+ * @param dl  Display list.
+ * @param box Object's box.
+*/
+static void display_selected(display_list_tt  dl,
+                             const double    *box)
+{
+    display_list_add_line(dl, box[0], box[1], box[2], box[1], 1, SELECT_COLOR);
+    display_list_add_line(dl, box[2], box[1], box[2], box[3], 1, SELECT_COLOR);
+    display_list_add_line(dl, box[2], box[3], box[0], box[3], 1, SELECT_COLOR);
+    display_list_add_line(dl, box[0], box[3], box[0], box[1], 1, SELECT_COLOR);
+}
+
+/**
+ * @brief Records the Objects (Points, Lines, Polygons, Circumferences, Clips) that should be drawn in an area into a display list and submits it
+ * to renderer, which rasterizes it in background. Only Objects whose box overlaps the area (found through the spatial grid) are recorded.
+ * If an area is given (e.g. where selected Objects were before and after a transformation), only it is rasterized again, over the last
+ * rasterized canvas (see display_list_set_damage), so Objects elsewhere are neither recorded nor rasterized. If renderer refuses it
+ * (an older display list was not rasterized yet), whole canvas is redrawn.
+ * 
+ * @param area   Drawing area.
+ * @param damage Area (xmin, ymin, xmax, ymax) to be redrawn, grown by VIEW_MARGIN so labels are not cut. NULL redraws whole canvas.
+*/
+static void redraw_region(GtkWidget    *area,
+                          const double *damage)
+{   
+    clear_surface(0);
+    if ( renderer == NULL ) return;
+
+    int center_x = 0,
+        center_y = 0; 
+    gtk_widget_get_size_request(Widgets.drawing_area, &center_x, &center_y);
+
+    // Objects that may show up in canvas (or in damaged area): Lines, Polygons, Circumferences and Clips
+    double view[4] = { -(center_x / 2) - VIEW_MARGIN, -(center_y / 2) - VIEW_MARGIN, (center_x / 2) + VIEW_MARGIN, (center_y / 2) + VIEW_MARGIN },
+           region[4];
+    if ( damage )
+    {
+        region[0] = fmax(damage[0] - VIEW_MARGIN, -(center_x / 2));
+        region[1] = fmax(damage[1] - VIEW_MARGIN, -(center_y / 2));
+        region[2] = fmin(damage[2] + VIEW_MARGIN, (center_x / 2));
+        region[3] = fmin(damage[3] + VIEW_MARGIN, (center_y / 2));
+        // Outside canvas, nothing to redraw
+        if ( region[0] > region[2] || region[1] > region[3] ) return;
+
+        // Objects whose labels reach the area are recorded too
+        view[0] = region[0] - VIEW_MARGIN;
+        view[1] = region[1] - VIEW_MARGIN;
+        view[2] = region[2] + VIEW_MARGIN;
+        view[3] = region[3] + VIEW_MARGIN;
+
+        // Labels outside the area stay on canvas, so layout keeps them: new labels must not overlap them, nor exceed the density cap.
+        // If level of detail changes, every label is laid out again in a whole canvas redraw.
+        double pixels[4] = { floor((center_x / 2) + region[0]), floor((center_y / 2) - region[3]), ceil((center_x / 2) + region[2]), ceil((center_y / 2) - region[1]) };
+        if ( labels && !label_layout_damage(labels, pixels, point_live_count()) )
+        {
+            redraw_region(area, NULL);
+            return;
+        }
+    }
+    // Free slots (removed points) are not drawn, so they do not count for labels' level of detail
+    else if ( labels ) label_layout_reset(labels, point_live_count());
+
+    display_list_tt dl = renderer_acquire(renderer, center_x / 2, center_y / 2);
+    if ( damage ) display_list_set_damage(dl, region);
+    materialize_world();
+    vector_clear(&candidates);
+    grid_query(grid, view, &candidates);
+    for ( int i = 0; i < candidates.size; i++ )
+    {
+        handle_tt h = candidates.data[i];
+        switch ( handle_kind(objects, h) )
+        {
+            case OBJECT_LINE:
+                display_line(dl, handle_get(objects, h));
+                break;
+            case OBJECT_POLYGON:
+                display_polygon(dl, handle_get(objects, h));
+                break;
+            case OBJECT_CIRCUMFERENCE:
+                display_circumference(dl, handle_get(objects, h));
+                break;
+            case OBJECT_CLIP:
+                display_clip(dl, handle_get(objects, h));
+                break;
+        }
+    }
+
+    // Points
+    // Drawing points that aren't part of an object and may show up in canvas (or in damaged area)
+    vector_clear(&candidates);
+    grid_query(free_points, view, &candidates);
+    for ( int i = 0; i < candidates.size; i++ ) display_point(dl, candidates.data[i], LABEL_POINT);
+
+    // Selected Objects' boxes
+    for ( int i = 0; i < selection.size; i++ )
+    {
+        double box[4];
+        object_bounds(selection.data[i], box);
+        if ( box[0] <= view[2] && box[2] >= view[0] && box[1] <= view[3] && box[3] >= view[1] ) display_selected(dl, box);
+    }
+
+    if ( !renderer_submit(renderer, dl) ) redraw_region(area, NULL);
+}
+
+/**
+ * @brief Records all Objects (Points, Lines, Polygons, Circumferences, Clips) that should be drawn into a display list and submits it to renderer,
+ * which rasterizes it in background. Only Objects whose box overlaps the canvas (found through the spatial grid) are recorded.
+ * 
+ * @param area Drawing area.
+*/
+void redraw_objects(GtkWidget *area)
+{
+    redraw_region(area, NULL);
+}
+
+/**
+ * @brief (CALL_BACK) Function called whenever an option in "Drawing"drop-down is sellected, 
+ * Defines which option of drawing (Line, Polygon or Circumfere) should be drawn.
+ * 
+ * @param dropdown Dropdown selected
+ * @param entry 
+*/
+static void drawings_execution(GtkDropDown *dropdown,
+                               GtkWidget   *area,
+                               gpointer     user_data)
+{
+    int dropdown_selected = gtk_drop_down_get_selected(dropdown);
+    clock_t t;
+    Bool cntrl = False;
+
+    if ( dropdown_selected != 0 ) animation_finish();
+    GtkWidget *drawing_area = GTK_WIDGET(user_data);
+    switch (dropdown_selected)
+    {
+        case 1:
+            t = clock();
+            cntrl = Line(drawing_area);
+            t = clock() - t;
+            if ( cntrl ) write_execution_time(t);
+            break;
+        case 2:
+            t = clock();
+            cntrl = Polygon(drawing_area);
+            t = clock() - t;
+            if ( cntrl ) write_execution_time(t);
+            break;
+        case 3:
+            t = clock();
+            cntrl = Circumference(drawing_area);
+            t = clock() - t;
+            if ( cntrl ) write_execution_time(t);
+            break;
+        default:
+            break;
+    }
+
+
+}
+
+/**
+ * @brief Reads the template of given transformation from content (Check documentation), in a single pass and without allocating
+ * (see transform_script.c). If content is invalid, writes in "label" the expected template and the column where reading failed.
+ *  
+ * @param content   Content to be analysed
+ * @param transf_id Which transformation was selected (TRANSFORM_TRANSLATION, TRANSFORM_ROTATION or TRANSFORM_SCALE)
+ * 
+ * @returns Read values: (X, Y) of Translation and Scale, angle (radians) of Rotation. They are kept by "script" until next parse.
+ * NULL if content is invalid.
+*/
+static const double *read_template(const char *content,
+                                   int         transf_id)
+{
+    char result[200];
+    int column;
+
+    if ( transform_script_parse_template(script, content, transf_id) == 0 ) return transform_script_get(script, 0)->values;
+
+    const char *message = transform_script_error(script, NULL, &column);
+    // Translation and Scale. Should be informed as: '(X,Y)'. Rotation as: 'Xd' - Where X and Y are numbers (pos or neg)
+    snprintf(result, sizeof(result), "WARNING: %s template is: '%s'. Found %s at column %d. Please, reformulate your input.",
+             ( transf_id == TRANSFORM_TRANSLATION ) ? "Translation" : ( transf_id == TRANSFORM_SCALE ) ? "Scale" : "Rotation",
+             ( transf_id == TRANSFORM_ROTATION ) ? "NUMd" : "(NUM,NUM)", message, column);
+    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+    return NULL;
+}
+
+/**
+ * @brief Computes the matrix of a transformation, or of a fraction of it (a frame of an animation): Translation and Rotation values
+ * are scaled by fraction, Scale's and Reflections' factors go linearly from 1 to their values.
+ * 
+ * @param type     TRANSFORM_*.
+ * @param values   (X, Y) of Translation and Scale, angle (radians) of Rotation. Unused otherwise.
+ * @param fraction In [0, 1]. 1 = whole transformation.
+ * @param m        Output: transformation's matrix.
+ * 
+ * @returns 1 if type is a transformation, 0 otherwise.
+*/
+static int transform_matrix(int            type,
+                            const double  *values,
+                            double         fraction,
+                            struct affine *m)
+{
+    double x, y;
+
+    switch ( type )
+    {
+        case TRANSFORM_TRANSLATION:
+            affine_translation(m, fraction * values[0], fraction * values[1]);
+            return 1;
+        case TRANSFORM_ROTATION:
+            affine_rotation(m, fraction * values[0]);
+            return 1;
+        case TRANSFORM_SCALE:
+            // When Scaling, whenever a value is negative, it means to SHRINK "the object". Positive values means to increase
+            x = ( values[0] < 0 ) ? 1.0 / abs((int) values[0]) : values[0];
+            y = ( values[1] < 0 ) ? 1.0 / abs((int) values[1]) : values[1];
+            break;
+        case TRANSFORM_X_REFLECTION:
+            x = 1.0;
+            y = -1.0;
+            break;
+        case TRANSFORM_Y_REFLECTION:
+            x = -1.0;
+            y = 1.0;
+            break;
+        case TRANSFORM_XY_REFLECTION:
+            x = -1.0;
+            y = -1.0;
+            break;
+        default:
+            return 0;
+    }
+    affine_scale(m, 1.0 + fraction * (x - 1.0), 1.0 + fraction * (y - 1.0));
+    return 1;
+}
+
+/**
+ * @brief Pushes a transformation into chain, as a matrix. Nothing is moved until "transform_objects" is called.
+ * Rotation pins each object's first point, so it is pushed as a pinned step.
+ * 
+ * @param type   TRANSFORM_*.
+ * @param values (X, Y) of Translation and Scale, angle (radians) of Rotation. Unused otherwise.
+*/
+static void transform_push(int           type,
+                           const double *values)
+{
+    struct affine m;
+
+    if ( transform_matrix(type, values, 1.0, &m) ) affine_chain_push(chain, &m, type == TRANSFORM_ROTATION);
+}
+
+/**
+ * @brief Resolves chain's matrix for an Object, pinning its first point (where it is in world now).
+ * 
+ * @param m     Object's matrix.
+ * @param first Object's first point.
+ * @param out   Output: chain's matrix for Object.
+*/
+static void transform_resolve(const struct affine *m,
+                              point_tt             first,
+                              struct affine       *out)
+{
+    double x = 0.0,
+           y = 0.0;
+
+    if ( affine_chain_is_pinned(chain) ) world_coords(m, &first, 1, &x, &y);
+    affine_chain_resolve(chain, x, y, out);
+}
+
+/**
+ * @brief (JOB) Applies chain to Lines [begin, end). Lines in groups are moved by their groups (see transform_groups_job).
+ * 
+ * @param begin First Line.
+ * @param end   One past last Line.
+ * @param arg   Unused.
+*/
+static void transform_lines_job(int   begin,
+                                int   end,
+                                void *arg)
+{
+    struct affine m;
+
+    for ( int i = begin; i < end; i++ )
+    {
+        if ( scene_graph_parent(scene, vector_get(&arr_lines, i)) != HANDLE_NONE ) continue;
+        line_tt foo = object_get(&arr_lines, i);
+        transform_resolve(line_get_matrix(foo), line_get_points(foo)[0], &m);
+        line_transform(foo, &m);
+    }
+}
+
+/**
+ * @brief (JOB) Applies chain to Polygons [begin, end), except those in groups.
+ * 
+ * @param begin First Polygon.
+ * @param end   One past last Polygon.
+ * @param arg   Unused.
+*/
+static void transform_polygons_job(int   begin,
+                                   int   end,
+                                   void *arg)
+{
+    struct affine m;
+
+    for ( int i = begin; i < end; i++ )
+    {
+        if ( scene_graph_parent(scene, vector_get(&arr_polygons, i)) != HANDLE_NONE ) continue;
+        polygon_tt foo = object_get(&arr_polygons, i);
+        transform_resolve(polygon_get_matrix(foo), polygon_get_points(foo)[0], &m);
+        polygon_transform(foo, &m);
+    }
+}
+
+/**
+ * @brief (JOB) Applies chain to Circumferences [begin, end), except those in groups. First point is the center, so Rotations are skipped (see "transform_node_resolve").
+ * 
+ * @param begin First Circumference.
+ * @param end   One past last Circumference.
+ * @param arg   Unused.
+*/
+static void transform_circumferences_job(int   begin,
+                                         int   end,
+                                         void *arg)
+{
+    struct affine m;
+
+    for ( int i = begin; i < end; i++ )
+    {
+        if ( scene_graph_parent(scene, vector_get(&arr_circumferences, i)) != HANDLE_NONE ) continue;
+        circumference_tt foo = object_get(&arr_circumferences, i);
+        affine_chain_resolve_unpinned(chain, &m);
+        circumference_transform(foo, &m);
+    }
+}
+
+/**
+ * @brief Resolves chain's matrix for a root (an Object not in a group, or an outermost group): Rotation pins its first Object's first point.
+ * A Circumference is not rotated (around its center, it would only move its border point, drawn with its label): Rotations are skipped.
+ * 
+ * @param h   Root's handle.
+ * @param out Output: chain's matrix for root.
+*/
+static void transform_node_resolve(handle_tt      h,
+                                   struct affine *out)
+{
+    handle_tt first = scene_graph_first_leaf(scene, h);
+    const point_tt *points;
+    const struct affine *own;
+    struct affine tmp;
+
+    if ( handle_kind(objects, h) == OBJECT_CIRCUMFERENCE )
+    {
+        affine_chain_resolve_unpinned(chain, out);
+        return;
+    }
+    object_geometry(first, &points, &own);
+    transform_resolve(object_matrix(first, own, &tmp), points[0], out);
+}
+
+/**
+ * @brief Applies a matrix to a root (an Object not in a group, or an outermost group). A group is transformed as a whole, in O(1) for its Objects:
+ * only its local matrix changes (see scene_graph_transform).
+ * 
+ * @param h Root's handle.
+ * @param m Given matrix, applied after every previous one.
+*/
+static void transform_node(handle_tt            h,
+                           const struct affine *m)
+{
+    void *foo = handle_get(objects, h);
+
+    switch ( handle_kind(objects, h) )
+    {
+        case OBJECT_LINE:
+            line_transform(foo, m);
+            break;
+        case OBJECT_POLYGON:
+            polygon_transform(foo, m);
+            break;
+        case OBJECT_CIRCUMFERENCE:
+            circumference_transform(foo, m);
+            break;
+        case OBJECT_GROUP:
+            scene_graph_transform(scene, h, m);
+            break;
+    }
+}
+
+/**
+ * @brief (JOB) Applies chain to outermost groups [begin, end) of scene graph (inner ones move with them). Groups never share Objects nor subgroups,
+ * so jobs never write the same matrices.
+ * 
+ * @param begin First group.
+ * @param end   One past last group.
+ * @param arg   Unused.
+*/
+static void transform_groups_job(int   begin,
+                                 int   end,
+                                 void *arg)
+{
+    struct affine m;
+
+    for ( int i = begin; i < end; i++ )
+    {
+        handle_tt h = scene_graph_group_at(scene, i);
+        if ( scene_graph_parent(scene, h) != HANDLE_NONE ) continue;
+        transform_node_resolve(h, &m);
+        transform_node(h, &m);
+    }
+}
+
+/**
+ * @brief Transformation of some roots (Objects not in groups, or outermost groups), by chain or by given matrices (undoing or redoing a command).
+*/
+struct transform_job
+{
+    const handle_tt     *roots;    /** << Transformed roots.                                                      */
+    const struct affine *matrices; /** << Matrices applied (one shared, or one per root). NULL = chain's.         */
+    int                  shared;   /** << If a single matrix is applied to every root.                         */
+    int                  invert;   /** << If matrices are inverted before being applied (undo).                */
+    struct affine       *record;   /** << Output: chain's matrix applied to each root. NULL = not recorded.    */
+};
+
+/**
+ * @brief (JOB) Transforms roots [begin, end) of a transformation. Roots never share Objects nor subgroups, so jobs never write the same matrices.
+ * 
+ * @param begin First root.
+ * @param end   One past last root.
+ * @param arg   Transformation (struct transform_job).
+*/
+static void transform_roots_job(int   begin,
+                                int   end,
+                                void *arg)
+{
+    const struct transform_job *job = arg;
+    struct affine m;
 
-        if ( algh == 1 ) DDA(pInit, pFinal, area);
-        else if ( algh == 2 ) Bresenham(pInit, pFinal, area);
+    for ( int i = begin; i < end; i++ )
+    {
+        if ( job->matrices )
+        {
+            m = job->matrices[job->shared ? 0 : i];
+            if ( job->invert ) affine_invert(&m, &m);
+        }
+        else
+        {
+            transform_node_resolve(job->roots[i], &m);
+            if ( job->record ) job->record[i] = m;
+        }
+        transform_node(job->roots[i], &m);
+    }
+}
 
-    }else
-    {   
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: There must be atleast 3 free points to draw a Polygon.");
-        return False;
+/**
+ * @brief (JOB) Computes again world coordinates of transformed Objects [begin, end) (see "leaves"), so they stay up to date
+ * (Objects do not share points, so jobs never write the same point).
+ * 
+ * @param begin First Object.
+ * @param end   One past last Object.
+ * @param arg   Unused.
+*/
+static void world_leaves_job(int   begin,
+                             int   end,
+                             void *arg)
+{
+    for ( int i = begin; i < end; i++ )
+    {
+        handle_tt h = leaves.data[i];
+        const point_tt *points;
+        const struct affine *m;
+        struct affine tmp;
+        int n = object_geometry(h, &points, &m);
+
+        world_write(object_matrix(h, m, &tmp), points, 0, n);
     }
+}
 
-    return True;
+/**
+ * @brief Applies chain to every drawn Object (except Clips), as chunked jobs of the scheduler: Objects in groups move with their outermost group.
+ * World coordinates will be computed again and every Object's box is indexed again. Chain is emptied.
+*/
+static void transform_all(void)
+{
+    scheduler_parallel_for(scheduler, arr_lines.size, OBJECTS_PER_JOB, transform_lines_job, NULL);
+    scheduler_parallel_for(scheduler, arr_polygons.size, OBJECTS_PER_JOB, transform_polygons_job, NULL);
+    scheduler_parallel_for(scheduler, arr_circumferences.size, OBJECTS_PER_JOB, transform_circumferences_job, NULL);
+    scene_graph_resolve(scene);
+    scheduler_parallel_for(scheduler, scene_graph_num_groups(scene), OBJECTS_PER_JOB, transform_groups_job, NULL);
+    affine_chain_clear(chain);
+    world_stale = 1;
+
+    index_objects(&arr_lines);
+    index_objects(&arr_polygons);
+    index_objects(&arr_circumferences);
 }
 
 /**
- * @brief Creates and draws Lines with previously specified Drawing Algorithm.
+ * @brief Transforms some roots (see struct transform_job), as chunked jobs of the scheduler, and nothing else: world coordinates of Objects
+ * under them are kept up to date and only their boxes are indexed again. Chain is emptied.
  * 
- * @param area Drawing Area.
- * 
- * @returns True if code was correctly executed, False otherwise.
+ * @param job    Transformation.
+ * @param n      Number of roots.
+ * @param damage Output: area (xmin, ymin, xmax, ymax) covered by roots before and after being transformed.
 */
-Bool Line(GtkWidget *area)
+static void transform_roots(struct transform_job *job,
+                            int                   n,
+                            double               *damage)
 {
-    // If no algorithm selected, "Error".
-    if ( algh == 0 )
+    int refresh = world_is_valid();
+    double after[4],
+           box[4];
+
+    roots_bounds(job->roots, n, damage);
+    scene_graph_resolve(scene);
+    scheduler_parallel_for(scheduler, n, OBJECTS_PER_JOB, transform_roots_job, job);
+    affine_chain_clear(chain);
+
+    // Objects under transformed groups moved with them
+    vector_clear(&leaves);
+    for ( int i = 0; i < n; i++ ) scene_graph_leaves(scene, job->roots[i], &leaves);
+    scene_graph_resolve(scene);
+    if ( refresh ) scheduler_parallel_for(scheduler, leaves.size, OBJECTS_PER_JOB, world_leaves_job, NULL);
+    else world_stale = 1;
+
+    after[0] = after[1] = INFINITY;
+    after[2] = after[3] = -INFINITY;
+    for ( int i = 0; i < leaves.size; i++ )
     {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide the drawing algorithm.");
-        return False;
+        handle_tt h = leaves.data[i];
+        object_bounds(h, box);
+        grid_update(grid, h, box);
+        bvh_update(bvh, h, box);
+        box_union(after, box);
     }
+    box_union(damage, after);
+}
+
+/**
+ * @brief Returns roots a transformation goes through: selected ones, or every root (Object not in a group, or outermost group) if nothing is selected.
+ * 
+ * @returns "selection", or "roots" filled with every root.
+*/
+static const handle_list_tt *transform_targets(void)
+{
+    if ( selection.size > 0 ) return &selection;
+
+    vector_clear(&roots);
+    for ( int i = 0; i < arr_lines.size; i++ ) vector_push(&roots, vector_get(&arr_lines, i));
+    for ( int i = 0; i < arr_polygons.size; i++ ) vector_push(&roots, vector_get(&arr_polygons, i));
+    for ( int i = 0; i < arr_circumferences.size; i++ ) vector_push(&roots, vector_get(&arr_circumferences, i));
+    for ( int i = 0; i < scene_graph_num_groups(scene); i++ ) vector_push(&roots, scene_graph_group_at(scene, i));
+
+    int n = 0;
+    for ( int i = 0; i < roots.size; i++ )
+        if ( scene_graph_parent(scene, roots.data[i]) == HANDLE_NONE ) roots.data[n++] = roots.data[i];
+    roots.size = n;
+    return &roots;
+}
 
-    int controller = number_taken_points(),
-        size_p = array_get_curr_num(arr_points);
+/**
+ * @brief Applies every transformation pushed into chain to all drawn objects (except Clips), or only to selected ones if any, as chunked jobs of the scheduler.
+ * Chain is composed in a single matrix per Object (the same for all of them, unless chain has a Rotation, that pins each Object's first point),
+ * which is composed with Object's own matrix: points are never moved, so it costs O(1) per Object no matter how many points it has,
+ * and a group is transformed as a single Object (only its local matrix changes, see transform_node),
+ * and repeated transformations do not pile rounding errors in points. Points go through matrices when Objects are drawn or clipped.
+ * After that, chain is emptied and transformed Objects' boxes are indexed again (bvh is refit before its next query). Nothing is redrawn.
+ * When only some roots are transformed (selected ones, or each one with its own matrix), nothing else is touched: their world coordinates are kept
+ * up to date and damage tells where they were before and after, so only that area needs to be redrawn (see "redraw_region").
+ * Matrices applied are recorded in "history" (see history_begin): a single one if it is the same for all roots, so it can be undone.
+ * 
+ * @param damage Output: area (xmin, ymin, xmax, ymax) covered by transformed Objects before and after being transformed. Set if 2 is returned.
+ * 
+ * @returns 0 if chain was empty, 1 if all Objects were transformed, 2 if only some roots.
+*/
+static int transform_apply(double *damage)
+{
+    if ( affine_chain_size(chain) == 0 ) return 0;
+    bvh_stale = 1;
+
+    // Pinning only changes the translation, so chain can be undone if it can be without pinning
+    struct affine m,
+                  inverse;
+    int pinned = affine_chain_is_pinned(chain),
+        undoable;
+    affine_chain_resolve(chain, 0.0, 0.0, &m);
+    undoable = affine_invert(&inverse, &m);
+    if ( !undoable ) history_reset();
+
+    if ( selection.size == 0 && !pinned )
+    {
+        if ( undoable )
+        {
+            history_begin(COMMAND_TRANSFORM);
+            *command_log_add_matrices(history, 1) = m;
+        }
+        transform_all();
+        return 1;
+    }
 
+    // Each root gets its own matrix if it is pinned
+    const handle_list_tt *targets = transform_targets();
 
-    if ( (size_p - controller) < 2 ) 
+    struct transform_job job = { targets->data, NULL, 0, 0, NULL };
+    if ( undoable )
     {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: There must be atleast 2 free points to draw a Line.");
-        return False;
+        history_begin(COMMAND_TRANSFORM);
+        memcpy(command_log_add_handles(history, targets->size), targets->data, sizeof(handle_tt) * targets->size);
+        if ( pinned ) job.record = command_log_add_matrices(history, targets->size);
+        else *command_log_add_matrices(history, 1) = m;
     }
+    transform_roots(&job, targets->size, damage);
+    return 2;
+}
+
+/**
+ * @brief Redraws after "transform_apply": only the area selected Objects covered before and after, if only they were transformed.
+ * 
+ * @param applied What "transform_apply" returned.
+ * @param damage  Area set by "transform_apply".
+*/
+static void transform_redraw(int           applied,
+                             const double *damage)
+{
+    if ( applied == 2 ) redraw_region(Widgets.drawing_area, damage);
+    else if ( applied == 1 ) redraw_objects(Widgets.drawing_area);
+}
+
+/**
+ * @brief Applies every transformation pushed into chain (see "transform_apply"), then redraws (once) everything at new position,
+ * or only the area of selected Objects.
+*/
+static void transform_objects(void)
+{
+    double damage[4];
+
+    transform_redraw(transform_apply(damage), damage);
+}
+
+/**
+ * @brief Parses a transform script (see transform_script.h) into "script". If content starts with '@', the rest is the path of a file
+ * that holds the script. Writes in "label" why it could not be read, or where it is invalid.
+ * 
+ * @param content    Script, or '@' and a file's path.
+ * @param parse_time Output: how long parsing took, in microseconds.
+ * 
+ * @return Number of steps, 0 if script could not be read or is invalid.
+*/
+static int load_script(const char *content,
+                       gint64     *parse_time)
+{
+    char result[512];
+    char *file = NULL;
+    GError *error = NULL;
+    int line,
+        column;
 
-    while( controller < size_p )
+    // Sanity Check
+    if ( content[0] == '\0' )
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide a script, e.g. 'T(10,5); R30d; S(2,2); RX', or '@' and a file.");
+        return 0;
+    }
+    if ( content[0] == '@' )
     {
-        /**
-         * Must have atleast 2 points to draw a line,
-         * If there is only one, "ignore it".
-         */
-        if ( (size_p - controller) >= 2 )
-        {  
-            struct point *pInit = array_get(arr_points, controller);
-            struct point *pFinal = array_get(arr_points, controller + 1);
+        if ( !g_file_get_contents(&content[1], &file, NULL, &error) )
+        {
+            snprintf(result, sizeof(result), "WARNING: Script file could not be read: %s.", error->message);
+            gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+            g_error_free(error);
+            return 0;
+        }
+        content = file;
+    }
 
-            if ( point_is_taken(pInit) ) continue;
+    gint64 t = g_get_monotonic_time();
+    int num_steps = transform_script_parse(script, content);
+    *parse_time = g_get_monotonic_time() - t;
 
-            struct line *new_line = line_create(pInit, pFinal, algh);
-            array_set(arr_lines, array_get_curr_num(arr_lines), new_line);
-            point_take(pInit);
-            point_take(pFinal);
+    g_free(file);
+    if ( num_steps <= 0 )
+    {
+        const char *message = transform_script_error(script, &line, &column);
 
-            if ( algh == 1 ) DDA(pInit, pFinal, area);
-            else if ( algh == 2 ) Bresenham(pInit, pFinal, area);
-            controller++;
-        } 
-        controller++;
+        if ( message ) snprintf(result, sizeof(result), "WARNING: Script is invalid at line %d, column %d: %s.", line, column, message);
+        else snprintf(result, sizeof(result), "WARNING: Script has no steps.");
+        gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+        return 0;
     }
-    return True;
+    return num_steps;
 }
 
 /**
- * @brief Retrieves the elapsed time by a function and prints it in "label".
+ * @brief Runs a transform script (see transform_script.h), e.g. 'T(10,5); R30d; S(2,2); RX'. If content starts with '@', the rest is
+ * the path of a file that holds the script. Script is parsed once and all its steps are pushed into chain, so they are applied to all
+ * drawn objects (except Clips), or to selected ones, in a single pass, followed by a single redraw. Writes in "label" how long parsing, each step
+ * (up to SCRIPT_TIMED_STEPS of them), applying and redrawing took, or where the script is invalid.
  * 
- * @param t Elapsed time
+ * @param content Script, or '@' and a file's path.
+ * 
+ * @return True if code execution was correct. False otherwise
 */
-void write_execution_time(double t)
+Bool run_script(const char *content)
 {
-    char template[100],
-         result[100];
+    char result[512];
+    int length = 0;
+    gint64 t,
+           parse_time;
 
+    int num_steps = load_script(content, &parse_time);
+    if ( num_steps <= 0 ) return False;
 
-    sprintf(template, "%f", (((double)t)/CLOCKS_PER_SEC)*100);
-    strcpy(result, "Time Elapsed: ");
-    strcat(result, template);
-    strcat(result, "ms.\0");
-    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
-}
+    length += snprintf(&result[length], sizeof(result) - length, "Script: parse %.3fms;", parse_time / 1000.0);
+    gint64 rest = 0;
+    for ( int i = 0; i < num_steps; i++ )
+    {
+        const struct transform_step *step = transform_script_get(script, i);
 
-void redraw_objects(GtkWidget *area)
-{   
-    int aux[MAX_POINTS],
-        cont = 0;
-    for (int i = 0; i < MAX_POINTS; i++ ) aux[i] = -2;
+        t = g_get_monotonic_time();
+        transform_push(step->type, step->values);
+        t = g_get_monotonic_time() - t;
+        if ( i < SCRIPT_TIMED_STEPS ) length += snprintf(&result[length], sizeof(result) - length, " %s %.3fms", transform_script_name(step->type), t / 1000.0);
+        else rest += t;
+    }
+    if ( num_steps > SCRIPT_TIMED_STEPS ) length += snprintf(&result[length], sizeof(result) - length, " (+%d steps %.3fms)", num_steps - SCRIPT_TIMED_STEPS, rest / 1000.0);
 
-    clear_surface(0);
-    gtk_widget_queue_draw(Widgets.drawing_area);
-    cairo_t *cr;
-    cr = cairo_create(surface);
-    point_tt *points,
-             *oposite;
-
-    // Lines 
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )    
-    {
-        struct line *line = array_get(arr_lines, i);
-        int line_algh = line_get_algh(line);
-        
-        if ( line_was_clipped(line) == 0 ) 
-        {
-            points = line_get_points(line);
+    double damage[4];
+    t = g_get_monotonic_time();
+    int applied = transform_apply(damage);
+    gint64 apply_time = g_get_monotonic_time() - t;
 
-            // Preventing errors
-            oposite = line_get_clipped_points(line);
-            for ( int j = 0; j < 2; j++ )
-                if ( oposite[j] != NULL ) aux[cont++] = point_id(oposite[j]);
-        }
-        else if ( line_was_clipped(line) == 1 )
-        {
-            points = line_get_clipped_points(line);
+    t = g_get_monotonic_time();
+    transform_redraw(applied, damage);
+    t = g_get_monotonic_time() - t;
 
-            // Preventing errors
-            oposite = line_get_points(line);
-            for ( int j = 0; j < 2; j++ ) {
-                if ( oposite[j] != NULL ) aux[cont++] = point_id(oposite[j]);
-            }
-        }
-        // Implementation decision. Whenever one of polygon's side is not IN the clip area, don't draw the polygon at all
-         else if ( line_was_clipped(line) == 2 )
-        {
-            continue;
-        }
+    snprintf(&result[length], sizeof(result) - length, "; apply %.3fms; redraw %.3fms.", apply_time / 1000.0, t / 1000.0);
+    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+    return True;
+}
 
-        // Redrawing points
-        for ( int j = 0; j < 2; j++ )
-        {
-            aux[cont++] = point_id(points[j]);
-            double x = point_x_coord(points[j]),
-                   y = point_y_coord(points[j]);
-            draw_brush(Widgets.drawing_area, cr, x, y, color_get_colors(point_color(points[j])));
-            draw_text(Widgets.drawing_area, cr, points[j]);
-        }
+/**
+ * @brief Fills animation's chain with script's steps at a point of the animation: steps are keyframes played one after another,
+ * so steps before it are whole, the step it is in is partial (see "transform_matrix") and steps after it are not pushed.
+ * 
+ * @param fraction In [0, 1], how much of animation was played.
+*/
+static void animation_sample(double fraction)
+{
+    struct affine m;
+    double played = fraction * animation.steps.size;
 
-        // Redrawing lines between points
-        if ( line_algh == 1 ) DDA(points[0], points[1], Widgets.drawing_area);
-        else if ( line_algh == 2 ) Bresenham(points[0], points[1], Widgets.drawing_area);
+    affine_chain_clear(animation.chain);
+    for ( int i = 0; i < animation.steps.size && played > i; i++ )
+    {
+        const struct transform_step *step = &animation.steps.data[i];
+        double part = ( played - i < 1.0 ) ? played - i : 1.0;
 
+        if ( transform_matrix(step->type, step->values, part, &m) ) affine_chain_push(animation.chain, &m, step->type == TRANSFORM_ROTATION);
     }
-     
-    // Polygons
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
-    {
-        struct polygon *pl = array_get(arr_polygons, i);
-        int polygon_algh = polygon_get_algh(pl);
-        array_tt p_points;
-        array_tt p_oposite;
+}
 
-        if ( polygon_was_clipped(pl) == 0 ) 
-        {
-            p_points = polygon_get_points(pl);
+/**
+ * @brief Moves animated roots to a point of the animation. Each root gets the matrix that takes it from where it is (what was applied so far)
+ * to where it must be, so frames never pile up: a skipped frame is caught up by the next one. Only animated roots are touched (see "transform_roots").
+ * A frame where a root would be flattened (e.g. halfway through a Reflection) is skipped, so what was applied can always be inverted.
+ * 
+ * @param fraction In [0, 1], how much of animation was played.
+ * @param damage   Output: area (xmin, ymin, xmax, ymax) covered by animated roots before and after. Set if 1 is returned.
+ * 
+ * @returns 1 if roots were moved, 0 if frame was skipped.
+*/
+static int animation_frame(double  fraction,
+                           double *damage)
+{
+    struct affine inverse,
+                  target;
 
-            // Preventing errors
-            p_oposite = polygon_get_clipped_points(pl);
-            for ( int j = 0; j < array_get_curr_num(p_oposite); j++ )
-                   if ( array_get(p_oposite, j) != NULL ) aux[cont++] = point_id(array_get(p_oposite, j));
-        }
-        else if ( polygon_was_clipped(pl) == 1 )
-        {
-            p_points = polygon_get_clipped_points(pl);
+    animation_sample(fraction);
+    for ( int i = 0; i < animation.roots.size; i++ )
+    {
+        // Circumferences are not rotated (see "transform_node_resolve")
+        if ( handle_kind(objects, animation.roots.data[i]) == OBJECT_CIRCUMFERENCE ) affine_chain_resolve_unpinned(animation.chain, &animation.deltas.data[i]);
+        else affine_chain_resolve(animation.chain, animation.states.data[i].x, animation.states.data[i].y, &animation.deltas.data[i]);
+        if ( fraction < 1.0 && !affine_invert(&inverse, &animation.deltas.data[i]) ) return 0;
+    }
 
-            // Preventing errors
-            p_oposite = polygon_get_points(pl);
-            for ( int j = 0; j < array_get_curr_num(p_oposite); j++ ) 
-                {
-                    aux[cont++] = point_id(array_get(p_oposite, j));
-                }
-        } 
-        else if ( polygon_was_clipped(pl) == 2 )
-        {
-            continue;
-        }
+    for ( int i = 0; i < animation.roots.size; i++ )
+    {
+        struct animated_root *state = &animation.states.data[i];
 
-        // Redrawing points
-        for ( int j = 0; j < array_get_curr_num(p_points) ; j++ )
-        {   
-            struct point *p = array_get(p_points, j);
-            aux[cont++] = point_id(p);
-            double x = point_x_coord(array_get(p_points, j)),
-                   y = point_y_coord(array_get(p_points, j));
-            draw_brush(Widgets.drawing_area, cr, x, y, color_get_colors(point_color(p)));
-            draw_text(Widgets.drawing_area, cr, p);
-        }
+        target = animation.deltas.data[i];
+        affine_invert(&inverse, &state->applied);
+        affine_multiply(&animation.deltas.data[i], &target, &inverse);
+        state->applied = target;
+    }
 
-        // Redrawing lines between points
-        for ( int j = 0; j < array_get_curr_num(p_points) - 1; j++ )
-        {
-            struct point *pInit = array_get(p_points, j);
-            struct point *pFinal = array_get(p_points, j + 1);
+    struct transform_job job = { animation.roots.data, animation.deltas.data, 0, 0, NULL };
+    bvh_stale = 1;
+    transform_roots(&job, animation.roots.size, damage);
+    return 1;
+}
 
-            if ( algh == 1 ) DDA(pInit, pFinal, Widgets.drawing_area);
-            else if ( algh == 2 ) Bresenham(pInit, pFinal, Widgets.drawing_area);
-        }
-        // Closing Polygon
-        struct point *pInit = array_get(p_points, array_get_curr_num(p_points) - 1);
-        struct point *pFinal = array_get(p_points, 0);
+/**
+ * @brief (TICK) Called by GTK's frame clock once per frame while a script is animated. Animation follows frame clock's time, not frames:
+ * a frame is skipped if renderer has not rasterized the previous one yet (its area would be refused, see renderer_is_busy) or if the previous one
+ * took longer than ANIMATION_BUDGET, and the next frame catches up. Each frame only moves animated roots and only redraws the area they covered
+ * before and after (see "redraw_region"). Last frame ends animation (see "animation_finish").
+ * 
+ * @param widget Drawing area.
+ * @param clock  Frame clock.
+ * @param data   Unused.
+*/
+static gboolean animation_tick(GtkWidget     *widget,
+                               GdkFrameClock *clock,
+                               gpointer       data)
+{
+    gint64 now = gdk_frame_clock_get_frame_time(clock);
+    double damage[4];
 
-        if ( algh == 1 ) DDA(pInit, pFinal, Widgets.drawing_area);
-        else if ( algh == 2 ) Bresenham(pInit, pFinal, Widgets.drawing_area);
+    if ( animation.start < 0 ) animation.start = now;
+    double fraction = (double) (now - animation.start) / ((gint64) ANIMATION_STEP_TIME * animation.steps.size);
+    if ( fraction >= 1.0 )
+    {
+        // Callback is being removed by returning G_SOURCE_REMOVE.
+        animation.tick = 0;
+        animation_finish();
+        return G_SOURCE_REMOVE;
     }
 
-    // Circumference
-    for ( int i = 0; i < array_get_curr_num(arr_circumferences); i++ )
+    if ( animation.late || renderer_is_busy(renderer) )
     {
-        circumference_tt circumference = array_get(arr_circumferences, i);
+        animation.late = 0;
+        animation.skipped++;
+        return G_SOURCE_CONTINUE;
+    }
 
-        points = circumference_get_points(circumference);
+    gint64 t = g_get_monotonic_time();
+    if ( animation_frame(fraction, damage) ) redraw_region(widget, damage);
+    t = g_get_monotonic_time() - t;
 
-        for ( int j = 0; j < 2; j++ )
-        {
-            aux[cont++] = point_id(points[j]);
-            double x = point_x_coord(points[j]),
-                    y = point_y_coord(points[j]);
-            point_set_coord(points[j], x, y);
-            draw_brush(Widgets.drawing_area, cr, x, y, color_get_colors(point_color(points[j])));
-            draw_text(Widgets.drawing_area, cr, points[j]);
-        }
+    animation.work += t;
+    animation.frames++;
+    animation.late = ( t > ANIMATION_BUDGET );
+    return G_SOURCE_CONTINUE;
+}
 
-        calculate_circumference_points(Widgets.drawing_area, circumference);
+/**
+ * @brief Ends current animation, if any: roots are moved where script takes them and redrawn, and the whole animation is recorded
+ * in "history" as a single transformation (each root with the matrix applied to it), so it is undone at once. Writes in "label"
+ * how many frames were drawn (and how long they took) and how many were skipped. Called by last frame, or before anything else changes the scene.
+*/
+static void animation_finish(void)
+{
+    struct affine inverse;
+    char result[200];
+    double damage[4];
+    int undoable = 1;
+
+    if ( animation.tick ) gtk_widget_remove_tick_callback(Widgets.drawing_area, animation.tick);
+    animation.tick = 0;
+    if ( animation.roots.size == 0 ) return;
+
+    animation_frame(1.0, damage);
+    for ( int i = 0; i < animation.roots.size && undoable; i++ ) undoable = affine_invert(&inverse, &animation.states.data[i].applied);
+    if ( undoable )
+    {
+        history_begin(COMMAND_TRANSFORM);
+        memcpy(command_log_add_handles(history, animation.roots.size), animation.roots.data, sizeof(handle_tt) * animation.roots.size);
+        struct affine *recorded = command_log_add_matrices(history, animation.roots.size);
+        for ( int i = 0; i < animation.roots.size; i++ ) recorded[i] = animation.states.data[i].applied;
     }
+    else history_reset();
+    vector_clear(&animation.roots);
+    transform_redraw(2, damage);
+
+    snprintf(result, sizeof(result), "Animation: %d step(s), %d frame(s) drawn (%.3fms each), %d skipped.", animation.steps.size, animation.frames,
+             animation.frames ? animation.work / 1000.0 / animation.frames : 0.0, animation.skipped);
+    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+}
 
-    // Clips
-    for ( int i = 0; i < array_get_curr_num(arr_clips); i++ )
+/**
+ * @brief Animates a transform script (see "run_script"): its steps are keyframes, each one played in ANIMATION_STEP_TIME on GTK's frame clock
+ * (see "animation_tick"), going through all drawn objects (except Clips), or through selected ones. Each Rotation pins root's first point
+ * where it was when animation started. When it ends, roots are where running the script would take them.
+ * 
+ * @param content Script, or '@' and a file's path.
+ * 
+ * @return True if code execution was correct. False otherwise
+*/
+Bool animate_script(const char *content)
+{
+    const point_tt *points;
+    const struct affine *m;
+    struct affine tmp;
+    gint64 parse_time;
+
+    int num_steps = load_script(content, &parse_time);
+    if ( num_steps <= 0 ) return False;
+
+    vector_clear(&animation.steps);
+    for ( int i = 0; i < num_steps; i++ ) vector_push(&animation.steps, *transform_script_get(script, i));
+
+    // Anchors are read through groups' world matrices
+    const handle_list_tt *targets = transform_targets();
+    int n = targets->size;
+    scene_graph_resolve(scene);
+    vector_clear(&animation.roots);
+    vector_reserve(&animation.roots, n);
+    vector_reserve(&animation.states, n);
+    vector_reserve(&animation.deltas, n);
+    for ( int i = 0; i < n; i++ )
     {
-        struct clip *cl = array_get(arr_clips, i);
-        array_tt p_points;
+        handle_tt first = scene_graph_first_leaf(scene, targets->data[i]);
+        struct animated_root *state = &animation.states.data[i];
 
+        object_geometry(first, &points, &m);
+        world_coords(object_matrix(first, m, &tmp), points, 1, &state->x, &state->y);
+        affine_identity(&state->applied);
+        vector_push(&animation.roots, targets->data[i]);
+    }
+    animation.states.size = n;
+    animation.deltas.size = n;
+
+    animation.start = -1;
+    animation.work = 0;
+    animation.frames = 0;
+    animation.skipped = 0;
+    animation.late = 0;
+    animation.tick = gtk_widget_add_tick_callback(Widgets.drawing_area, animation_tick, NULL, NULL);
+    return True;
+}
 
-        p_points = clip_get_points(cl);
+/**
+ * @brief Applies the XYReflection in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
+ * 
+ * @return True if code execution was correct. False otherwise
+*/
+Bool xyreflection()
+{
+    transform_push(TRANSFORM_XY_REFLECTION, NULL);
+    transform_objects();
+    return True;
+}
 
-        // Redrawing points
-        for ( int j = 0; j < array_get_curr_num(p_points) ; j++ )
-        {   
-            struct point *p = array_get(p_points, j);
-            aux[cont++] = point_id(p);
-            double x = point_x_coord(array_get(p_points, j)),
-                   y = point_y_coord(array_get(p_points, j));
-            draw_brush(Widgets.drawing_area, cr, x, y, color_get_colors(point_color(p)));
-            draw_text(Widgets.drawing_area, cr, p);
-        }
+/**
+ * @brief Applies the YReflection in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
+ * 
+ * @return True if code execution was correct. False otherwise
+*/
+Bool yreflection()
+{
+    transform_push(TRANSFORM_Y_REFLECTION, NULL);
+    transform_objects();
+    return True;
+}
 
-        // Redrawing lines between points
-        for ( int j = 0; j < array_get_curr_num(p_points) - 1; j++ )
-        {
-            struct point *pInit = array_get(p_points, j);
-            struct point *pFinal = array_get(p_points, j + 1);
+/**
+ * @brief Applies the XReflection in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
+ * 
+ * @return True if code execution was correct. False otherwise
+*/
+Bool xreflection()
+{    
+    transform_push(TRANSFORM_X_REFLECTION, NULL);
+    transform_objects();
+    return True;
+}
 
-            DDA(pInit, pFinal, Widgets.drawing_area);
-        }
-        // Closing Polygon
-        struct point *pInit = array_get(p_points, array_get_curr_num(p_points) - 1);
-        struct point *pFinal = array_get(p_points, 0);
 
-        DDA(pInit, pFinal, Widgets.drawing_area);
+/**
+ * @brief Pins the first point and applies the Rotation in each point of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
+ * Circumferences are left as they are, border point included (rotating around their center would only move it).
+ * 
+ * @return True if code execution was correct. False otherwise
+*/
+Bool rotation(const char *content,
+              int         transf_id)
+{
+    // Sanity Check
+    if ( content[0] == '\0' ) 
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide paramethers to this transformation.");
+        return False;
     }
 
-    // Points
-    // Drawing all points that aren't part of an object
-    for ( int i = 0; i < array_get_curr_num(arr_points); i++ )
+    const double *rotation = NULL;
+    if ( (rotation = read_template(content, transf_id)) == NULL ) return False;
+
+    transform_push(TRANSFORM_ROTATION, rotation);
+    transform_objects();
+    return True;
+}
+
+/**
+ * @brief Applies the Scale in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
+ * When values specified are negative, it means to SHRINK "the objetct". Positive values means to increase it.
+ * 
+ * @return True if code execution was correct. False otherwise
+*/
+Bool scale(const char *content, 
+           int         transf_id)
+{
+    // Sanity Check
+    if ( content[0] == '\0' ) 
     {
-        // drawn = False;
-        point_tt p = array_get(arr_points, i);
-        if ( p == NULL ) continue;
-        int id = point_id(p);
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide paramethers to this transformation.");
+        return False;
+    }
 
-        if ( !point_is_taken(p) ) 
-        {
-            draw_brush(Widgets.drawing_area, cr, point_x_coord(p), point_y_coord(p), color_get_colors(point_color(p)));
-            draw_text(Widgets.drawing_area, cr, p);
-        }
-    }   
-    cairo_destroy(cr);
+    const double *scale = NULL;
+    if ( (scale = read_template(content, transf_id)) == NULL ) return False;
+
+    transform_push(TRANSFORM_SCALE, scale);
+    transform_objects();
+    return True;
 }
 
 /**
- * @brief (CALL_BACK) Function called whenever an option in "Drawing"drop-down is sellected, 
- * Defines which option of drawing (Line, Polygon or Circumfere) should be drawn.
+ * @brief Applies the Translation in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
+ * 
+ * @return True if code execution was correct. False otherwise
+*/
+Bool translation(const char *content,
+                 int         transf_id)
+{
+    // Sanity Check
+    if ( content[0] == '\0' ) 
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide paramethers to this transformation.");
+        return False;
+    }
+
+    const double *translation = NULL;
+    if ( (translation = read_template(content, transf_id)) == NULL ) return False;
+
+    transform_push(TRANSFORM_TRANSLATION, translation);
+    transform_objects();
+    return True;
+}
+
+/**
+ * @brief (CALL_BACK) Function called whenever an option in "Transformation"drop-down is sellected, also, the value filled in "entry" is used.
+ * Defines which option of transformation (Translation, rotation, scale or refleciton) should be done.
  * 
  * @param dropdown Dropdown selected
  * @param entry 
 */
-static void drawings_execution(GtkDropDown *dropdown,
-                               GtkWidget   *area,
-                               gpointer     user_data)
+static void transformation_execution(GtkDropDown *dropdown,
+                                     GtkEntry    *entry,
+                                     gpointer     user_data)
 {
+    // Getting the content written into the entry. It's owned by entry's buffer (nothing is copied)
+    const char *content = gtk_entry_buffer_get_text(user_data);
     int dropdown_selected = gtk_drop_down_get_selected(dropdown);
     clock_t t;
-    Bool cntrl = False;
+    Bool cntrl;
+
+    // Transformations start where current animation ends
+    if ( dropdown_selected != 0 ) animation_finish();
+    if ( dropdown_selected != 0 && point_count() == 0 )
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must draw points to perform transformations.");
+        return;
+    } else if ( dropdown_selected != 0 && arr_lines.size == 0 && arr_polygons.size == 0 && arr_circumferences.size == 0 )
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must draw an object to perform transformations.");
+        return;
+    }
 
-    GtkWidget *drawing_area = GTK_WIDGET(user_data);
     switch (dropdown_selected)
     {
         case 1:
             t = clock();
-            cntrl = Line(drawing_area);
+            cntrl = translation(content, dropdown_selected);
             t = clock() - t;
             if ( cntrl ) write_execution_time(t);
             break;
         case 2:
             t = clock();
-            cntrl = Polygon(drawing_area);
+            cntrl = rotation(content, dropdown_selected);
             t = clock() - t;
             if ( cntrl ) write_execution_time(t);
             break;
         case 3:
             t = clock();
-            cntrl = Circumference(drawing_area);
+            cntrl = scale(content, dropdown_selected);
+            t = clock() - t;
+            if ( cntrl ) write_execution_time(t);
+            break;
+        case 4:
+            t = clock();
+            cntrl = xreflection();
+            t = clock() - t;
+            if ( cntrl ) write_execution_time(t);
+            break;
+        case 5: 
+            t = clock();
+            cntrl = yreflection();
+            t = clock() - t;
+            if ( cntrl ) write_execution_time(t);
+            break;
+        case 6:
+            t = clock();
+            cntrl = xyreflection();
             t = clock() - t;
             if ( cntrl ) write_execution_time(t);
             break;
+        case 7:
+            // Script writes its own timings (parsing, each step, applying and redrawing)
+            run_script(content);
+            break;
+        case 8:
+            // Animation writes its own timings when it ends
+            animate_script(content);
+            break;
         default:
+            gtk_label_set_label(GTK_LABEL(Widgets.label), "Debug informations here...");
             break;
     }
 
-
 }
 
-char* read_from_until(char *content,
-                      char  stop,
-                      int  *pos)
-{
-    char *result = (char*) malloc(sizeof(char) * 100);
-    int controller = 0;
-
-    while ( content[*pos] != stop  )
-    {
-        // Ensuring that only numbers will be in our template
-        if ( (content[*pos] < '0' || content[*pos] > '9') && content[*pos] != '.' && content[*pos] != '-' && content[*pos] != '+')
-        {
-            gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: Template found is invalid. Please, reformulate your input.");
-            return NULL;
-        }
-        result[controller++] = content[(*pos)++];
-    }
-
-    result[controller] = '\0';
-    return result;
-}
 
 /**
- * @brief Checks if given content is correct based in given transformation algorithm's template (Check documentation).
- * If values[pos] == -1, it implies that this position is not used.
- *  
- * @param content   Content to be analysed
- * @param transf_id Which transformation was selected
+ * @brief Creates a CLIP structure based on two points drawn by the user. Since the CLIP must have a rectangle shape, the other two points are created based on X and Y of drawn points.
+ * Drawing algorithm used is DDA.
  * 
- * @returns An array that contains the read values based on transformation algorithm's template (Check documentation). 
+ * @return True if code execution was correct. False otherwise
 */
-double* check_content(char* content, 
-                      int   transf_id)
+Bool clip_structure()
 {
-    char *first  = (char*) malloc(sizeof(char) * 100),
-         *second = (char*) malloc(sizeof(char) * 100),
-         *foo = (char*) malloc(sizeof(char) * 100);
-         
-    int controller = 0;
-    double *values = (double*) malloc(sizeof(double) * 3);
-    // Translation and Scale. Should be informed as: '(X,Y)' - Where X and Y are, both, the integer values (pos or neg).
-    if ( transf_id == 1 || transf_id == 3)
-    {
-        if ( strlen(content) < 5 )
-        {
-            if ( transf_id == 1 )
-                gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: Translation template is: '(INT,INT)'. Please, reformulate your input.");
-            else gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: Scale template is: '(INT,INT)'. Please, reformulate your input.");
-            return NULL;
-        }
-        double x = 0.0f,
-               y = 0.0f;
-        controller = 1;
-        first = read_from_until(content, ',', &controller);
-        if ( first == NULL ) return NULL;
-
-        x = strtod(first, &foo);
-        controller++;
-
-        second = read_from_until(content, ')', &controller);
-        if ( second == NULL ) return NULL;
-
-        y = strtod(second, &foo);
-        values[0] = x;
-        values[1] = y;
-        values[2] = -1;
-        return values;
-    } 
-    // Rotation. Should be informed as: 'Xd' - Where X is an integer rotation degree value (pos or neg).
-    else if ( transf_id == 2 )
-    {
-        if ( strlen(content) > 5 )
-        {
-            gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: Rotation template is: 'INTd'. Please, reformulate your input.");
-            return NULL;
-        }
-
-        double ang = 0.0f;
-        first = read_from_until(content, 'd', &controller);
-        if ( first == NULL ) return NULL;
+    int from = 0,
+        iterator = 0;
 
-        ang = strtod(first, &foo);
-        values[0] = ang * M_PI / 180.0;
-        values[1] = -1;
-        values[2] = -1;
-        return values;
+    if ( arr_clips.size >= 1 )
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You can have only 1 clip area per time.");
+        return True;
     }
 
+    point_tt points[NUM_CLIP_POINTS];
+    if ( number_free_points() >= 2 )
+    { 
+        // Adding first two free points into Clip's structure.
+        while ( iterator < 2 ) 
+        {
+            point_tt p = next_free_point(&from);
+            free_point_take(p, POINT_CLIP);
+            point_define_color(p, 1.0, 0.0, 0.0);
+            points[iterator++] = p;
+        }
+        point_tt p_first = points[0],
+                 p_third = points[1];
 
-    // House Keeping
-    free(first);
-    free(second);
-    free(foo);
-}
-
-/**
- * @brief Applies the XYReflection in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
- * 
- * @return True if code execution was correct. False otherwise
-*/
-Bool xyreflection()
-{
-    // Lines.
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )
-    {
-        line_tt foo = array_get(arr_lines, i);
 
-        point_tt *points = line_get_points(foo);
+        // It must be a perfect rectangle, so User must point the two oposit points, and the others will be generated based on clicked point's coordinates.
+        point_tt p_second = point_create(point_x_coord(p_third), point_y_coord(p_first));
+        point_tt p_fourth = point_create(point_x_coord(p_first), point_y_coord(p_third));
 
-        for ( int j = 0; j < 2; j++ )
-        {
-            double new_x = -point_x_coord(points[j]),
-                   new_y = -point_y_coord(points[j]);
-            point_set_coord(points[j], new_x, new_y);
-        }
-    }
+        // Clip's points will always be drawn as red points, just to differentiate from others.
+        point_define_color(p_second, 1.0, 0.0, 0.0);
+        point_define_color(p_fourth, 1.0, 0.0, 0.0);
+        point_mark(p_second, POINT_TAKEN | POINT_CLIP);
+        point_mark(p_fourth, POINT_TAKEN | POINT_CLIP);
+        iterator += 2;
 
-    // Polygons.
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
-    {
-        polygon_tt foo = array_get(arr_polygons, i);
+        point_tt temp = p_third;
+        points[0] = p_first;
+        points[1] = p_second;
+        points[2] = temp;
+        points[3] = p_fourth;
 
-        array_tt p_points = polygon_get_points(foo);
+        struct clip *clip = clip_create(arena, points, iterator, algh);
 
-        for ( int j = 0; j < array_get_curr_num(p_points) ; j++ )
-        {   
-            struct point *p = array_get(p_points, j);
-            double new_x = -point_x_coord(array_get(p_points, j)),
-                   new_y = -point_y_coord(array_get(p_points, j));
-            point_set_coord(p, new_x, new_y);
-        }
-    }
-    
-    // Circumference.
-    for ( int i = 0; i < array_get_curr_num(arr_circumferences); i++ )
-    {
-        circumference_tt foo = array_get(arr_circumferences, i);
+        object_add(&arr_clips, OBJECT_CLIP, clip);
 
-        point_tt *points = circumference_get_points(foo);
+        redraw_objects(Widgets.drawing_area);
 
-        for ( int j = 0; j < 2; j++ )
-        {
-            double new_x = -point_x_coord(points[j]),
-                   new_y = -point_y_coord(points[j]);
-            point_set_coord(points[j], new_x, new_y);
-        }
+    }else
+    {   
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: There must be atleast 2 free points to draw a Clip.");
+        return False;
     }
 
-    redraw_objects(Widgets.drawing_area);
     return True;
 }
 
 /**
- * @brief Applies the YReflection in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
- * 
- * @return True if code execution was correct. False otherwise
+ * @brief Clipping results of candidate Lines and Polygons' edges (those whose box overlaps Clip). Candidates inside Clip come first,
+ * they are trivially accepted. Filled in parallel by scheduler's jobs, then consumed in candidates' order.
 */
-Bool yreflection()
+struct clip_job
 {
-    // Lines.
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )
-    {
-        line_tt foo = array_get(arr_lines, i);
-
-        point_tt *points = line_get_points(foo);
-
-        for ( int j = 0; j < 2; j++ )
-        {
-            double new_x = -point_x_coord(points[j]),
-                   new_y = point_y_coord(points[j]);
-            point_set_coord(points[j], new_x, new_y);
-        }
-    }
+    int                  algorithm; /** << CLIP_COHEN_SUTHERLAND or CLIP_LIANG_BARSKY. */
+    int                  xmin;      /** << Clip's XMIN.                                */
+    int                  xmax;      /** << Clip's XMAX.                                */
+    int                  ymin;      /** << Clip's YMIN.                                */
+    int                  ymax;      /** << Clip's YMAX.                                */
+    handle_tt           *line_objs; /** << Candidate Lines.                            */
+    handle_tt           *poly_objs; /** << Candidate Polygons.                         */
+    int                  in_lines;  /** << Candidate Lines inside Clip (the first ones).    */
+    int                  in_polys;  /** << Candidate Polygons inside Clip (the first ones). */
+    struct clip_segment *lines;     /** << One segment per candidate Line.             */
+    struct clip_segment *edges;     /** << One segment per candidate Polygon's edge.   */
+    int                 *offsets;   /** << First edge of each candidate Polygon.       */
+};
 
-    // Polygons.
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
-    {
-        polygon_tt foo = array_get(arr_polygons, i);
+/**
+ * @brief Trivially accepts or rejects an Object, by its (cached) box, against Clip's (int) limits. Boxes inside them stay inside when
+ * truncated, so every segment is accepted unchanged. Boxes farther than 1 from them stay outside when truncated, so every segment is rejected.
+ * 
+ * @param job Clipping job.
+ * @param box Object's box.
+ * 
+ * @returns 1 = Inside (accepted), -1 = Outside (rejected), 0 = Crossing (segments must be clipped).
+*/
+static int clip_box_test(const struct clip_job *job,
+                         const double          *box)
+{
+    if ( box[0] >= job->xmin && box[2] <= job->xmax && box[1] >= job->ymin && box[3] <= job->ymax ) return 1;
+    if ( box[2] < job->xmin - 1 || box[0] > job->xmax + 1 || box[3] < job->ymin - 1 || box[1] > job->ymax + 1 ) return -1;
 
-        array_tt p_points = polygon_get_points(foo);
+    return 0;
+}
 
-        for ( int j = 0; j < array_get_curr_num(p_points) ; j++ )
-        {   
-            struct point *p = array_get(p_points, j);
-            double new_x = -point_x_coord(array_get(p_points, j)),
-                   new_y = point_y_coord(array_get(p_points, j));
-            point_set_coord(p, new_x, new_y);;
-        }
-    }
+/**
+ * @brief (JOB) Clips candidate Lines [begin, end).
+ * 
+ * @param begin First candidate Line.
+ * @param end   One past last candidate Line.
+ * @param arg   Clipping job.
+*/
+static void clip_lines_job(int   begin,
+                           int   end,
+                           void *arg)
+{
+    struct clip_job *job = arg;
 
-    // Circumference.
-    for ( int i = 0; i < array_get_curr_num(arr_circumferences); i++ )
+    for ( int i = begin; i < end; i++ )
     {
-        circumference_tt foo = array_get(arr_circumferences, i);
-
-        point_tt *points = circumference_get_points(foo);
-
-        for ( int j = 0; j < 2; j++ )
+        line_tt foo = handle_get(objects, job->line_objs[i]);
+        const point_tt *points = line_get_points(foo);
+        struct clip_segment *seg = &job->lines[i];
+        double box[4],
+               x0, y0, x1, y1;
+        int test = 1;
+
+        if ( i >= job->in_lines )
         {
-            double new_x = -point_x_coord(points[j]),
-                   new_y = point_y_coord(points[j]);
-            point_set_coord(points[j], new_x, new_y);
+            object_box(job->line_objs[i], box);
+            test = clip_box_test(job, box);
         }
+
+        world_point(points[0], &x0, &y0);
+        world_point(points[1], &x1, &y1);
+        clip_segment_init(seg, x0, y0, x1, y1);
+        if ( test == 1 ) seg->accepted = 1;
+        else if ( test == 0 ) clip_segment(job->algorithm, seg, job->xmin, job->xmax, job->ymin, job->ymax);
     }
-    redraw_objects(Widgets.drawing_area);
-    return True;
 }
 
 /**
- * @brief Applies the XReflection in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
+ * @brief (JOB) Clips all edges of candidate Polygons [begin, end). Last edge goes from last point back to the first one.
  * 
- * @return True if code execution was correct. False otherwise
+ * @param begin First candidate Polygon.
+ * @param end   One past last candidate Polygon.
+ * @param arg   Clipping job.
 */
-Bool xreflection()
-{    
-    // Lines.
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )
-    {
-        
-        line_tt foo = array_get(arr_lines, i);
-
-        point_tt *points = line_get_points(foo);
-
-        for ( int j = 0; j < 2; j++ )
-        {
-            double new_x = point_x_coord(points[j]),
-                   new_y = -point_y_coord(points[j]);
-            point_set_coord(points[j], new_x, new_y);
-        }
-    }
+static void clip_polygons_job(int   begin,
+                              int   end,
+                              void *arg)
+{
+    struct clip_job *job = arg;
 
-    // Polygons
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
+    for ( int i = begin; i < end; i++ )
     {
-        polygon_tt foo = array_get(arr_polygons, i);
-
-        array_tt p_points = polygon_get_points(foo);
-
-        for ( int j = 0; j < array_get_curr_num(p_points) ; j++ )
-        {   
-            struct point *p = array_get(p_points, j);
-            double new_x = point_x_coord(array_get(p_points, j)),
-                   new_y = -point_y_coord(array_get(p_points, j));
-            point_set_coord(p, new_x, new_y);
+        polygon_tt foo = handle_get(objects, job->poly_objs[i]);
+        const point_tt *c_points = polygon_get_points(foo);
+        double box[4];
+        int n = polygon_num_points(foo),
+            test = 1;
+
+        // Whole Polygon is tested once, so its edges only go through clipping algorithm when it crosses Clip's border
+        if ( i >= job->in_polys )
+        {
+            object_box(job->poly_objs[i], box);
+            test = clip_box_test(job, box);
         }
-    }
-
-    // Circumference.
-    for ( int i = 0; i < array_get_curr_num(arr_circumferences); i++ )
-    {
-        circumference_tt foo = array_get(arr_circumferences, i);
-
-        point_tt *points = circumference_get_points(foo);
 
-        for ( int j = 0; j < 2; j++ )
+        for ( int j = 0; j < n; j++ )
         {
-            double new_x = point_x_coord(points[j]),
-                   new_y = -point_y_coord(points[j]);
-            point_set_coord(points[j], new_x, new_y);
+            struct clip_segment *seg = &job->edges[job->offsets[i] + j];
+            double x0, y0, x1, y1;
+
+            world_point(c_points[j], &x0, &y0);
+            world_point(c_points[(j + 1) % n], &x1, &y1);
+            clip_segment_init(seg, x0, y0, x1, y1);
+            if ( test == 1 ) seg->accepted = 1;
+            else if ( test == 0 ) clip_segment(job->algorithm, seg, job->xmin, job->xmax, job->ymin, job->ymax);
         }
     }
-
-    redraw_objects(Widgets.drawing_area);
-    return True;
 }
 
-
 /**
- * @brief Pins the first point and applies the Rotation in each point (besides the pinned one) of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
- * Since points are pinned, circumference won't be rotated (Since the first point is the center of the circumference).
+ * @brief Creates a clipped point. Clipped points are always black and taken, they are never transformed.
  * 
- * @return True if code execution was correct. False otherwise
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * 
+ * @returns A point.
 */
-Bool rotation(char *content,
-              int   transf_id)
+static point_tt clip_point(int x,
+                           int y)
 {
-    // Sanity Check
-    if ( strlen(content) == 0 ) 
-    {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide paramethers to this transformation.");
-        return False;
-    }
-    
-    double *rotation = NULL;
-    if ( (rotation = check_content(content, transf_id)) == NULL ) return False;
-
-    // Pinning first point always
-    // Lines.
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )
-    {
-        line_tt foo = array_get(arr_lines, i);
-
-        point_tt *points = line_get_points(foo);
-
-        double pinned_x = point_x_coord(points[0]),
-               pinned_y = point_y_coord(points[0]);
-
-        for ( int j = 1; j < 2; j++ )
-        {
-            double new_x = ( (point_x_coord(points[j]) - pinned_x) * cos(rotation[0])) - ( (point_y_coord(points[j]) - pinned_y) * sin(rotation[0])),
-                   new_y = ( (point_x_coord(points[j]) - pinned_x) * sin(rotation[0])) + ( (point_y_coord(points[j]) - pinned_y) * cos(rotation[0]));
-            point_set_coord(points[j], new_x + pinned_x, new_y + pinned_y);
-        }
-        
-    }
-
-    // Polygons
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
-    {
-        polygon_tt foo = array_get(arr_polygons, i);
-
-        array_tt p_points = polygon_get_points(foo);
-
-        point_tt p_pinned = array_get(p_points, 0);
-        double pinned_x = point_x_coord(p_pinned),
-               pinned_y = point_y_coord(p_pinned);
-
-        for ( int j = 1; j < array_get_curr_num(p_points) ; j++ )
-        {   
-            struct point *p = array_get(p_points, j);
-            double new_x = ( (point_x_coord(p) - pinned_x) * cos(rotation[0])) - ( (point_y_coord(p) - pinned_y) * sin(rotation[0])),
-                   new_y = ( (point_x_coord(p) - pinned_x) * sin(rotation[0])) + ( (point_y_coord(p) - pinned_y) * cos(rotation[0]));
-            point_set_coord(p, new_x + pinned_x, new_y + pinned_y);
-        }
-    }
+    point_tt p = point_create((double) x, (double) y);
+    point_define_color(p, 0.0, 0.0, 0.0);
+    point_mark(p, POINT_TAKEN | POINT_CLIPPED);
 
-    redraw_objects(Widgets.drawing_area);
-    return True;
+    return p;
 }
 
 /**
- * @brief Applies the Scale in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
- * When values specified are negative, it means to SHRINK "the objetct". Positive values means to increase it.
+ * @brief Initializes Clip Structure and operates a clipping algorithm in (already created) Lines and Polygons.
+ * Objects are split against Clip by bvh (built first if Objects were added since): Lines and Polygons inside Clip are trivially accepted,
+ * those crossing its border are clipped, every other one is just rejected, so clipping costs as much as the objects near Clip. Segments are clipped in parallel (scheduler's jobs), then clipped points 
+ * are created in candidates' order, so points' ids (indexes in point store) are the same no matter how many threads were used.
+ * 
+ * @param algorithm CLIP_COHEN_SUTHERLAND or CLIP_LIANG_BARSKY.
  * 
  * @return True if code execution was correct. False otherwise
 */
-Bool scale(char *content, 
-           int   transf_id)
+static Bool clip_objects(int algorithm)
 {
-    // Sanity Check
-    if ( strlen(content) == 0 ) 
-    {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide paramethers to this transformation.");
-        return False;
-    }
-
-    // When Scaling, whenever a value is negative, it means to SHRINK "the object". Positive values means to increase
-    double *scale = NULL;
-    if ( (scale = check_content(content, transf_id)) == NULL ) return False;
-
-
-    // Lines
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )
+    if ( !clip_structure() ) return False;
+    if ( arr_clips.size == 0 ) return False;
+    // Clipped points are created from Objects where they are now, so nothing done before can be undone
+    history_reset();
+
+    struct clip *clip = object_get(&arr_clips, 0);
+    double maxmin[4];
+    clip_get_maxmin(clip, maxmin);
+
+    struct clip_job job;
+    job.algorithm = algorithm;
+    job.xmin = (int) maxmin[0];
+    job.xmax = (int) maxmin[1];
+    job.ymin = (int) maxmin[2];
+    job.ymax = (int) maxmin[3];
+
+    // Every Line and Polygon starts rejected, candidates are overwritten below.
+    for ( int i = 0; i < arr_lines.size; i++ ) line_add_clipped_points(object_get(&arr_lines, i), POINT_NONE, POINT_NONE, 2);
+    for ( int i = 0; i < arr_polygons.size; i++ ) polygon_add_clipped_points(object_get(&arr_polygons, i), arena, NULL, 0, 2);
+
+    // Boxes inside Clip's (int) limits stay inside them when truncated, so their segments are accepted unchanged.
+    // Clip's limits are truncated to int, so crossing Objects are searched a bit beyond Clip.
+    if ( !bvh_is_built(bvh) ) bvh_build(bvh);
+    else if ( bvh_stale ) bvh_refit(bvh);
+    bvh_stale = 0;
+    double rect[4] = { job.xmin, job.ymin, job.xmax, job.ymax };
+    vector_clear(&accepted);
+    vector_clear(&candidates);
+    bvh_query(bvh, rect, 1.0, &accepted, &candidates);
+
+    int num_lines = 0,
+        num_polygons = 0,
+        total = accepted.size + candidates.size;
+    job.line_objs = (handle_tt*) temp_alloc(sizeof(handle_tt) * (total + 1));
+    job.poly_objs = (handle_tt*) temp_alloc(sizeof(handle_tt) * (total + 1));
+    job.in_lines = job.in_polys = 0;
+    for ( int i = 0; i < total; i++ )
     {
-        line_tt foo = array_get(arr_lines, i);
-        point_tt *points = line_get_points(foo);
-
-        for ( int j = 0; j < 2; j++ )
+        handle_tt h = ( i < accepted.size ) ? accepted.data[i] : candidates.data[i - accepted.size];
+        if ( handle_kind(objects, h) == OBJECT_LINE ) job.line_objs[num_lines++] = h;
+        else if ( handle_kind(objects, h) == OBJECT_POLYGON ) job.poly_objs[num_polygons++] = h;
+        if ( i < accepted.size )
         {
-            double new_x = point_x_coord(points[j]),
-                   new_y = point_y_coord(points[j]);
-            int line_algh = line_get_algh(foo);
-            if ( scale[0] < 0 ) new_x /= abs(scale[0]);
-            else new_x *= scale[0];
-            if ( scale[1] < 0 ) new_y /= abs(scale[1]);
-            else new_y *= scale[1]; 
-
-            point_set_coord(points[j], new_x, new_y);
+            job.in_lines = num_lines;
+            job.in_polys = num_polygons;
         }
     }
 
-    // Polygons
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
+    job.offsets = (int*) temp_alloc(sizeof(int) * (num_polygons + 1));
+    job.offsets[0] = 0;
+    for ( int i = 0; i < num_polygons; i++ )
+        job.offsets[i + 1] = job.offsets[i] + polygon_num_points(handle_get(objects, job.poly_objs[i]));
+    int num_edges = job.offsets[num_polygons];
+    job.lines = (struct clip_segment*) temp_alloc(sizeof(struct clip_segment) * (num_lines + 1));
+    job.edges = (struct clip_segment*) temp_alloc(sizeof(struct clip_segment) * (num_edges + 1));
+
+    materialize_world();
+    scheduler_parallel_for(scheduler, num_lines, OBJECTS_PER_JOB, clip_lines_job, &job);
+    scheduler_parallel_for(scheduler, num_polygons, OBJECTS_PER_JOB, clip_polygons_job, &job);
+
+    // Whenever you clip, new points will be CREATE!!
+    // If you don't want that, make sure to clean the canvas first.
+    double box[4];
+    for ( int i = 0; i < num_lines; i++ )
     {
-        polygon_tt foo = array_get(arr_polygons, i);
-
-        array_tt p_points = polygon_get_points(foo);
+        struct line *foo = handle_get(objects, job.line_objs[i]);
+        struct clip_segment *seg = &job.lines[i];
 
-        for ( int j = 0; j < array_get_curr_num(p_points) ; j++ )
-        {   
-            struct point *p = array_get(p_points, j);
-            double new_x = point_x_coord(array_get(p_points, j)),
-                   new_y = point_y_coord(array_get(p_points, j));
-
-            if ( scale[0] < 0 ) new_x /= abs(scale[0]);
-            else new_x *= scale[0];
-            if ( scale[1] < 0 ) new_y /= abs(scale[1]);
-            else new_y *= scale[1]; 
-            point_set_coord(p, new_x, new_y);
+        if ( seg->accepted )
+        {
+            point_tt c_pInit = clip_point(seg->x1, seg->y1),
+                     c_pFinal = clip_point(seg->x2, seg->y2);
+            line_add_clipped_points(foo, c_pInit, c_pFinal, 1);
         }
+        object_bounds(job.line_objs[i], box);
+        grid_update(grid, job.line_objs[i], box);
     }
 
-    // Circumference.
-    for ( int i = 0; i < array_get_curr_num(arr_circumferences); i++ )
+    // Polygons keep the initial point of each clipped edge, they stop being clipped at the first edge outside Clip.
+    point_tt *c_points = (point_tt*) temp_alloc(sizeof(point_tt) * (num_edges + 1));
+    for ( int i = 0; i < num_polygons; i++ )
     {
-        circumference_tt foo = array_get(arr_circumferences, i);
+        struct polygon *foo = handle_get(objects, job.poly_objs[i]);
+        int n = 0,
+            flag = 1;
 
-        point_tt *points = circumference_get_points(foo);
-
-        for ( int j = 0; j < 2; j++ )
+        for ( int j = job.offsets[i]; j < job.offsets[i + 1]; j++ )
         {
-            double new_x = point_x_coord(points[j]),
-                   new_y = point_y_coord(points[j]);
-
-            if ( scale[0] < 0 ) new_x /= abs(scale[0]);
-            else new_x *= scale[0];
-            if ( scale[1] < 0 ) new_y /= abs(scale[1]);
-            else new_y *= scale[1]; 
-
-            point_set_coord(points[j], new_x, new_y);
+            if ( !job.edges[j].accepted )
+            {
+                flag = 2;
+                break;
+            }
+            c_points[n++] = clip_point(job.edges[j].x1, job.edges[j].y1);
         }
+        polygon_add_clipped_points(foo, arena, c_points, n, flag);
+        object_bounds(job.poly_objs[i], box);
+        grid_update(grid, job.poly_objs[i], box);
     }
-    redraw_objects(Widgets.drawing_area);
+    temp_free(c_points, sizeof(point_tt) * (num_edges + 1));
 
-    free(scale);
+    redraw_objects(Widgets.drawing_area);
+    temp_free(job.line_objs, sizeof(handle_tt) * (total + 1));
+    temp_free(job.poly_objs, sizeof(handle_tt) * (total + 1));
+    temp_free(job.lines, sizeof(struct clip_segment) * (num_lines + 1));
+    temp_free(job.edges, sizeof(struct clip_segment) * (num_edges + 1));
+    temp_free(job.offsets, sizeof(int) * (num_polygons + 1));
     return True;
-
-
 }
 
 /**
- * @brief Applies the Translation in all points of all drawn objects (except Clips). After changing values, calls "redraw_objects" function to redraw everything at new position.
+ * @brief Initializes Clip Structure and operates Liang Barsky's algorithm in (already created) Lines and Polygons.
  * 
  * @return True if code execution was correct. False otherwise
 */
-Bool translation(char *content,
-                 int   transf_id)
+Bool liang_barsky_init()
 {
-    // Sanity Check
-    if ( strlen(content) == 0 ) 
-    {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must provide paramethers to this transformation.");
-        return False;
-    }
-
-    double *translation = NULL;
-    if ( (translation = check_content(content, transf_id)) == NULL ) return False;
-
-    // Lines 
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )
-    {
-        line_tt foo = array_get(arr_lines, i);
-
-        point_tt *points = line_get_points(foo);
-
-        for ( int j = 0; j < 2; j++ )
-        {
-            double new_x = point_x_coord(points[j]) + translation[0],
-                   new_y = point_y_coord(points[j]) + translation[1];
-            point_set_coord(points[j], new_x, new_y);
-        }        
-    }
-
-    // Polygons
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
-    {
-        polygon_tt foo = array_get(arr_polygons, i);
-
-        array_tt p_points = polygon_get_points(foo);
-
-        for ( int j = 0; j < array_get_curr_num(p_points) ; j++ )
-        {   
-            struct point *p = array_get(p_points, j);
-            double new_x = point_x_coord(p) + translation[0],
-                   new_y = point_y_coord(p) + translation[1];
-            point_set_coord(p, new_x, new_y);
-        }
-    }
-
-    // Circumference.
-    for ( int i = 0; i < array_get_curr_num(arr_circumferences); i++ )
-    {
-        circumference_tt foo = array_get(arr_circumferences, i);
-
-        point_tt *points = circumference_get_points(foo);
-
-        for ( int j = 0; j < 2; j++ )
-        {
-            double new_x = point_x_coord(points[j]) + translation[0],
-                   new_y = point_y_coord(points[j]) + translation[1];
-            point_set_coord(points[j], new_x, new_y);
-        }
-    }
+    return clip_objects(CLIP_LIANG_BARSKY);
+}
 
-    redraw_objects(Widgets.drawing_area);
- 
-    free(translation);
-    return True;
+/**
+ * @brief Initializes Clip Structure and operates Cohen Sutherland's algorithm in (already created) Lines and Polygons.
+ * 
+ * @return True if code execution was correct. False otherwise
+*/
+Bool cohen_init()
+{
+    return clip_objects(CLIP_COHEN_SUTHERLAND);
 }
 
 /**
- * @brief (CALL_BACK) Function called whenever an option in "Transformation"drop-down is sellected, also, the value filled in "entry" is used.
- * Defines which option of transformation (Translation, rotation, scale or refleciton) should be done.
+ * @brief (CALL_BACK) Function called whenever an option in "Croppings"drop-down is sellected.
+ * Defines which image cropping algorithm must be used. Also, when an algorithm is selected, points color should change to represent the cropping area.
  * 
  * @param dropdown Dropdown selected
- * @param entry 
 */
-static void transformation_execution(GtkDropDown *dropdown,
-                                     GtkEntry    *entry,
-                                     gpointer     user_data)
+static void cropping_selection(GtkDropDown *dropdown,
+                               gpointer     user_data)
 {
-    // Getting the content written into the entry. It's allocated in a reserved buffer
-    char *content = g_strdup(gtk_entry_buffer_get_text(user_data));
-    int dropdown_selected = gtk_drop_down_get_selected(dropdown);
-    clock_t t;
-    Bool cntrl;
+    int dropdown_selected = gtk_drop_down_get_selected(dropdown);
 
-    if ( dropdown_selected != 0 && array_get_curr_num(arr_points) == 0 )
-    {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must draw points to perform transformations.");
-        return;
-    } else if ( dropdown_selected != 0 && array_get_curr_num(arr_lines) == 0 && array_get_curr_num(arr_polygons) == 0 && array_get_curr_num(arr_circumferences) == 0 )
+    if ( dropdown_selected != 0 ) animation_finish();
+    if ( dropdown_selected != 0 && point_count() == 0 )
     {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must draw an object to perform transformations.");
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must draw points to perform clipping.");
         return;
     }
+    clock_t t;
+    Bool cntrl;
 
     switch (dropdown_selected)
     {
-        case 1:
+        case 1: 
             t = clock();
-            cntrl = translation(content, dropdown_selected);
+            cntrl = cohen_init();
             t = clock() - t;
             if ( cntrl ) write_execution_time(t);
             break;
         case 2:
             t = clock();
-            cntrl = rotation(content, dropdown_selected);
-            t = clock() - t;
-            if ( cntrl ) write_execution_time(t);
-            break;
-        case 3:
-            t = clock();
-            cntrl = scale(content, dropdown_selected);
-            t = clock() - t;
-            if ( cntrl ) write_execution_time(t);
-            break;
-        case 4:
-            t = clock();
-            cntrl = xreflection();
-            t = clock() - t;
-            if ( cntrl ) write_execution_time(t);
-            break;
-        case 5: 
-            t = clock();
-            cntrl = yreflection();
-            t = clock() - t;
-            if ( cntrl ) write_execution_time(t);
-            break;
-        case 6:
-            t = clock();
-            cntrl = xyreflection();
+            cntrl = liang_barsky_init();
             t = clock() - t;
             if ( cntrl ) write_execution_time(t);
             break;
         default:
-            gtk_label_set_label(GTK_LABEL(Widgets.label), "Debug informations here...");
-            break;
+
     }
+}   
 
+/**
+ * @brief (CALL_BACK) Function called whenever an option in "Mode" drop-down is selected.
+ * Defines what a left-click in Drawing Area does: creating points, or selecting Objects (by clicking them or dragging a rectangle around them).
+ * While any Object is selected, transformations only apply to selected Objects (clicking an empty place clears selection).
+ * 
+ * @param dropdown Dropdown selected
+*/
+static void mode_selection(GtkDropDown *dropdown,
+                           gpointer     user_data)
+{
+    mode = ( gtk_drop_down_get_selected(dropdown) == 1 ) ? MODE_SELECT : MODE_DRAW;
 }
 
-
 /**
- * @brief Creates a CLIP structure based on two points drawn by the user. Since the CLIP must have a rectangle shape, the other two points are created based on X and Y of drawn points.
- * Drawing algorithm used is DDA.
+ * @brief Groups selected Objects (and groups): they become children of a new group, which is selected instead. Group's local matrix is the identity,
+ * so nothing moves. From then on, transformations move the group as a whole, by changing a single matrix (see scene_graph.h).
  * 
  * @return True if code execution was correct. False otherwise
 */
-Bool clip_structure()
+static Bool group_selection(void)
 {
-    int controller = number_taken_points(),
-        size_p = array_get_curr_num(arr_points),
-        iterator = 0;
-
-    if ( array_get_curr_num(arr_clips) >= 1 )
-    {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You can have only 1 clip area per time.");
-        return True;
-    }
+    char result[100];
 
-    if ( controller + 4 >= MAX_POINTS )
+    if ( selection.size == 0 )
     {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: The number of points will surpass the MAX.");
-        return False;
-    }
-
-    struct point **points = (point_tt*) malloc(sizeof(point_tt) * 4);
-    struct point **aux = (point_tt*) malloc(sizeof(point_tt) * MAX_POINTS);
-    if ( (size_p - controller) >= 2 )
-    { 
-        // Adding all left points into Clip's structure.
-        while ( iterator < 2 ) 
-        {
-            point_tt p = array_get(arr_points, controller++);
-            point_take(p);
-            point_define_color(p, 255.0, 0.0, 0.0);
-            points[iterator++] = p;
-        }
-        point_tt p_first = points[0],
-                 p_third = points[1];
-
-
-        // It must be a perfect rectangle, so User must point the two oposit points, and the others will be generated based on clicked point's coordinates.
-        point_tt p_second = point_create(point_x_coord(p_third), point_y_coord(p_first));
-        point_tt p_fourth = point_create(point_x_coord(p_first), point_y_coord(p_third));
-
-        // Clip's points will always be drawn as red points, just to differentiate from others.
-        point_define_color(p_second, 255.0, 0.0, 0.0);
-        point_define_color(p_fourth, 255.0, 0.0, 0.0);
-        point_take(p_second);
-        point_take(p_fourth);
-        iterator += 2;
-
-        point_tt temp = p_third;
-        points[0] = p_first;
-        points[1] = p_second;
-        points[2] = temp;
-        points[3] = p_fourth;
-
-        int i = 0,
-            idx = 0,
-            j = 0;
-            controller = 0;   
-
-        struct clip *clip = clip_create(points, iterator, algh);
-
-        array_set(arr_clips, 0, clip);
-
-        redraw_objects(Widgets.drawing_area);
-
-        for ( int i = 0; i < iterator - 1; i++ )
-        {
-            struct point *pInit = points[i];
-            struct point *pFinal = points[i + 1];
-            point_take(pInit);
-
-            // Using only DDA, idk why.
-            DDA(pInit, pFinal, Widgets.drawing_area);
-        }
-        // Closing Clip
-        struct point *pInit = points[iterator - 1];
-        struct point *pFinal = points[0];
-
-        DDA(pInit, pFinal, Widgets.drawing_area);
-
-    }else
-    {   
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: There must be atleast 2 free points to draw a Clip.");
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must select Objects (Select Mode) to group them.");
         return False;
     }
 
+    handle_tt h = handle_alloc(objects, OBJECT_GROUP, scene);
+    scene_graph_group(scene, h, selection.data, selection.size);
+    history_begin(COMMAND_GROUP);
+    handle_tt *recorded = command_log_add_handles(history, selection.size + 1);
+    recorded[0] = h;
+    memcpy(&recorded[1], selection.data, sizeof(handle_tt) * selection.size);
+    snprintf(result, sizeof(result), "Grouped: %d Object(s).", selection.size);
+    vector_clear(&selection);
+    vector_push(&selection, h);
+    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
     return True;
 }
 
 /**
- * @brief Checks where a given DELTA(x) and DELTA(y) are related to CLIP area.
+ * @brief Splits an outermost group: its children become roots. Group's local matrix is composed with its children's ones, so nothing moves.
+ * Group's handle is not released (ungrouping may be undone).
  * 
- * @param p  DELTA(X)
- * @param q  DELTA(Y)
- * 
- * @return True if code execution was correct. False otherwise
+ * @param h        Group's handle.
+ * @param children Output: group's children are appended.
 */
-Bool clip_test(double  p,
-               double  q,
-               double *u1,
-               double *u2)
+static void ungroup_node(handle_tt       h,
+                         handle_list_tt *children)
 {
-    Bool result = True;
-    double r = 0.0f;
-
-    // Inwards - outwards
-    if ( p < 0.0f )
-    {
-        r = q / p;
-        if ( r > *u2 ) result = False;
-        else if ( r > *u1 ) *u1 = r;
-    } 
-    // Outwards - Inwards
-    else if ( p > 0.0f )
-    {
-        r = q / p;
-        if ( r < *u1 ) result = False;
-        else if ( r < *u2 ) *u2 = r;
-    } 
-    else if ( q < 0 ) result = False;
+    struct affine local = *scene_graph_local(scene, h);
+    const handle_list_tt *nodes = scene_graph_children(scene, h);
 
-    return result;
+    // Subgroups get local matrix from scene_graph_ungroup
+    for ( int i = 0; i < nodes->size; i++ )
+        if ( handle_kind(objects, nodes->data[i]) != OBJECT_GROUP ) transform_node(nodes->data[i], &local);
+    scene_graph_ungroup(scene, h, children);
 }
 
 /**
- * @brief Uses Liang Barsky's algorithm to recalculate Line's points inside a Clipped area. 
- * 
- * @param pInit  Initial Line's point.
- * @param pFinal Final Line's point.
- * @param xmin   Clip's XMIN.
- * @param xmax   Clip's XMAX.
- * @param ymin   Clip's YMIN.
- * @param ymax   Clip's YMAX.
- * @param flag   Flag. > 1 = Create just the first point (clipped_pInit), 0 = Create both points (clipped_pInit clipped_pFinal)
+ * @brief Ungroups selected groups: their children become roots and are selected instead (other selected Objects stay selected).
+ * Group's local matrix is composed with its children's ones, so nothing moves. Recorded in "history", unless a group's local matrix
+ * cannot be inverted (then nothing done before can be undone either).
  * 
- * @return New clipped points if line inside CLIPPED area. Null otherwise.
+ * @return True if code execution was correct. False otherwise
 */
-point_tt* liang_barsky(struct point *pInit,
-                       struct point *pFinal,
-                       int           xmin,
-                       int           xmax,
-                       int           ymin,
-                       int           ymax, 
-                       int           flag)
+static Bool ungroup_selection(void)
 {
-    // Because of Float-precision, values had to be rounded, otherwise code would not work.
-    int x1 = (int) point_x_coord(pInit),
-        x2 = (int) point_x_coord(pFinal),
-        y1 = (int) point_y_coord(pInit), 
-        y2 = (int) point_y_coord(pFinal);
+    char result[100];
+    struct affine inverse;
+    int n = 0,
+        size = selection.size,
+        num_groups = 0,
+        undoable = 1;
+
+    for ( int i = 0; i < size; i++ )
+    {
+        if ( handle_kind(objects, selection.data[i]) != OBJECT_GROUP ) continue;
+        num_groups++;
+        if ( !affine_invert(&inverse, scene_graph_local(scene, selection.data[i])) ) undoable = 0;
+    }
 
-    double u1 = 0.0f,
-           u2 = 1.0f;
-    double dx = (double) x2 - x1,
-           dy = (double) y2 - y1;
+    if ( num_groups == 0 )
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must select groups (Select Mode) to ungroup them.");
+        return False;
+    }
+    if ( undoable ) history_begin(COMMAND_UNGROUP);
+    else history_reset();
 
-    point_tt *points = (point_tt*) malloc(sizeof(point_tt) * 2);
-    point_tt c_pInit,
-             c_pFinal;
-    if ( clip_test(-dx, x1 - xmin, &u1, &u2) )
+    for ( int i = 0; i < size; i++ )
     {
-        if ( clip_test(dx, xmax - x1, &u1, &u2) )
+        handle_tt h = selection.data[i];
+        if ( handle_kind(objects, h) != OBJECT_GROUP )
         {
-            if ( clip_test(-dy, y1 - ymin, &u1, &u2) )
-            {
-                if ( clip_test(dy, ymax - y1, &u1, &u2 ) )
-                {
-                    if ( floor(u2) < 1.0f )
-                    {
-                        x2 = (int) x1 + u2 * dx;
-                        y2 = (int) y1 + u2 * dy;
-                    }
-                    if ( ceil(u1) > 0.0f )
-                    {
-                        x1 = (int) x1 + u1 * dx;
-                        y1 = (int) y1 + u1 * dy;
-                    }
-                    if ( flag >= 0 )
-                    {
-                        c_pInit = point_create((double) x1, (double)y1);
-                        points[0] = c_pInit;
-                        if ( flag == 0 )
-                        {
-                            c_pFinal = point_create((double)x2, (double)y2);
-                            points[1] = c_pFinal;
-                            point_define_color(c_pFinal, 0.0, 0.0, 0.0);
-                            point_take(c_pFinal);
-                            array_set(arr_points, array_get_curr_num(arr_points), c_pFinal);
-                        }
-                        point_define_color(c_pInit, 0.0, 0.0, 0.0);
-                        point_take(c_pInit);
-
-                        array_set(arr_points, array_get_curr_num(arr_points), c_pInit); 
-                    }
-                    return points;
-                }
-            }
+            selection.data[n++] = h;
+            continue;
+        }
+
+        // Each group is recorded as itself, its children and HANDLE_NONE
+        if ( undoable )
+        {
+            const handle_list_tt *children = scene_graph_children(scene, h);
+            handle_tt *recorded = command_log_add_handles(history, children->size + 2);
+            recorded[0] = h;
+            memcpy(&recorded[1], children->data, sizeof(handle_tt) * children->size);
+            recorded[children->size + 1] = HANDLE_NONE;
+            *command_log_add_matrices(history, 1) = *scene_graph_local(scene, h);
         }
+
+        // Children are appended to selection, after every selected root
+        ungroup_node(h, &selection);
+        if ( !undoable ) handle_release(objects, h);
     }
-    return NULL;
+
+    // Moving children where ungrouped groups were
+    for ( int i = size; i < selection.size; i++ ) selection.data[n++] = selection.data[i];
+    selection.size = n;
+    snprintf(result, sizeof(result), "Ungrouped: %d group(s).", num_groups);
+    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+    return True;
 }
 
 /**
- * @brief Initializes Clip Structure and operates Liang Barsky's algorithm in (already created) Lines and Polygons.
+ * @brief Applies a recorded transformation again, or its inverse (see COMMAND_TRANSFORM): to every root, with the same path as chain
+ * (see "transform_all"), or only to recorded roots (see "transform_roots").
  * 
- * @return True if code execution was correct. False otherwise
+ * @param c      Given command.
+ * @param undo   If it is undone.
+ * @param damage Output: area (xmin, ymin, xmax, ymax) covered by transformed roots before and after. Set if 2 is returned.
+ * 
+ * @returns 1 if all Objects were transformed, 2 if only some roots.
 */
-Bool liang_barsky_init()
+static int history_transform(const struct command *c,
+                             int                   undo,
+                             double               *damage)
 {
-    if ( !clip_structure() ) return False;
-    if ( array_get_curr_num(arr_clips) == 0 ) return False;
-
-    struct clip *clip = array_get(arr_clips, 0);
-    double *maxmin = clip_get_maxmin(clip);
-
-    int xmin = (int) maxmin[0],
-        xmax = (int) maxmin[1],
-        ymin = (int) maxmin[2],
-        ymax = (int) maxmin[3];
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )
+    bvh_stale = 1;
+    if ( c->num_handles == 0 )
     {
-        
-        struct line *foo = array_get(arr_lines, i);
-        point_tt *points = line_get_points(foo);
-
-        struct point *pInit = points[0];
-        struct point *pFinal = points[1];
-        // Whenever you call liang barsky, a new point will be CREATE!!
-        // If you don't want that, make sure to clean the canvas first.
-        points = liang_barsky(pInit, pFinal, xmin, xmax, ymin, ymax, 0);
-        if ( points != NULL ) line_add_clipped_points(foo, points[0], points[1], 1);
-        else line_add_clipped_points(foo, NULL, NULL, 2);
-
-    } 
+        struct affine m = c->matrices[0];
+        if ( undo ) affine_invert(&m, &m);
+        affine_chain_clear(chain);
+        affine_chain_push(chain, &m, 0);
+        transform_all();
+        return 1;
+    }
 
-    struct point *pInit;
-    struct point *pFinal;
-    Bool aux = False;
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
-    {
-        aux = False;
-        struct polygon *foo = array_get(arr_polygons, i);
-        point_tt *points = (point_tt*) malloc(sizeof(point_tt) * 2);
-        array_tt c_points = polygon_get_points(foo);
-        
-        // Whenever you call liang barsky, a new point will be CREATE!!
-        // If you don't want that, make sure to clean the canvas first.
-        for ( int j = 0; j < array_get_curr_num(c_points) - 1; j++ )
-        {
-            pInit = array_get(c_points, j);
-            pFinal = array_get(c_points, j + 1);
-            points = liang_barsky(pInit, pFinal, xmin, xmax, ymin, ymax, 1);
-            if ( points != NULL ) polygon_add_clipped_points(foo, points, 1, 1);
-            else
-            { 
-                aux = True;
-                polygon_add_clipped_points(foo, NULL, 1, 2);
-                break;
-            }
-        }
-        if ( aux ) continue;
-        pInit = array_get(c_points, array_get_curr_num(c_points) - 1);
-        pFinal = array_get(c_points, 0);
-        points = liang_barsky(pInit, pFinal, xmin, xmax, ymin, ymax, 1);
-        if ( points != NULL ) polygon_add_clipped_points(foo, points, 1, 1);
-        else
-        {
-            polygon_add_clipped_points(foo, NULL, 1, 2);        
-            continue;
-        }
-    }    redraw_objects(Widgets.drawing_area);
-    free(maxmin);
-    return True;
+    struct transform_job job = { c->handles, c->matrices, c->num_matrices == 1, undo, NULL };
+    transform_roots(&job, c->num_handles, damage);
+    return 2;
 }
 
 /**
- * @brief Calculate the "Binary" code based in Point XY and where they are related to CLIP area, used in Cohen Sutherland's algorithm.
+ * @brief Undoes a recorded ungrouping: each group takes its children back and gets its local matrix again, which is taken out of its children first,
+ * so nothing moves (see COMMAND_UNGROUP).
  * 
- * @param x    Point's X coordinate.
- * @param y    Point's Y coordinate.
- * @param xmin Clips's XMIN.
- * @param xmax Clips's XMAX.
- * @param ymin Clips's YMIN.
- * @param ymax Clips's YMAX.
- * 
- * @returns 
+ * @param c Given command.
 */
-int region_code(int x, 
-                int y,
-                int xmin,
-                int xmax,
-                int ymin, 
-                int ymax)
+static void history_regroup(const struct command *c)
 {
-    int codigo = 0;
-
-    // Left - Bit 0
-    if ( x < xmin ) codigo += 1;
-    // Right - Bit 1
-    if ( x > xmax ) codigo += 2;
-    // Down - Bit 2
-    if ( y < ymin ) codigo += 4;
-    // Up - Bit 3
-    if ( y > ymax ) codigo += 8;
+    struct affine inverse;
+    int first = 0,
+        k = 0;
 
-    return codigo;
+    while ( first < c->num_handles )
+    {
+        // Children are [first + 1, end)
+        int end = first + 1;
+        while ( c->handles[end] != HANDLE_NONE ) end++;
+
+        affine_invert(&inverse, &c->matrices[k]);
+        for ( int j = first + 1; j < end; j++ ) transform_node(c->handles[j], &inverse);
+        scene_graph_group(scene, c->handles[first], &c->handles[first + 1], end - first - 1);
+        scene_graph_transform(scene, c->handles[first], &c->matrices[k++]);
+        first = end + 1;
+    }
 }
 
 /**
- * @brief Uses Cohen Sutherland's algorithm to recalculate Line's points inside a Clipped area. 
+ * @brief Undoes the last command done, or redoes the last one undone (see command_log.h). Selection is emptied (it may hold Objects
+ * that are taken out, or groups that are split). Only the area of affected Objects (and of old selection) is redrawn, unless every Object was transformed.
+ * Writes in "label" what was undone or redone, and how many commands are left and how much memory "history" takes.
  * 
- * @param pInit  Initial Line's point.
- * @param pFinal Final Line's point.
- * @param xmin   Clip's XMIN.
- * @param xmax   Clip's XMAX.
- * @param ymin   Clip's YMIN.
- * @param ymax   Clip's YMAX.
- * @param flag   Flag. > 1 = Create just the first point (clipped_pInit), 0 = Create both points (clipped_pInit clipped_pFinal)
+ * @param undo If last command done is undone (1), or last one undone is redone (0).
  * 
- * @return New clipped points if line inside CLIPPED area. Null otherwise.
+ * @return True if there was a command, False otherwise.
 */
-point_tt* cohen_sutherland(struct point *pInit,
-                           struct point *pFinal,
-                           int           xmin,
-                           int           xmax,
-                           int           ymin,
-                           int           ymax, 
-                           int           flag)
+static Bool history_step(int undo)
 {
-    // Because of Float-precision, values had to be rounded, otherwise code would not work.
-    int x1 = (int) point_x_coord(pInit),
-        x2 = (int) point_x_coord(pFinal),
-        y1 = (int) point_y_coord(pInit), 
-        y2 = (int) point_y_coord(pFinal);
-
-    int c1 = 0,
-        c2 = 0,
-        cfora = 0;
-    int xint = 0,
-        yint = 0;
-    Bool aceite = False,
-         feito = False;
-    
-    point_tt *points = (point_tt*) malloc(sizeof(point_tt) * 2);
-    struct point *c_pInit;
-    struct point *c_pFinal;
+    static const char *names[] = { "", "Transformation", "Creation", "Grouping", "Ungrouping" };
+    struct command c;
+    char result[200];
+    double damage[4],
+           box[4];
+    int applied = 2;
+
+    if ( !( undo ? command_log_undo(history, &c) : command_log_redo(history, &c) ) )
+    {
+        gtk_label_set_label(GTK_LABEL(Widgets.label), undo ? "WARNING: There is nothing to undo." : "WARNING: There is nothing to redo.");
+        return False;
+    }
 
-    while ( !feito )
-    {   
-        c1 = region_code(x1, y1, xmin, xmax, ymin, ymax);
-        c2 = region_code(x2, y2, xmin, xmax, ymin, ymax);
-        // Fully-in
-        if ( c1 == 0 && c2 == 0 )
-        {    
-            if ( flag >= 0 )
+    // Grouping and ungrouping move nothing, only selection's highlight goes away
+    selection_bounds(damage);
+    vector_clear(&selection);
+    box[0] = box[1] = INFINITY;
+    box[2] = box[3] = -INFINITY;
+    vector_clear(&leaves);
+    switch ( c.type )
+    {
+        case COMMAND_TRANSFORM:
+            applied = history_transform(&c, undo, box);
+            break;
+        case COMMAND_CREATE:
+            // Objects are taken out in reverse order, so each one is the last of its list
+            if ( undo ) roots_bounds(c.handles, c.num_handles, box);
+            for ( int i = 0; i < c.num_handles; i++ )
             {
-                c_pInit = point_create((double) x1, (double)y1);
-                points[0] = c_pInit;
-                if ( flag == 0 )
-                {
-                    c_pFinal = point_create((double)x2, (double)y2);
-                    points[1] = c_pFinal;
-                    point_define_color(c_pFinal, 0.0, 0.0, 0.0);
-                    point_take(c_pFinal);
-                    array_set(arr_points, array_get_curr_num(arr_points), c_pFinal);
-                }
-                point_define_color(c_pInit, 0.0, 0.0, 0.0);
-                point_take(c_pInit);
-
-                array_set(arr_points, array_get_curr_num(arr_points), c_pInit); 
+                if ( undo ) object_remove(c.handles[c.num_handles - 1 - i]);
+                else object_restore(c.handles[i]);
             }
-            
-
-
-            aceite = True;
-            feito = True;
-        } 
-        // Segment Fully-out
-        else if ( (c1 & c2) != 0 )
-        {
-            feito = True;
-        } else 
-        {
-            if ( c1 != 0 ) {
-                cfora = c1;
-
-            } 
+            if ( !undo ) roots_bounds(c.handles, c.num_handles, box);
+            bvh_stale = 1;
+            break;
+        case COMMAND_GROUP:
+            if ( undo ) ungroup_node(c.handles[0], &leaves);
+            else scene_graph_group(scene, c.handles[0], &c.handles[1], c.num_handles - 1);
+            break;
+        case COMMAND_UNGROUP:
+            if ( undo ) history_regroup(&c);
             else
-            {
-                cfora = c2;
-            }
-
-
-            // Left Lim
-            if ( (cfora & 1) == 1 )
-            {
-                xint = xmin;
-                yint = (int) y1 + ( y2 - y1 ) * ( xmin - x1 ) / ( x2 - x1 );
-            }
-            // Right Lim
-            else if ( (cfora & 2) == 2 )
-            {
-                // g_print("Entrei aqui né krl\n");
-                xint = xmax; 
-                yint = (int) y1 + ( y2 - y1 ) * ( xmax - x1 ) / ( x2 - x1 );
-            }
-            // Dowm Lim
-            else if ( (cfora & 4) == 4)
-            {
-                yint = ymin;
-                xint = (int) x1 + ( x2 - x1 ) * ( ymin - y1 ) / ( y2 - y1 );
-            }
-            // Up Lim.
-            else if ( (cfora & 8) == 8)
-            {
-                yint = ymax;
-                xint = (int) x1 + ( x2 - x1 ) * ( ymax - y1 ) / ( y2 - y1 );
-            }
-
-            if ( cfora == c1 )
-            {
-                x1 = round(xint);
-                y1 = round(yint);
-            } else
-            {
-                x2 =round(xint);
-                y2 = round(yint);
-            }
-        }
+                for ( int i = 0; i < c.num_handles; i++ )
+                {
+                    ungroup_node(c.handles[i], &leaves);
+                    while ( c.handles[i] != HANDLE_NONE ) i++;
+                }
+            break;
     }
 
-    if ( aceite )
-    {   
-        return points;    
+    if ( applied == 2 )
+    {
+        box_union(damage, box);
+        if ( damage[0] <= damage[2] ) transform_redraw(applied, damage);
     }
-    return NULL;
-} 
+    else transform_redraw(applied, damage);
+
+    snprintf(result, sizeof(result), "%s: %s (%d handle(s)). History: %d to undo, %d to redo, %zu bytes.", undo ? "Undone" : "Redone",
+             names[c.type], c.num_handles, command_log_position(history), command_log_size(history) - command_log_position(history),
+             command_log_bytes(history));
+    gtk_label_set_label(GTK_LABEL(Widgets.label), result);
+    return True;
+}
 
 /**
- * @brief Initializes Clip Structure and operates Cohen Sutherland's algorithm in (already created) Lines and Polygons.
+ * @brief (CALL_BACK) Function called whenever an option in "Edit" drop-down is selected. Groups or ungroups selected Objects, then redraws
+ * the area of selection (its boxes are highlighted), or undoes or redoes last command (see "history_step"). Dropdown goes back to "Edit", so the same option can be chosen again.
  * 
- * @return True if code execution was correct. False otherwise
+ * @param dropdown Dropdown selected
 */
-Bool cohen_init()
+static void edit_selection(GtkDropDown *dropdown,
+                           gpointer     user_data)
 {
-    if ( !clip_structure() ) return False;
-    if ( array_get_curr_num(arr_clips) == 0 ) return False;
+    int dropdown_selected = gtk_drop_down_get_selected(dropdown);
+    double damage[4];
+    Bool cntrl = False;
 
-    struct clip *clip = array_get(arr_clips, 0);
-    double *maxmin = clip_get_maxmin(clip);
+    // Grouping, ungrouping, undoing and redoing start where current animation ends
+    if ( dropdown_selected != 0 ) animation_finish();
 
-    int xmin = (int) maxmin[0],
-        xmax = (int) maxmin[1],
-        ymin = (int) maxmin[2],
-        ymax = (int) maxmin[3];
-    for ( int i = 0; i < array_get_curr_num(arr_lines); i++ )
+    switch (dropdown_selected)
     {
-        
-        struct line *foo = array_get(arr_lines, i);
-        point_tt *points = line_get_points(foo);
-
-        struct point *pInit = points[0];
-        struct point *pFinal = points[1];
-        // Whenever you call cohen_sutherlnad, a new point will be CREATE!!
-        // If you don't want that, make sure to clean the canvas first.
-        points = cohen_sutherland(pInit, pFinal, xmin, xmax, ymin, ymax, 0);
-        if ( points != NULL ) line_add_clipped_points(foo, points[0], points[1], 1);
-        else line_add_clipped_points(foo, NULL, NULL, 2);
-
-    } 
+        case 1:
+            cntrl = group_selection();
+            break;
+        case 2:
+            cntrl = ungroup_selection();
+            break;
+        case 3:
+        case 4:
+            // Undoing and redoing redraw what they touch
+            history_step(dropdown_selected == 3);
+            gtk_drop_down_set_selected(dropdown, 0);
+            return;
+        default:
+            return;
+    }
 
-    struct point *pInit;
-    struct point *pFinal;
-    Bool aux = False;
-    for ( int i = 0; i < array_get_curr_num(arr_polygons); i++ )
+    if ( cntrl )
     {
-        aux = False;
-        struct polygon *foo = array_get(arr_polygons, i);
-        point_tt *points = (point_tt*) malloc(sizeof(point_tt) * 2);
-        array_tt c_points = polygon_get_points(foo);
-
-        for ( int j = 0; j < array_get_curr_num(c_points) - 1; j++ )
-        {
-            pInit = array_get(c_points, j);
-            pFinal = array_get(c_points, j + 1);
-            // Whenever you call cohen_sutherlnad, a new point will be CREATE!!
-            // If you don't want that, make sure to clean the canvas first.
-            points = cohen_sutherland(pInit, pFinal, xmin, xmax, ymin, ymax, 1);
-            if ( points != NULL ) polygon_add_clipped_points(foo, points, 1, 1);
-            else
-            { 
-                aux = True;
-                polygon_add_clipped_points(foo, NULL, 1, 2);
-                break;
-            }
-        }
-        if ( aux ) continue;
-        pInit = array_get(c_points, array_get_curr_num(c_points) - 1);
-        pFinal = array_get(c_points, 0);
-        points = cohen_sutherland(pInit, pFinal, xmin, xmax, ymin, ymax, 1);
-        if ( points != NULL ) polygon_add_clipped_points(foo, points, 1, 1);
-        else
-        {
-            polygon_add_clipped_points(foo, NULL, 1, 2);        
-            continue;
-        }
+        selection_bounds(damage);
+        if ( damage[0] <= damage[2] ) redraw_region(Widgets.drawing_area, damage);
     }
-
-
-    redraw_objects(Widgets.drawing_area);
-    free(maxmin);
-    return True;
+    gtk_drop_down_set_selected(dropdown, 0);
 }
 
 /**
- * @brief (CALL_BACK) Function called whenever an option in "Croppings"drop-down is sellected.
- * Defines which image cropping algorithm must be used. Also, when an algorithm is selected, points color should change to represent the cropping area.
+ * @brief (CALL_BACK) Function called whenever an option in "Rendering"drop-down is sellected.
+ * Defines how drawings are rasterized: by the render thread alone, split into tiles rasterized in parallel,
+ * or a few at a time in every frame (so huge scenes fill in progressively without freezing the window).
  * 
  * @param dropdown Dropdown selected
 */
-static void cropping_selection(GtkDropDown *dropdown,
-                               gpointer     user_data)
+static void rendering_selection(GtkDropDown *dropdown,
+                                gpointer     user_data)
 {
     int dropdown_selected = gtk_drop_down_get_selected(dropdown);
 
-    if ( dropdown_selected != 0 && array_get_curr_num(arr_points) == 0 )
-    {
-        gtk_label_set_label(GTK_LABEL(Widgets.label), "WARNING: You must draw points to perform clipping.");
-        return;
-    }
-    clock_t t;
-    Bool cntrl;
-
     switch (dropdown_selected)
     {
-        case 1: 
-            t = clock();
-            cntrl = cohen_init();
-            t = clock() - t;
-            if ( cntrl ) write_execution_time(t);
+        case 1:
+            renderer_set_mode(renderer, RENDER_SINGLE);
             break;
         case 2:
-            t = clock();
-            cntrl = liang_barsky_init();
-            t = clock() - t;
-            if ( cntrl ) write_execution_time(t);
+            renderer_set_mode(renderer, RENDER_TILED);
+            break;
+        case 3:
+            renderer_set_mode(renderer, RENDER_SLICED);
             break;
         default:
-
+            return;
     }
-}   
+    redraw_objects(Widgets.drawing_area);
+}
 
 /**
  * @brief Used to get User's screen config in order to draw canvas in a bigger size.
@@ -2054,8 +3402,11 @@ static void activate(GtkApplication *app,
 {
     const char *dropdown_content_algorithms[4] = {"Drawing Algorithms\0", "DDA\0", "Bresenham\0"};
     const char *dropdown_content_drawings[5] = {"Objects\0", "Line\0", "Polygon\0", "Circumference\0"};
-    const char *dropdown_content_transformations[8] = {"Geometric Transformations\0", "Translate\0", "Rotate\0", "Scale\0", "X Reflection\0", "Y Reflection\0", "XY Reflection\0"};
+    const char *dropdown_content_transformations[10] = {"Geometric Transformations\0", "Translate\0", "Rotate\0", "Scale\0", "X Reflection\0", "Y Reflection\0", "XY Reflection\0", "Run Script\0", "Animate Script\0"};
     const char *dropdown_content_croppings[5] = {"Clipping Algorithms\0", "Cohen-Sutherland\0", "Liang-Barsky\0"};
+    const char *dropdown_content_renderings[5] = {"Rendering\0", "Single Thread\0", "Tiled\0", "Time-sliced\0"};
+    const char *dropdown_content_modes[3] = {"Draw Mode\0", "Select Mode\0"};
+    const char *dropdown_content_edits[6] = {"Edit\0", "Group Selection\0", "Ungroup Selection\0", "Undo\0", "Redo\0"};
 
     int width,
         height;
@@ -2081,6 +3432,7 @@ static void activate(GtkApplication *app,
     gtk_widget_set_size_request(Widgets.drawing_area, width, ((height * 91) / 100));
     gtk_frame_set_child(GTK_FRAME(Widgets.frame), Widgets.drawing_area);
 
+    renderer = renderer_create(Widgets.drawing_area, scheduler, width, ((height * 91) / 100));
     gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(Widgets.drawing_area), draw_cb, NULL, NULL);
     g_signal_connect_after(Widgets.drawing_area, "resize", G_CALLBACK(resize_cb), NULL);
 
@@ -2088,6 +3440,7 @@ static void activate(GtkApplication *app,
     gtk_gesture_single_set_button(GTK_GESTURE_SINGLE(Widgets.drag), GDK_BUTTON_PRIMARY);
     gtk_widget_add_controller(Widgets.drawing_area, GTK_EVENT_CONTROLLER(Widgets.drag));
     g_signal_connect(Widgets.drag, "drag-begin", G_CALLBACK(draw), Widgets.drawing_area); 
+    g_signal_connect(Widgets.drag, "drag-end", G_CALLBACK(select_end), Widgets.drawing_area);
 
     Widgets.press = gtk_gesture_click_new();
     gtk_gesture_single_set_button(GTK_GESTURE_SINGLE(Widgets.press), GDK_BUTTON_SECONDARY);
@@ -2111,6 +3464,15 @@ static void activate(GtkApplication *app,
     Widgets.dropdown_croppings = gtk_drop_down_new_from_strings(dropdown_content_croppings);
     gtk_box_append(GTK_BOX(Widgets.option_box), Widgets.dropdown_croppings);
 
+    Widgets.dropdown_renderings = gtk_drop_down_new_from_strings(dropdown_content_renderings);
+    gtk_box_append(GTK_BOX(Widgets.option_box), Widgets.dropdown_renderings);
+
+    Widgets.dropdown_modes = gtk_drop_down_new_from_strings(dropdown_content_modes);
+    gtk_box_append(GTK_BOX(Widgets.option_box), Widgets.dropdown_modes);
+
+    Widgets.dropdown_edits = gtk_drop_down_new_from_strings(dropdown_content_edits);
+    gtk_box_append(GTK_BOX(Widgets.option_box), Widgets.dropdown_edits);
+
     Widgets.entry_buffer = gtk_entry_buffer_new(NULL, -1);
     Widgets.main_input = gtk_entry_new_with_buffer(Widgets.entry_buffer);
     gtk_entry_set_placeholder_text(GTK_ENTRY(Widgets.main_input), "Transformation values here...");
@@ -2124,6 +3486,9 @@ static void activate(GtkApplication *app,
     g_signal_connect(Widgets.dropdown_drawings, "notify::selected", G_CALLBACK(drawings_execution), GTK_DRAWING_AREA(Widgets.drawing_area));
     g_signal_connect(Widgets.dropdown_transformations, "notify::selected", G_CALLBACK(transformation_execution), Widgets.entry_buffer);
     g_signal_connect(Widgets.dropdown_croppings, "notify::selected", G_CALLBACK(cropping_selection), NULL);
+    g_signal_connect(Widgets.dropdown_renderings, "notify::selected", G_CALLBACK(rendering_selection), NULL);
+    g_signal_connect(Widgets.dropdown_modes, "notify::selected", G_CALLBACK(mode_selection), NULL);
+    g_signal_connect(Widgets.dropdown_edits, "notify::selected", G_CALLBACK(edit_selection), NULL);
     gtk_window_present(GTK_WINDOW(Widgets.window));
 
 }
@@ -2133,11 +3498,41 @@ int main(int    argc,
 {
     GtkApplication *app;
     int status;
-    arr_points = array_create(MAX_POINTS);
-    arr_lines = array_create(MAX_POINTS);
-    arr_polygons = array_create(MAX_POINTS);
-    arr_circumferences = array_create(MAX_POINTS);
-    arr_clips = array_create(MAX_POINTS);
+    memstat_dump_on_exit();
+    vector_init(&arr_lines);
+    vector_init(&arr_polygons);
+    vector_init(&arr_circumferences);
+    vector_init(&arr_clips);
+    vector_reserve(&arr_lines, INITIAL_OBJECTS);
+    vector_reserve(&arr_polygons, INITIAL_OBJECTS);
+    vector_reserve(&arr_circumferences, INITIAL_OBJECTS);
+    vector_reserve(&arr_clips, INITIAL_OBJECTS);
+    vector_init(&candidates);
+    vector_reserve(&candidates, INITIAL_OBJECTS);
+    vector_init(&accepted);
+    vector_init(&selection);
+    vector_init(&leaves);
+    vector_init(&roots);
+    vector_init(&animation.steps);
+    vector_init(&animation.roots);
+    vector_init(&animation.states);
+    vector_init(&animation.deltas);
+    animation.chain = affine_chain_create();
+    animation.tick = 0;
+    vector_init(&world_x);
+    vector_init(&world_y);
+    vector_init(&world_offsets);
+    vector_reserve(&accepted, INITIAL_OBJECTS);
+    objects = handle_table_create(INITIAL_OBJECTS);
+    grid = grid_create(GRID_CELL_SIZE);
+    free_points = grid_create(GRID_CELL_SIZE);
+    bvh = bvh_create(INITIAL_OBJECTS);
+    scene = scene_graph_create();
+    history = command_log_create();
+    chain = affine_chain_create();
+    script = transform_script_create();
+    arena = arena_create(ARENA_CHUNK_SIZE);
+    scheduler = scheduler_create(0);
 
     app = gtk_application_new("GC.Thiago", G_APPLICATION_FLAGS_NONE);
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
@@ -0,0 +1,572 @@
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#include "color.h"
+#include "raster.h"
+
+/**
+ * @brief Using Cairo, draws a rectangle in given positions with thickness of RASTER_BRUSH_SIZE.
+ *
+ * @param cr   Cairo context.
+ * @param view Canvas' origin.
+ * @param x    X coordinate.
+ * @param y    Y coordinate.
+ * @param c    Color (packed RGBA).
+*/
+void raster_brush(cairo_t                  *cr,
+                  const struct raster_view *view,
+                  double                    x,
+                  double                    y,
+                  uint32_t                  c)
+{
+    double px = (x + view->center_x) - (RASTER_BRUSH_SIZE / 2),
+           py = (view->center_y - y) - (RASTER_BRUSH_SIZE / 2);
+
+    // Outside rasterized area, nothing to plot.
+    if ( px + RASTER_BRUSH_SIZE < view->clip_x0 || px > view->clip_x1 || py + RASTER_BRUSH_SIZE < view->clip_y0 || py > view->clip_y1 ) return;
+
+    cairo_set_source_rgba(cr, COLOR_RED_OF(c) / 255.0, COLOR_GREEN_OF(c) / 255.0, COLOR_BLUE_OF(c) / 255.0, COLOR_ALPHA_OF(c) / 255.0);
+    cairo_rectangle(cr, px, py, RASTER_BRUSH_SIZE, RASTER_BRUSH_SIZE);
+    cairo_fill(cr);
+}
+
+/**
+ * @brief Computes where (in canvas' coordinates, Y up) a brush must be plotted to touch view's rasterized area, grown by a margin.
+ *
+ * @param view   Canvas' origin and rasterized area.
+ * @param margin Margin, in pixels (e.g. for rounding of plotted coordinates).
+ * @param box    Output: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+*/
+static void raster_view_bounds(const struct raster_view *view,
+                               double                    margin,
+                               double                   *box)
+{
+    double half = RASTER_BRUSH_SIZE / 2;
+
+    box[0] = ((double) view->clip_x0 - view->center_x) + half - RASTER_BRUSH_SIZE - margin;
+    box[1] = ((double) view->center_y - view->clip_y1) - half - margin;
+    box[2] = ((double) view->clip_x1 - view->center_x) + half + margin;
+    box[3] = ((double) view->center_y - view->clip_y0) - half + RASTER_BRUSH_SIZE + margin;
+}
+
+/**
+ * @brief Clips a segment against a rectangle with Liang-Barsky's parametric test: segment is P(u) = (x0, y0) + u * (x1 - x0, y1 - y0), u in [0, 1].
+ *
+ * @param x0   Initial X coordinate.
+ * @param y0   Initial Y coordinate.
+ * @param x1   Final X coordinate.
+ * @param y1   Final Y coordinate.
+ * @param rect Rectangle: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+ * @param u    Output: part of segment inside rectangle, [u[0], u[1]].
+ *
+ * @returns If segment touches rectangle. 0 = No, 1 = Yes.
+*/
+int raster_clip_segment(double        x0,
+                        double        y0,
+                        double        x1,
+                        double        y1,
+                        const double *rect,
+                        double       *u)
+{
+    double dx = x1 - x0,
+           dy = y1 - y0,
+           p[4] = { -dx, dx, -dy, dy },
+           q[4] = { x0 - rect[0], rect[2] - x0, y0 - rect[1], rect[3] - y0 };
+
+    u[0] = 0.0;
+    u[1] = 1.0;
+    for ( int i = 0; i < 4; i++ )
+    {
+        if ( p[i] == 0.0 )
+        {
+            if ( q[i] < 0.0 ) return 0;
+            continue;
+        }
+        double r = q[i] / p[i];
+        if ( p[i] < 0.0 ) { if ( r > u[1] ) return 0; if ( r > u[0] ) u[0] = r; }
+        else { if ( r < u[0] ) return 0; if ( r < u[1] ) u[1] = r; }
+    }
+    return 1;
+}
+
+/**
+ * @brief Computes which steps of a line may plot a brush inside view's rasterized area (e.g. a tile), so a line crossing many tiles
+ * only steps through its part in each one. Step i plots the line's point at u = i / iterations, rounded, so it is never farther than a pixel from it.
+ *
+ * @param view       Canvas' origin and rasterized area.
+ * @param xi         Initial X coordinate.
+ * @param yi         Initial Y coordinate.
+ * @param xf         Final X coordinate.
+ * @param yf         Final Y coordinate.
+ * @param iterations Number of steps.
+ * @param first      Output: first step (from 1).
+ * @param last       Output: last step.
+ *
+ * @returns If any step may touch rasterized area. 0 = No, 1 = Yes.
+*/
+static int raster_line_steps(const struct raster_view *view,
+                             double                    xi,
+                             double                    yi,
+                             double                    xf,
+                             double                    yf,
+                             int                       iterations,
+                             int                      *first,
+                             int                      *last)
+{
+    double box[4],
+           u[2];
+
+    raster_view_bounds(view, 1.0, box);
+    if ( !raster_clip_segment(xi, yi, xf, yf, box, u) ) return 0;
+
+    *first = ( u[0] * iterations > 1.0 ) ? (int) floor(u[0] * iterations) : 1;
+    *last = ( u[1] * iterations < iterations ) ? (int) ceil(u[1] * iterations) : iterations;
+    return ( *first <= *last );
+}
+
+/**
+ * @brief Uses DDA algorithm to draw a line between two points.
+ *
+ * @param cr   Cairo context.
+ * @param view Canvas' origin.
+ * @param xi   Initial X coordinate.
+ * @param yi   Initial Y coordinate.
+ * @param xf   Final X coordinate.
+ * @param yf   Final Y coordinate.
+ * @param c    Color (packed RGBA).
+*/
+void raster_dda(cairo_t                  *cr,
+                const struct raster_view *view,
+                double                    xi,
+                double                    yi,
+                double                    xf,
+                double                    yf,
+                uint32_t                  c)
+{
+    double x_var = xf - xi,
+           y_var = yf - yi,
+           x_incr = 0.0f,
+           y_incr = 0.0f,
+           x_aux = 0.0f,
+           y_aux = 0.0f;
+    int    iterations = 0;
+
+    if ( abs((int) x_var) > abs((int) y_var) ) iterations = abs((int) x_var);
+    else iterations = abs((int) y_var);
+
+    if ( iterations == 0 ) return;
+
+    x_incr = x_var / iterations;
+    y_incr = y_var / iterations;
+
+    // Each step's point is computed from its index, so stepping may start at any step: only those inside rasterized area are taken
+    int first, last;
+    if ( !raster_line_steps(view, xi, yi, xf, yf, iterations, &first, &last) ) return;
+
+    for ( int i = first; i <= last; i++ )
+    {
+        x_aux = xi + i * x_incr;
+        y_aux = yi + i * y_incr;
+        raster_brush(cr, view, (double) round(x_aux), (double) round(y_aux), c);
+    }
+}
+
+/**
+ * @brief Uses bresenham algorithm to draw a line between two points.
+ *
+ * @param cr   Cairo context.
+ * @param view Canvas' origin.
+ * @param x_i  Initial X coordinate.
+ * @param y_i  Initial Y coordinate.
+ * @param x_f  Final X coordinate.
+ * @param y_f  Final Y coordinate.
+ * @param c    Color (packed RGBA).
+*/
+void raster_bresenham(cairo_t                  *cr,
+                      const struct raster_view *view,
+                      double                    x_i,
+                      double                    y_i,
+                      double                    x_f,
+                      double                    y_f,
+                      uint32_t                  c)
+{
+    int xi = (int) x_i,
+        yi = (int) y_i,
+        xf = (int) x_f,
+        yf = (int) y_f;
+
+    int dx     = xf - xi,
+        dy     = yf - yi,
+        x      = xi,
+        y      = yi,
+        p      = 0,
+        const1 = 0,
+        const2 = 0,
+        incrx  = 0,
+        incry  = 0;
+
+    if ( dx >= 0 ) incrx = 1;
+    else { incrx = -1; dx = (-dx); }
+
+    if ( dy >= 0 ) incry = 1;
+    else { incry = -1; dy = (-dy); }
+
+    // After k steps along major axis, minor axis moved floor((2 * minor * k + major) / (2 * major)) pixels, so stepping may start at any step
+    int first, last;
+    if ( !raster_line_steps(view, xi, yi, xf, yf, ( dy < dx ) ? dx : dy, &first, &last) ) return;
+    int64_t k = first - 1,
+            moved = 0;
+
+    if ( dy < dx )
+    {
+        moved = (2 * (int64_t) dy * k + dx) / (2 * (int64_t) dx);
+        x += incrx * k;
+        y += incry * moved;
+        p = (int) (2 * (int64_t) dy * (k + 1) - dx - 2 * (int64_t) dx * moved);
+        const1 = 2 * dy;
+        const2 = 2 * (dy - dx);
+
+        for ( int i = first - 1; i < last; i++ )
+        {
+            x += incrx;
+            if ( p < 0 ) p += const1;
+            else { y += incry; p += const2; }
+            raster_brush(cr, view, (double) x, (double) y, c);
+        }
+    } else
+    {
+        moved = (2 * (int64_t) dx * k + dy) / (2 * (int64_t) dy);
+        y += incry * k;
+        x += incrx * moved;
+        p = (int) (2 * (int64_t) dx * (k + 1) - dy - 2 * (int64_t) dy * moved);
+        const1 = 2 * dx;
+        const2 = 2 * (dx - dy);
+
+        for ( int i = first - 1; i < last; i++ )
+        {
+            y += incry;
+            if ( p < 0 ) p += const1;
+            else { x += incrx; p += const2; }
+            raster_brush(cr, view, (double) x, (double) y, c);
+        }
+    }
+}
+
+/**
+ * @brief Using equality of points, plotting a circumference.
+ *
+ * @param cr       Cairo context.
+ * @param view     Canvas' origin.
+ * @param x_center Center X coordinate.
+ * @param y_center Center Y coordinate.
+ * @param x_calc   X coordinate to be plotted.
+ * @param y_calc   Y coordinate to be plotted.
+ * @param c        Color (RGB).
+*/
+static void raster_circle_points(cairo_t                  *cr,
+                                 const struct raster_view *view,
+                                 double                    x_center,
+                                 double                    y_center,
+                                 double                    x_calc,
+                                 double                    y_calc,
+                                 uint32_t                  c)
+{
+    x_center = round(x_center);
+    y_center = round(y_center);
+
+    raster_brush(cr, view, x_center + x_calc, y_center + y_calc, c);
+    raster_brush(cr, view, x_center - x_calc, y_center + y_calc, c);
+    raster_brush(cr, view, x_center + x_calc, y_center - y_calc, c);
+    raster_brush(cr, view, x_center - x_calc, y_center - y_calc, c);
+
+    raster_brush(cr, view, x_center + y_calc, y_center + x_calc, c);
+    raster_brush(cr, view, x_center - y_calc, y_center + x_calc, c);
+    raster_brush(cr, view, x_center + y_calc, y_center - x_calc, c);
+    raster_brush(cr, view, x_center - y_calc, y_center - x_calc, c);
+}
+
+/**
+ * @brief Computes the state of Bresenham's circumference algorithm at a step, without going through the steps before it:
+ * at step x, y is the smallest one with 2x^2 + y^2 + (y + 1)^2 >= 2r^2 (but never less than x - 1), and decision is
+ * p = 2(x + 1)^2 + y^2 + (y - 1)^2 - 2r^2.
+ *
+ * @param r Radius.
+ * @param x Step (X of 2nd Octant's point).
+ * @param y Output: Y of 2nd Octant's point.
+ * @param p Output: decision.
+*/
+static void raster_circle_state(int64_t  r,
+                                int64_t  x,
+                                int64_t *y,
+                                int64_t *p)
+{
+    int64_t t = 2 * r * r - 2 * x * x - 1,
+            lo = 0;
+
+    // 2y^2 + 2y >= t, from an estimate a step below it
+    if ( t > 0 )
+    {
+        lo = (int64_t) ((sqrt(2.0 * t + 1.0) - 1.0) / 2.0) - 1;
+        if ( lo < 0 ) lo = 0;
+        while ( 2 * lo * lo + 2 * lo < t ) lo++;
+    }
+    *y = ( lo > x - 1 ) ? lo : x - 1;
+    *p = 2 * (x + 1) * (x + 1) + (*y) * (*y) + (*y - 1) * (*y - 1) - 2 * r * r;
+}
+
+/**
+ * @brief Computes which steps of Bresenham's circumference algorithm plot a point that may touch view's rasterized area: for each of the 8
+ * symmetric points, steps whose X and Y (Y is within a pixel of sqrt(r^2 - x^2)) may fall inside it. Ranges are sorted and merged,
+ * so each step is taken once.
+ *
+ * @param view   Canvas' origin and rasterized area.
+ * @param cx     Center X coordinate (rounded).
+ * @param cy     Center Y coordinate (rounded).
+ * @param r      Radius.
+ * @param ranges Output: up to 8 ranges of steps, [ranges[2i], ranges[2i + 1]].
+ *
+ * @returns Number of ranges.
+*/
+static int raster_circle_steps(const struct raster_view *view,
+                               double                    cx,
+                               double                    cy,
+                               int                       r,
+                               int                      *ranges)
+{
+    double box[4],
+           rr = (double) r * r;
+    int n = 0;
+
+    raster_view_bounds(view, 1.0, box);
+    box[0] -= cx;
+    box[2] -= cx;
+    box[1] -= cy;
+    box[3] -= cy;
+
+    // Each point is (sx * x, sy * y) or (sx * y, sy * x)
+    for ( int i = 0; i < 8; i++ )
+    {
+        double sx = ( i & 1 ) ? -1.0 : 1.0,
+               sy = ( i & 2 ) ? -1.0 : 1.0;
+        const double *along = ( i & 4 ) ? &box[1] : &box[0],
+                     *across = ( i & 4 ) ? &box[0] : &box[1];
+        double s_along = ( i & 4 ) ? sy : sx,
+               s_across = ( i & 4 ) ? sx : sy;
+
+        // x in [xlo, xhi] from its own axis, y in [ylo, yhi] from the other one
+        double xlo = fmax(0.0, ( s_along > 0 ) ? along[0] : -along[2]),
+               xhi = fmin((double) r, ( s_along > 0 ) ? along[2] : -along[0]),
+               ylo = ( s_across > 0 ) ? across[0] : -across[2],
+               yhi = ( s_across > 0 ) ? across[2] : -across[0];
+        if ( yhi < -1.0 || ylo > r + 1.0 ) continue;
+
+        yhi += 1.0;
+        ylo -= 1.0;
+        if ( yhi < r ) xlo = fmax(xlo, sqrt(rr - yhi * yhi));
+        if ( ylo > 0.0 ) xhi = fmin(xhi, sqrt(fmax(0.0, rr - ylo * ylo)));
+        if ( xlo > xhi ) continue;
+
+        int lo = (int) floor(xlo),
+            hi = (int) ceil(xhi),
+            j = n;
+        // Insertion by first step
+        while ( j > 0 && ranges[2 * (j - 1)] > lo )
+        {
+            ranges[2 * j] = ranges[2 * (j - 1)];
+            ranges[2 * j + 1] = ranges[2 * (j - 1) + 1];
+            j--;
+        }
+        ranges[2 * j] = lo;
+        ranges[2 * j + 1] = hi;
+        n++;
+    }
+
+    // Merging overlapping (and adjacent) ranges
+    int m = 0;
+    for ( int i = 0; i < n; i++ )
+    {
+        if ( m > 0 && ranges[2 * i] <= ranges[2 * (m - 1) + 1] + 1 )
+        {
+            if ( ranges[2 * i + 1] > ranges[2 * (m - 1) + 1] ) ranges[2 * (m - 1) + 1] = ranges[2 * i + 1];
+            continue;
+        }
+        ranges[2 * m] = ranges[2 * i];
+        ranges[2 * m + 1] = ranges[2 * i + 1];
+        m++;
+    }
+    return m;
+}
+
+/**
+ * @brief Uses the idea of Bresenham's circumference algorithm to identify all points of the 2nd Octant, then replicates them.
+ * Only steps whose points may touch rasterized area (e.g. a tile) are taken (see raster_circle_steps()).
+ *
+ * @param cr       Cairo context.
+ * @param view     Canvas' origin.
+ * @param x_center Center X coordinate.
+ * @param y_center Center Y coordinate.
+ * @param radius   Circumference's radius.
+ * @param c        Color (RGB).
+*/
+void raster_circumference(cairo_t                  *cr,
+                          const struct raster_view *view,
+                          double                    x_center,
+                          double                    y_center,
+                          double                    radius,
+                          uint32_t                  c)
+{
+    int64_t x = 0,
+            y = 0,
+            p = 0,
+            r = 0;
+    int ranges[16];
+
+    r = radius;
+    int num_ranges = raster_circle_steps(view, round(x_center), round(y_center), r, ranges);
+
+    for ( int i = 0; i < num_ranges; i++ )
+    {
+        // Steps go on while x < y: a range starting after last step is empty
+        if ( ranges[2 * i] == 0 )
+        {
+            x = 0;
+            y = r;
+            p = 3 - 2 * r;
+            raster_circle_points(cr, view, x_center, y_center, x, y, c);
+        } else
+        {
+            x = ranges[2 * i] - 1;
+            raster_circle_state(r, x, &y, &p);
+            if ( x >= y ) break;
+        }
+
+        while ( x < y && x < ranges[2 * i + 1] )
+        {
+            if ( p < 0 )
+            {
+                p = p + 4 * x + 6;
+            } else
+            {
+                p = p + 4 * (x-y) + 10;
+                y--;
+            }
+            x++;
+            raster_circle_points(cr, view, x_center, y_center, x, y, c);
+        }
+    }
+}
+
+/**
+ * @brief Writes the label of a point into a buffer. Text example: (X, Y)
+ *
+ * @param buffer Buffer of, at least, RASTER_LABEL_SIZE chars.
+ * @param x      X coordinate.
+ * @param y      Y coordinate.
+ *
+ * @returns Length of written label.
+*/
+int raster_label_text(char   *buffer,
+                      double  x,
+                      double  y)
+{
+    return snprintf(buffer, RASTER_LABEL_SIZE, "(%d, %d)", (int) round(x), (int) round(y));
+}
+
+/**
+ * @brief Using Cairo, writes the position of a point under it.
+ *
+ * @param cr   Cairo context.
+ * @param view Canvas' origin.
+ * @param x    X coordinate.
+ * @param y    Y coordinate.
+*/
+void raster_label(cairo_t                  *cr,
+                  const struct raster_view *view,
+                  double                    x,
+                  double                    y)
+{
+    char text[RASTER_LABEL_SIZE];
+
+    raster_label_text(text, x, y);
+    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, 12.0);
+
+    cairo_move_to(cr, (x + view->center_x) - 34, (view->center_y - y) + 15);
+    cairo_show_text(cr, text);
+}
+
+/**
+ * @brief Initializes a view that covers the whole canvas of a display list.
+ *
+ * @param view Given view.
+ * @param dl   Display list.
+*/
+void raster_view_init(struct raster_view        *view,
+                      const struct display_list *dl)
+{
+    /* Sanity Check. */
+    assert( view != NULL );
+    assert( dl != NULL );
+
+    view->center_x = display_list_center_x(dl);
+    view->center_y = display_list_center_y(dl);
+    view->clip_x0 = INT_MIN;
+    view->clip_y0 = INT_MIN;
+    view->clip_x1 = INT_MAX;
+    view->clip_y1 = INT_MAX;
+}
+
+/**
+ * @brief Rasterizes a single operation of a display list.
+ *
+ * @param cr   Cairo context.
+ * @param view Canvas' origin and rasterized area.
+ * @param op   Operation.
+*/
+void raster_op(cairo_t                  *cr,
+               const struct raster_view *view,
+               const struct display_op  *op)
+{
+    switch ( op->type )
+    {
+        case DISPLAY_BRUSH:
+            raster_brush(cr, view, op->x0, op->y0, op->color);
+            break;
+        case DISPLAY_LINE:
+            if ( op->algh == 1 ) raster_dda(cr, view, op->x0, op->y0, op->x1, op->y1, op->color);
+            else if ( op->algh == 2 ) raster_bresenham(cr, view, op->x0, op->y0, op->x1, op->y1, op->color);
+            break;
+        case DISPLAY_CIRCUMFERENCE:
+            raster_circumference(cr, view, op->x0, op->y0, op->x1, op->color);
+            break;
+        case DISPLAY_LABEL:
+            raster_label(cr, view, op->x0, op->y0);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Rasterizes all operations of a display list, in order.
+ *
+ * @param cr Cairo context.
+ * @param dl Display list to be rasterized.
+*/
+void raster_display_list(cairo_t                    *cr,
+                         const struct display_list *dl)
+{
+    /* Sanity Check. */
+    assert( dl != NULL );
+
+    struct raster_view view;
+    raster_view_init(&view, dl);
+
+    for ( int i = 0; i < display_list_size(dl); i++ )
+        raster_op(cr, &view, display_list_get(dl, i));
+}
@@ -0,0 +1,597 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+
+#include "raster.h"
+#include "renderer.h"
+#include "tiler.h"
+
+struct renderer
+{
+    GtkWidget       *area;         /** << Drawing area that presents front buffer.                          */
+    GThread         *thread;       /** << Render thread.                                                    */
+    GMutex           lock;         /** << Protects pending, spare, released, width, height and quit.        */
+    GCond            cond;         /** << Signaled whenever there is work (or quit) for thread.             */
+    display_list_tt  pending;      /** << Latest submitted display list, not yet rasterized.                */
+    display_list_tt  spare[RENDER_SPARE_LISTS]; /** << Rasterized display lists, reused by renderer_acquire. */
+    int              num_spare;    /** << Number of spare display lists.                                    */
+    cairo_surface_t *front;        /** << Buffer presented by draw_cb. Swapped atomically.                  */
+    cairo_surface_t *back;         /** << Buffer rasterized by render thread.                               */
+    int              released;     /** << If back buffer was released by GTK's main loop after swap.        */
+    int              width;        /** << Desired buffer width.                                             */
+    int              height;       /** << Desired buffer height.                                            */
+    int              quit;         /** << If render thread must stop.                                       */
+    int              refs;         /** << References held (renderer itself + pending notifications).        */
+    int              mode;         /** << Rendering mode (RENDER_SINGLE, RENDER_TILED or RENDER_SLICED).    */
+    scheduler_tt     scheduler;    /** << Threads used by tiled rasterization.                              */
+    tiler_tt         tiler;        /** << Tile binning, created on first tiled rasterization.               */
+
+    gint64           budget;       /** << (SLICED) Rasterization time per frame, in microseconds.           */
+    guint            tick;         /** << (SLICED) Tick callback id, 0 when nothing is being rasterized.    */
+    display_list_tt  sliced;       /** << (SLICED) Display list being rasterized.                           */
+    int             *order;        /** << (SLICED) Operations' indexes, in priority order.                  */
+    int              order_size;   /** << (SLICED) Number of indexes that fit in order.                     */
+    int              next;         /** << (SLICED) Next operation to be rasterized (index in order).        */
+    cairo_surface_t *slice;        /** << (SLICED) Buffer rasterized and presented in GTK's main loop.      */
+};
+
+/**
+ * @brief Creates a blank (white) buffer.
+ *
+ * @param width  Buffer width.
+ * @param height Buffer height.
+ *
+ * @returns A cairo image surface.
+*/
+static cairo_surface_t *renderer_buffer_create(int width,
+                                               int height)
+{
+    cairo_surface_t *s = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+    cairo_t *cr = cairo_create(s);
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    return (s);
+}
+
+/**
+ * @brief Prepares the rasterization of a display list: canvas' origin and, if display list is limited to an area (see display_list_set_damage),
+ * clips rasterization to that area (in pixels), so anything outside is kept as it was.
+ *
+ * @param cr    Cairo context of the buffer being rasterized.
+ * @param view  Output: canvas' origin and rasterized area.
+ * @param dl    Display list.
+ * @param blank If area is painted blank (white) first. 0 = No, 1 = Yes.
+ *
+ * @returns 1 if display list is limited to an area, 0 otherwise (nothing is clipped nor painted).
+*/
+static int renderer_damage(cairo_t               *cr,
+                           struct raster_view    *view,
+                           const_display_list_tt  dl,
+                           int                    blank)
+{
+    double box[4];
+
+    raster_view_init(view, dl);
+    if ( !display_list_get_damage(dl, box) ) return (0);
+
+    // Y grows upwards in canvas, downwards in pixels
+    view->clip_x0 = (int) floor(view->center_x + box[0]);
+    view->clip_y0 = (int) floor(view->center_y - box[3]);
+    view->clip_x1 = (int) ceil(view->center_x + box[2]);
+    view->clip_y1 = (int) ceil(view->center_y - box[1]);
+    cairo_rectangle(cr, view->clip_x0, view->clip_y0, view->clip_x1 - view->clip_x0, view->clip_y1 - view->clip_y0);
+    cairo_clip(cr);
+    if ( blank )
+    {
+        cairo_set_source_rgb(cr, 1, 1, 1);
+        cairo_paint(cr);
+    }
+
+    return (1);
+}
+
+/**
+ * @brief Gives back a display list that will not be rasterized (anymore). It is kept to be recorded again,
+ * unless there are RENDER_SPARE_LISTS spare display lists already.
+ *
+ * @param r  Given renderer.
+ * @param dl Display list.
+*/
+static void renderer_recycle(struct renderer *r,
+                             display_list_tt  dl)
+{
+    g_mutex_lock(&r->lock);
+    if ( r->num_spare < RENDER_SPARE_LISTS )
+    {
+        r->spare[r->num_spare++] = dl;
+        dl = NULL;
+    }
+    g_mutex_unlock(&r->lock);
+
+    if ( dl ) display_list_destroy(dl);
+}
+
+/**
+ * @brief (SLICED) Stops rasterizing current display list, if any.
+ *
+ * @param r Given renderer.
+*/
+static void renderer_slice_stop(struct renderer *r)
+{
+    if ( r->tick ) gtk_widget_remove_tick_callback(r->area, r->tick);
+    r->tick = 0;
+    if ( r->sliced ) renderer_recycle(r, r->sliced);
+    r->sliced = NULL;
+}
+
+/**
+ * @brief (SLICED) Priority of an operation. Objects' outlines first, so scene's shape shows up early, then points and, at last, labels.
+ *
+ * @param op Given operation.
+ *
+ * @returns Priority, lower is rasterized first.
+*/
+static int renderer_priority(const struct display_op *op)
+{
+    switch ( op->type )
+    {
+        case DISPLAY_LINE:
+        case DISPLAY_CIRCUMFERENCE:
+            return 0;
+        case DISPLAY_BRUSH:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+/**
+ * @brief (TICK) Called by GTK's frame clock once per frame. Rasterizes operations, in priority order, until the frame's budget is spent
+ * and presents the partial result. Remaining operations are rasterized in the next frames.
+ *
+ * @param widget Drawing area.
+ * @param clock  Frame clock.
+ * @param data   Given renderer.
+*/
+static gboolean renderer_slice_tick(GtkWidget     *widget,
+                                    GdkFrameClock *clock,
+                                    gpointer       data)
+{
+    struct renderer *r = data;
+    gint64 deadline = g_get_monotonic_time() + r->budget;
+    int size = display_list_size(r->sliced);
+
+    cairo_t *cr = cairo_create(r->slice);
+    struct raster_view view;
+    // Damaged area was painted blank when display list started
+    renderer_damage(cr, &view, r->sliced, 0);
+
+    // At least one operation per frame, so rasterization always advances.
+    do
+    {
+        raster_op(cr, &view, display_list_get(r->sliced, r->order[r->next++]));
+    } while ( r->next < size && g_get_monotonic_time() < deadline );
+    cairo_destroy(cr);
+
+    gtk_widget_queue_draw(widget);
+    if ( r->next < size ) return G_SOURCE_CONTINUE;
+
+    // Callback is being removed by returning G_SOURCE_REMOVE.
+    r->tick = 0;
+    renderer_slice_stop(r);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief (SLICED) Starts rasterizing a display list over the next frames. Older display list, if any, is dropped.
+ * A display list limited to an area is refused while an older one is being rasterized.
+ *
+ * @param r  Given renderer.
+ * @param dl Display list.
+ *
+ * @returns 1 if display list was taken, 0 if it was refused (and recycled).
+*/
+static int renderer_slice_start(struct renderer *r,
+                                display_list_tt  dl)
+{
+    struct raster_view view;
+    double box[4];
+
+    g_mutex_lock(&r->lock);
+    int width = r->width,
+        height = r->height;
+    g_mutex_unlock(&r->lock);
+
+    int fits = ( r->slice != NULL && cairo_image_surface_get_width(r->slice) == width && cairo_image_surface_get_height(r->slice) == height );
+    // A display list limited to an area needs the rest of canvas as it is: a complete one
+    if ( display_list_get_damage(dl, box) && (r->sliced != NULL || !fits) )
+    {
+        renderer_recycle(r, dl);
+        return (0);
+    }
+    renderer_slice_stop(r);
+
+    if ( !fits )
+    {
+        if ( r->slice ) cairo_surface_destroy(r->slice);
+        r->slice = renderer_buffer_create(width, height);
+    } else
+    {
+        cairo_t *cr = cairo_create(r->slice);
+        if ( !renderer_damage(cr, &view, dl, 1) )
+        {
+            cairo_set_source_rgb(cr, 1, 1, 1);
+            cairo_paint(cr);
+        }
+        cairo_destroy(cr);
+    }
+
+    int size = display_list_size(dl);
+    if ( size == 0 )
+    {
+        renderer_recycle(r, dl);
+        gtk_widget_queue_draw(r->area);
+        return (1);
+    }
+
+    // Stable counting sort by priority, operations of same priority keep display list's order.
+    int count[3] = { 0, 0, 0 };
+    if ( size > r->order_size )
+    {
+        free(r->order);
+        r->order = (int*) malloc(sizeof(int) * size);
+        r->order_size = size;
+    }
+    for ( int i = 0; i < size; i++ ) count[renderer_priority(display_list_get(dl, i))]++;
+    count[2] = count[0] + count[1];
+    count[1] = count[0];
+    count[0] = 0;
+    for ( int i = 0; i < size; i++ ) r->order[count[renderer_priority(display_list_get(dl, i))]++] = i;
+
+    r->sliced = dl;
+    r->next = 0;
+    r->tick = gtk_widget_add_tick_callback(r->area, renderer_slice_tick, r, NULL);
+    return (1);
+}
+
+/**
+ * @brief Drops a reference of renderer, freeing it when no one else references it.
+ *
+ * @param r Given renderer.
+*/
+static void renderer_unref(struct renderer *r)
+{
+    if ( !g_atomic_int_dec_and_test(&r->refs) ) return;
+
+    if ( r->pending ) display_list_destroy(r->pending);
+    for ( int i = 0; i < r->num_spare; i++ ) display_list_destroy(r->spare[i]);
+    free(r->order);
+    if ( r->tiler ) tiler_destroy(r->tiler);
+    if ( r->slice ) cairo_surface_destroy(r->slice);
+    cairo_surface_destroy(r->front);
+    cairo_surface_destroy(r->back);
+    g_mutex_clear(&r->lock);
+    g_cond_clear(&r->cond);
+    free(r);
+}
+
+/**
+ * @brief (IDLE) Called in GTK's main loop after a swap, asks drawing area to present the new front buffer.
+ * Old front buffer may still be referenced by GTK's recorded drawings, flushing it (in this thread) detaches them,
+ * so it is safe to hand it back to render thread.
+ *
+ * @param data Given renderer.
+*/
+static gboolean renderer_notify(gpointer data)
+{
+    struct renderer *r = data;
+
+    g_mutex_lock(&r->lock);
+    cairo_surface_flush(r->back);
+    r->released = 1;
+    g_cond_signal(&r->cond);
+    g_mutex_unlock(&r->lock);
+
+    if ( !g_atomic_int_get(&r->quit) ) gtk_widget_queue_draw(r->area);
+    renderer_unref(r);
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * @brief Render thread. Waits for a display list, rasterizes it into back buffer, swaps buffers and notifies GTK.
+ * Only the latest submitted display list is rasterized, older ones are dropped.
+ *
+ * @param data Given renderer.
+*/
+static gpointer renderer_loop(gpointer data)
+{
+    struct renderer *r = data;
+
+    while ( 1 )
+    {
+        g_mutex_lock(&r->lock);
+        while ( (r->pending == NULL || !r->released) && !r->quit ) g_cond_wait(&r->cond, &r->lock);
+        if ( r->quit )
+        {
+            g_mutex_unlock(&r->lock);
+            break;
+        }
+        display_list_tt dl = r->pending;
+        int width = r->width,
+            height = r->height;
+        r->pending = NULL;
+        g_mutex_unlock(&r->lock);
+
+        if ( cairo_image_surface_get_width(r->back) != width || cairo_image_surface_get_height(r->back) != height )
+        {
+            cairo_surface_destroy(r->back);
+            r->back = renderer_buffer_create(width, height);
+        }
+
+        cairo_surface_t *front = g_atomic_pointer_get(&r->front);
+        double box[4];
+        if ( display_list_get_damage(dl, box) && cairo_image_surface_get_width(front) == width && cairo_image_surface_get_height(front) == height )
+        {
+            // Only an area changed: the rest is copied from last buffer, and the (few) operations are rasterized by this thread alone
+            struct raster_view view;
+            cairo_t *cr = cairo_create(r->back);
+            // Buffers are opaque (RGB24), so painting one over another copies it
+            cairo_set_source_surface(cr, front, 0, 0);
+            cairo_paint(cr);
+            renderer_damage(cr, &view, dl, 1);
+            for ( int i = 0; i < display_list_size(dl); i++ ) raster_op(cr, &view, display_list_get(dl, i));
+            cairo_destroy(cr);
+        } else if ( g_atomic_int_get(&r->mode) == RENDER_TILED )
+        {
+            if ( r->tiler == NULL ) r->tiler = tiler_create(r->scheduler);
+            tiler_rasterize(r->tiler, r->back, dl);
+        } else
+        {
+            cairo_t *cr = cairo_create(r->back);
+            cairo_set_source_rgb(cr, 1, 1, 1);
+            cairo_paint(cr);
+            raster_display_list(cr, dl);
+            cairo_destroy(cr);
+        }
+        cairo_surface_flush(r->back);
+        renderer_recycle(r, dl);
+
+        // Old front buffer can only be drawn again after GTK's main loop releases it.
+        g_mutex_lock(&r->lock);
+        r->back = g_atomic_pointer_exchange(&r->front, r->back);
+        r->released = 0;
+        g_mutex_unlock(&r->lock);
+
+        g_atomic_int_inc(&r->refs);
+        g_idle_add(renderer_notify, r);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Initializes the Renderer structure and starts its render thread.
+ *
+ * @param area      Drawing area that will present rendered buffers.
+ * @param scheduler Scheduler used by tiled rasterization.
+ * @param width     Buffer width.
+ * @param height    Buffer height.
+ *
+ * @returns A renderer.
+*/
+renderer_tt renderer_create(GtkWidget    *area,
+                            scheduler_tt  scheduler,
+                            int           width,
+                            int           height)
+{
+    /* Sanity Check. */
+    assert( area != NULL );
+    assert( scheduler != NULL );
+
+    struct renderer *r = (struct renderer*) malloc(sizeof(struct renderer));
+    r->area = area;
+    g_mutex_init(&r->lock);
+    g_cond_init(&r->cond);
+    r->pending = NULL;
+    r->num_spare = 0;
+    r->front = renderer_buffer_create(width, height);
+    r->back = renderer_buffer_create(width, height);
+    r->released = 1;
+    r->width = width;
+    r->height = height;
+    r->quit = 0;
+    r->refs = 1;
+    r->mode = RENDER_SINGLE;
+    r->scheduler = scheduler;
+    r->tiler = NULL;
+    r->budget = RENDER_DEFAULT_BUDGET;
+    r->tick = 0;
+    r->sliced = NULL;
+    r->order = NULL;
+    r->order_size = 0;
+    r->next = 0;
+    r->slice = NULL;
+    r->thread = g_thread_new("renderer", renderer_loop, r);
+
+    return (r);
+}
+
+/**
+ * @brief Stops render thread and destroys the Renderer structure.
+ *
+ * @param r Given renderer.
+*/
+void renderer_destroy(struct renderer *r)
+{
+    /* Sanity Check. */
+    assert( r != NULL );
+
+    g_mutex_lock(&r->lock);
+    g_atomic_int_set(&r->quit, 1);
+    g_cond_signal(&r->cond);
+    g_mutex_unlock(&r->lock);
+    g_thread_join(r->thread);
+
+    renderer_slice_stop(r);
+    renderer_unref(r);
+}
+
+/**
+ * @brief Changes buffers' size. Takes effect in the next rasterization.
+ *
+ * @param r      Given renderer.
+ * @param width  New width.
+ * @param height New height.
+*/
+void renderer_resize(struct renderer *r,
+                     int              width,
+                     int              height)
+{
+    /* Sanity Check. */
+    assert( r != NULL );
+
+    g_mutex_lock(&r->lock);
+    r->width = width;
+    r->height = height;
+    g_mutex_unlock(&r->lock);
+}
+
+/**
+ * @brief Returns an empty display list to be recorded and then submitted. Display lists already rasterized are reused,
+ * so in steady state recording a frame allocates nothing. Must be called from GTK's main loop.
+ *
+ * @param r        Given renderer.
+ * @param center_x Canvas' center X, in pixels.
+ * @param center_y Canvas' center Y, in pixels.
+ *
+ * @returns A display list.
+*/
+display_list_tt renderer_acquire(struct renderer *r,
+                                 int              center_x,
+                                 int              center_y)
+{
+    /* Sanity Check. */
+    assert( r != NULL );
+
+    display_list_tt dl = NULL;
+    g_mutex_lock(&r->lock);
+    if ( r->num_spare > 0 ) dl = r->spare[--r->num_spare];
+    g_mutex_unlock(&r->lock);
+
+    if ( dl == NULL ) return display_list_create(center_x, center_y);
+    display_list_reset(dl, center_x, center_y);
+    return (dl);
+}
+
+/**
+ * @brief Submits a display list to be rasterized by render thread (or, in RENDER_SLICED, by GTK's frame clock). Renderer takes ownership of the display list.
+ * If a previous display list was not rasterized yet, it is dropped (and reused) in favor of the new one. Must be called from GTK's main loop.
+ * A display list limited to an area (see display_list_set_damage) only rasterizes that area over the last buffer, so it cannot drop
+ * an older one: it is refused instead, and a complete display list must be submitted.
+ *
+ * @param r  Given renderer.
+ * @param dl Display list.
+ *
+ * @returns 1 if display list was taken, 0 if it was refused.
+*/
+int renderer_submit(struct renderer *r,
+                     display_list_tt  dl)
+{
+    /* Sanity Check. */
+    assert( r != NULL );
+    assert( dl != NULL );
+
+    if ( g_atomic_int_get(&r->mode) == RENDER_SLICED ) return renderer_slice_start(r, dl);
+
+    double box[4];
+    int damaged = display_list_get_damage(dl, box);
+
+    g_mutex_lock(&r->lock);
+    // A display list limited to an area cannot replace one that was not rasterized yet: it needs the rest of canvas as it is
+    if ( damaged && (r->pending != NULL || r->tick != 0) )
+    {
+        g_mutex_unlock(&r->lock);
+        renderer_recycle(r, dl);
+        return (0);
+    }
+    display_list_tt dropped = r->pending;
+    r->pending = dl;
+    g_cond_signal(&r->cond);
+    g_mutex_unlock(&r->lock);
+
+    renderer_slice_stop(r);
+    if ( dropped ) renderer_recycle(r, dropped);
+    return (1);
+}
+
+/**
+ * @brief Returns if a display list is still waiting for render thread (or, in RENDER_SLICED, is still being rasterized over frames):
+ * then a display list limited to an area would be refused (see renderer_submit). Must be called from GTK's main loop.
+ *
+ * @param r Given renderer.
+ *
+ * @returns 1 if it is busy, 0 otherwise.
+*/
+int renderer_is_busy(struct renderer *r)
+{
+    /* Sanity Check. */
+    assert( r != NULL );
+
+    g_mutex_lock(&r->lock);
+    int busy = ( r->pending != NULL || r->tick != 0 );
+    g_mutex_unlock(&r->lock);
+
+    return (busy);
+}
+
+/**
+ * @brief Paints front buffer in given cairo context. Must be called from draw_cb (GTK's main loop).
+ *
+ * @param r  Given renderer.
+ * @param cr Drawing area's cairo context.
+*/
+void renderer_present(struct renderer *r,
+                      cairo_t         *cr)
+{
+    /* Sanity Check. */
+    assert( r != NULL );
+
+    if ( g_atomic_int_get(&r->mode) == RENDER_SLICED && r->slice ) cairo_set_source_surface(cr, r->slice, 0, 0);
+    else cairo_set_source_surface(cr, g_atomic_pointer_get(&r->front), 0, 0);
+    cairo_paint(cr);
+}
+
+/**
+ * @brief Changes rendering mode. Takes effect in the next rasterization.
+ *
+ * @param r    Given renderer.
+ * @param mode RENDER_SINGLE, RENDER_TILED or RENDER_SLICED.
+*/
+void renderer_set_mode(struct renderer *r,
+                       int              mode)
+{
+    /* Sanity Check. */
+    assert( r != NULL );
+
+    g_atomic_int_set(&r->mode, mode);
+}
+
+/**
+ * @brief Changes how long RENDER_SLICED rasterizes per frame. Takes effect in the next frame.
+ *
+ * @param r      Given renderer.
+ * @param budget Time per frame, in microseconds.
+*/
+void renderer_set_budget(struct renderer *r,
+                         gint64           budget)
+{
+    /* Sanity Check. */
+    assert( r != NULL );
+    assert( budget > 0 );
+
+    r->budget = budget;
+}
@@ -0,0 +1,449 @@
+#include <assert.h>
+#include <stdlib.h>
+
+
+#include "affine.h"
+#include "scene_graph.h"
+
+#define SCENE_NO_GROUP -1 /** << Node is not a group. */
+
+/**
+ * @brief A node of the graph (Object or group), by handle's index.
+*/
+struct scene_node
+{
+    handle_tt parent; /** << Group that holds node. HANDLE_NONE if node is a root.  */
+    int       group;  /** << Position in groups, SCENE_NO_GROUP if not a group.    */
+};
+
+/**
+ * @brief A group: its children and its matrices.
+*/
+struct scene_group
+{
+    handle_tt      handle;    /** << Group's handle.                                                   */
+    handle_list_tt children;  /** << Every child (Objects and groups).                                 */
+    handle_list_tt subgroups; /** << Children that are groups, so marking dirty never visits Objects.   */
+    struct affine  local;     /** << Children to parent's coordinates (or world's, if group is a root). */
+    struct affine  world;     /** << Children to world's coordinates (cached).                        */
+    int            dirty;     /** << If world must be computed again. 0 = No, 1 = Yes.               */
+};
+
+struct scene_graph
+{
+    VECTOR(struct scene_node)  nodes;  /** << Nodes, by handle's index. Missing ones are roots.  */
+    VECTOR(struct scene_group) groups; /** << Groups, in no particular order.                   */
+};
+
+/**
+ * @brief Returns the node of a handle, NULL if it was never added (a root, not a group).
+ *
+ * @param g Given scene graph.
+ * @param h Given handle.
+ *
+ * @returns Node.
+*/
+static struct scene_node *scene_node(const struct scene_graph *g,
+                                     handle_tt                 h)
+{
+    int i = HANDLE_INDEX(h);
+
+    return ( i < g->nodes.size ) ? &g->nodes.data[i] : NULL;
+}
+
+/**
+ * @brief Returns the node of a handle, adding it (as a root) if it was never added.
+ *
+ * @param g Given scene graph.
+ * @param h Given handle.
+ *
+ * @returns Node.
+*/
+static struct scene_node *scene_node_add(struct scene_graph *g,
+                                         handle_tt           h)
+{
+    struct scene_node none = { HANDLE_NONE, SCENE_NO_GROUP };
+    int i = HANDLE_INDEX(h);
+
+    while ( g->nodes.size <= i ) vector_push(&g->nodes, none);
+    return &g->nodes.data[i];
+}
+
+/**
+ * @brief Returns the group of a handle.
+ *
+ * @param g Given scene graph.
+ * @param h Group's handle. Must be a group.
+ *
+ * @returns Group.
+*/
+static struct scene_group *scene_group(const struct scene_graph *g,
+                                       handle_tt                 h)
+{
+    struct scene_node *n = scene_node(g, h);
+
+    /* Sanity Check. */
+    assert( n != NULL && n->group != SCENE_NO_GROUP );
+
+    return &g->groups.data[n->group];
+}
+
+/**
+ * @brief Initializes the Scene Graph structure.
+ *
+ * @returns An empty scene graph: every handle is a root.
+*/
+scene_graph_tt scene_graph_create(void)
+{
+    struct scene_graph *g = (struct scene_graph*) malloc(sizeof(struct scene_graph));
+
+    vector_init(&g->nodes);
+    vector_init(&g->groups);
+
+    return (g);
+}
+
+/**
+ * @brief Destroys the Scene Graph structure.
+ *
+ * @param g Given scene graph.
+*/
+void scene_graph_destroy(struct scene_graph *g)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    scene_graph_clear(g);
+    vector_free(&g->nodes);
+    vector_free(&g->groups);
+    free(g);
+}
+
+/**
+ * @brief Removes all groups: every handle is a root again. Handles of groups are not released (see handle.h).
+ *
+ * @param g Given scene graph.
+*/
+void scene_graph_clear(struct scene_graph *g)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    for ( int i = 0; i < g->groups.size; i++ )
+    {
+        vector_free(&g->groups.data[i].children);
+        vector_free(&g->groups.data[i].subgroups);
+    }
+    vector_clear(&g->groups);
+    vector_clear(&g->nodes);
+}
+
+/**
+ * @brief Returns the number of groups.
+ *
+ * @param g Given scene graph.
+ *
+ * @returns Number of groups.
+*/
+int scene_graph_num_groups(const struct scene_graph *g)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    return (g->groups.size);
+}
+
+/**
+ * @brief Returns the ith group. Grouping and ungrouping change groups' order.
+ *
+ * @param g Given scene graph.
+ * @param i Position, in [0, scene_graph_num_groups).
+ *
+ * @returns Group's handle.
+*/
+handle_tt scene_graph_group_at(const struct scene_graph *g,
+                               int                       i)
+{
+    /* Sanity Check. */
+    assert( g != NULL && i >= 0 && i < g->groups.size );
+
+    return (g->groups.data[i].handle);
+}
+
+/**
+ * @brief Returns if a handle is a group.
+ *
+ * @param g Given scene graph.
+ * @param h Given handle.
+ *
+ * @returns 1 if it is, 0 otherwise.
+*/
+int scene_graph_is_group(const struct scene_graph *g,
+                         handle_tt                 h)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    struct scene_node *n = scene_node(g, h);
+    return ( n != NULL && n->group != SCENE_NO_GROUP );
+}
+
+/**
+ * @brief Makes a new group of some roots (Objects or groups). Group is a root too, its local matrix is the identity, so children stay where they are.
+ *
+ * @param g        Given scene graph.
+ * @param h        Group's handle (see handle_alloc). Must not be in graph already.
+ * @param children Children's handles. Must be roots.
+ * @param n        Number of children (at least 1).
+*/
+void scene_graph_group(struct scene_graph *g,
+                       handle_tt           h,
+                       const handle_tt    *children,
+                       int                 n)
+{
+    /* Sanity Check. */
+    assert( g != NULL && children != NULL && n > 0 );
+    assert( !scene_graph_is_group(g, h) );
+
+    struct scene_group grp;
+    grp.handle = h;
+    vector_init(&grp.children);
+    vector_init(&grp.subgroups);
+    vector_reserve(&grp.children, n);
+    affine_identity(&grp.local);
+    affine_identity(&grp.world);
+    grp.dirty = 0;
+
+    for ( int i = 0; i < n; i++ )
+    {
+        struct scene_node *c = scene_node_add(g, children[i]);
+        assert( c->parent == HANDLE_NONE );
+
+        c->parent = h;
+        vector_push(&grp.children, children[i]);
+        if ( c->group != SCENE_NO_GROUP ) vector_push(&grp.subgroups, children[i]);
+    }
+
+    // Nodes may move when added, so group's node is added last
+    scene_node_add(g, h)->group = g->groups.size;
+    vector_push(&g->groups, grp);
+}
+
+/**
+ * @brief Removes a root group: its children become roots. Group's local matrix is composed with its subgroups' ones, so they stay where they are;
+ * Objects only hold their own matrices, so caller must compose it with theirs (see scene_graph_local) before ungrouping.
+ * Group's handle is not released (see handle.h).
+ *
+ * @param g        Given scene graph.
+ * @param h        Group's handle. Must be a root.
+ * @param children Output: group's children are appended to it.
+*/
+void scene_graph_ungroup(struct scene_graph *g,
+                         handle_tt           h,
+                         handle_list_tt     *children)
+{
+    /* Sanity Check. */
+    assert( g != NULL && children != NULL );
+    assert( scene_graph_parent(g, h) == HANDLE_NONE );
+
+    struct scene_node *n = scene_node(g, h);
+    struct scene_group *grp = scene_group(g, h);
+
+    for ( int i = 0; i < grp->children.size; i++ )
+    {
+        scene_node(g, grp->children.data[i])->parent = HANDLE_NONE;
+        vector_push(children, grp->children.data[i]);
+    }
+    for ( int i = 0; i < grp->subgroups.size; i++ ) scene_graph_transform(g, grp->subgroups.data[i], &grp->local);
+
+    // Last group takes its place
+    int at = n->group;
+    vector_free(&grp->children);
+    vector_free(&grp->subgroups);
+    g->groups.data[at] = g->groups.data[--g->groups.size];
+    if ( at < g->groups.size ) scene_node(g, g->groups.data[at].handle)->group = at;
+    n->group = SCENE_NO_GROUP;
+}
+
+/**
+ * @brief Returns the group that holds a node.
+ *
+ * @param g Given scene graph.
+ * @param h Given handle.
+ *
+ * @returns Parent's handle, HANDLE_NONE if node is a root.
+*/
+handle_tt scene_graph_parent(const struct scene_graph *g,
+                             handle_tt                 h)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    struct scene_node *n = scene_node(g, h);
+    return ( n != NULL ) ? n->parent : HANDLE_NONE;
+}
+
+/**
+ * @brief Returns the root that holds a node, i.e. the outermost group it belongs to. O(depth).
+ *
+ * @param g Given scene graph.
+ * @param h Given handle.
+ *
+ * @returns Root's handle, h itself if node is a root.
+*/
+handle_tt scene_graph_root(const struct scene_graph *g,
+                           handle_tt                 h)
+{
+    handle_tt p;
+
+    while ( (p = scene_graph_parent(g, h)) != HANDLE_NONE ) h = p;
+    return (h);
+}
+
+/**
+ * @brief Returns a group's children (Objects and groups).
+ *
+ * @param g Given scene graph.
+ * @param h Group's handle.
+ *
+ * @returns Children's handles. Valid until groups change (grouping, ungrouping).
+*/
+const handle_list_tt *scene_graph_children(const struct scene_graph *g,
+                                           handle_tt                 h)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    return &scene_group(g, h)->children;
+}
+
+/**
+ * @brief Returns the first Object of a node: its first child, descending through groups. O(depth).
+ *
+ * @param g Given scene graph.
+ * @param h Given handle.
+ *
+ * @returns First Object's handle, h itself if node is not a group.
+*/
+handle_tt scene_graph_first_leaf(const struct scene_graph *g,
+                                 handle_tt                 h)
+{
+    while ( scene_graph_is_group(g, h) ) h = scene_group(g, h)->children.data[0];
+    return (h);
+}
+
+/**
+ * @brief Appends every Object under a node (not its groups). O(nodes under it).
+ *
+ * @param g      Given scene graph.
+ * @param h      Given handle.
+ * @param leaves Output: Objects' handles are appended to it (h itself, if node is not a group).
+*/
+void scene_graph_leaves(const struct scene_graph *g,
+                        handle_tt                 h,
+                        handle_list_tt           *leaves)
+{
+    /* Sanity Check. */
+    assert( g != NULL && leaves != NULL );
+
+    if ( !scene_graph_is_group(g, h) )
+    {
+        vector_push(leaves, h);
+        return;
+    }
+
+    const struct scene_group *grp = scene_group(g, h);
+    for ( int i = 0; i < grp->children.size; i++ ) scene_graph_leaves(g, grp->children.data[i], leaves);
+}
+
+/**
+ * @brief Returns a group's local matrix: its children's coordinates to its parent's ones (or world's, if group is a root).
+ *
+ * @param g Given scene graph.
+ * @param h Group's handle.
+ *
+ * @returns Local matrix. Valid until groups change (grouping, ungrouping).
+*/
+const struct affine *scene_graph_local(const struct scene_graph *g,
+                                       handle_tt                 h)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    return &scene_group(g, h)->local;
+}
+
+/**
+ * @brief Marks a group's world matrix, and its subgroups' ones, dirty. Objects are not visited.
+ *
+ * @param g   Given scene graph.
+ * @param grp Given group.
+*/
+static void scene_graph_dirty(struct scene_graph *g,
+                              struct scene_group *grp)
+{
+    grp->dirty = 1;
+    for ( int i = 0; i < grp->subgroups.size; i++ ) scene_graph_dirty(g, scene_group(g, grp->subgroups.data[i]));
+}
+
+/**
+ * @brief Transforms a group in O(subgroups): given matrix is composed with group's local one, its world matrix (and its subgroups' ones)
+ * will be computed again when needed. Nothing under it is moved.
+ *
+ * @param g Given scene graph.
+ * @param h Group's handle.
+ * @param a Transformation (in parent's coordinates), applied after every previous one.
+*/
+void scene_graph_transform(struct scene_graph  *g,
+                           handle_tt            h,
+                           const struct affine *a)
+{
+    /* Sanity Check. */
+    assert( g != NULL && a != NULL );
+
+    struct scene_group *grp = scene_group(g, h);
+    affine_multiply(&grp->local, a, &grp->local);
+    scene_graph_dirty(g, grp);
+}
+
+/**
+ * @brief Returns a group's world matrix: its children's coordinates to world's ones. Computed again only if group (or a group above it)
+ * was transformed since, in O(depth). Not thread safe unless no group is dirty (see scene_graph_resolve).
+ *
+ * @param g Given scene graph.
+ * @param h Group's handle.
+ *
+ * @returns World matrix. Valid until groups change (grouping, ungrouping).
+*/
+const struct affine *scene_graph_world(struct scene_graph *g,
+                                       handle_tt           h)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    struct scene_group *grp = scene_group(g, h);
+    if ( grp->dirty )
+    {
+        handle_tt p = scene_graph_parent(g, h);
+
+        if ( p == HANDLE_NONE ) grp->world = grp->local;
+        else affine_multiply(&grp->world, scene_graph_world(g, p), &grp->local);
+        grp->dirty = 0;
+    }
+
+    return &grp->world;
+}
+
+/**
+ * @brief Computes every dirty world matrix, so they can be read by many threads at once. O(groups).
+ *
+ * @param g Given scene graph.
+*/
+void scene_graph_resolve(struct scene_graph *g)
+{
+    /* Sanity Check. */
+    assert( g != NULL );
+
+    for ( int i = 0; i < g->groups.size; i++ )
+        if ( g->groups.data[i].dirty ) scene_graph_world(g, g->groups.data[i].handle);
+}
@@ -0,0 +1,346 @@
+#include <assert.h>
+#include <glib.h>
+#include <stdlib.h>
+
+
+#include "scheduler.h"
+
+#define DEQUE_INITIAL_SIZE 64
+
+/**
+ * @brief A parallel loop submitted by scheduler_parallel_for. Its caller waits until every job is done.
+*/
+struct batch
+{
+    scheduler_job_fn fn;        /** << Job function.                 */
+    void            *arg;       /** << Job function's argument.      */
+    int              remaining; /** << Jobs not yet done.            */
+    GMutex           lock;      /** << Protects remaining.           */
+    GCond            done;      /** << Signaled when remaining is 0. */
+};
+
+/**
+ * @brief A chunk of a parallel loop.
+*/
+struct job
+{
+    struct batch *batch; /** << Loop it belongs to. */
+    int           begin; /** << First index.        */
+    int           end;   /** << One past last index. */
+};
+
+/**
+ * @brief Double-ended queue of jobs. Its owner pushes and pops at the bottom (newest job), thieves steal from the top (oldest job).
+*/
+struct deque
+{
+    GMutex      lock;     /** << Protects the whole deque.       */
+    struct job *jobs;     /** << Circular buffer of jobs.        */
+    int         top;      /** << Index of oldest job.            */
+    int         size;     /** << Number of jobs.                 */
+    int         capacity; /** << Number of jobs that fit.        */
+};
+
+struct scheduler
+{
+    int           threads; /** << Threads running jobs (workers + thread that calls parallel_for). */
+    GThread     **workers; /** << Worker threads, threads - 1 of them.                             */
+    struct deque *deques;  /** << deques[0] is fed by callers, deques[i] is owned by worker i.     */
+    GMutex        lock;    /** << Protects sleeping on wake.                                       */
+    GCond         wake;    /** << Signaled whenever jobs are queued (or quit).                     */
+    int           queued;  /** << Jobs queued in all deques.                                       */
+    int           quit;    /** << If workers must stop.                                            */
+    int           next;    /** << Next deque to receive a job (round-robin).                       */
+};
+
+/**
+ * @brief Arguments of a worker thread.
+*/
+struct worker
+{
+    struct scheduler *s;  /** << Given scheduler.   */
+    int               id; /** << Index of its deque. */
+};
+
+/**
+ * @brief Pushes a job at the bottom of a deque.
+ *
+ * @param d Given deque.
+ * @param j Job.
+*/
+static void deque_push(struct deque *d,
+                       struct job    j)
+{
+    g_mutex_lock(&d->lock);
+    if ( d->size == d->capacity )
+    {
+        struct job *jobs = (struct job*) malloc(sizeof(struct job) * d->capacity * 2);
+        for ( int i = 0; i < d->size; i++ ) jobs[i] = d->jobs[(d->top + i) % d->capacity];
+        free(d->jobs);
+        d->jobs = jobs;
+        d->top = 0;
+        d->capacity *= 2;
+    }
+    d->jobs[(d->top + d->size++) % d->capacity] = j;
+    g_mutex_unlock(&d->lock);
+}
+
+/**
+ * @brief Takes a job from a deque, optionally only one of a given loop.
+ *
+ * @param d      Given deque.
+ * @param j      Taken job.
+ * @param bottom If job must be taken from the bottom (owner) or from the top (thief). 0 = Top, 1 = Bottom.
+ * @param batch  Loop the job must belong to. If NULL, any job is taken.
+ *
+ * @returns If a job was taken. 0 = No, 1 = Yes.
+*/
+static int deque_take(struct deque       *d,
+                      struct job         *j,
+                      int                 bottom,
+                      const struct batch *batch)
+{
+    int taken = 0;
+
+    g_mutex_lock(&d->lock);
+    for ( int k = 0; k < d->size; k++ )
+    {
+        int idx = ( bottom ) ? d->size - 1 - k : k;
+        const struct job *at = &d->jobs[(d->top + idx) % d->capacity];
+        if ( batch != NULL && at->batch != batch ) continue;
+
+        *j = *at;
+        if ( idx == 0 ) d->top = (d->top + 1) % d->capacity;
+        else
+        {
+            // Closing the gap, jobs below it move one slot up
+            for ( int i = idx; i < d->size - 1; i++ ) d->jobs[(d->top + i) % d->capacity] = d->jobs[(d->top + i + 1) % d->capacity];
+        }
+        d->size--;
+        taken = 1;
+        break;
+    }
+    g_mutex_unlock(&d->lock);
+
+    return (taken);
+}
+
+/**
+ * @brief Finds a job: first in own deque, then stealing from the others.
+ *
+ * @param s     Given scheduler.
+ * @param id    Index of own deque.
+ * @param j     Found job.
+ * @param batch Loop the job must belong to (a caller only helps its own loop). If NULL (workers), any job is found.
+ *
+ * @returns If a job was found. 0 = No, 1 = Yes.
+*/
+static int scheduler_find(struct scheduler   *s,
+                          int                 id,
+                          struct job         *j,
+                          const struct batch *batch)
+{
+    if ( deque_take(&s->deques[id], j, 1, batch) ) return 1;
+
+    for ( int i = 1; i < s->threads; i++ )
+        if ( deque_take(&s->deques[(id + i) % s->threads], j, 0, batch) ) return 1;
+
+    return 0;
+}
+
+/**
+ * @brief Runs a job and, if it was the last one of its loop, wakes loop's caller.
+ *
+ * @param s Given scheduler.
+ * @param j Job.
+*/
+static void scheduler_run(struct scheduler *s,
+                          struct job       *j)
+{
+    g_atomic_int_add(&s->queued, -1);
+    j->batch->fn(j->begin, j->end, j->batch->arg);
+
+    // Batch lives in its caller's stack, it must not be touched after caller sees remaining == 0.
+    g_mutex_lock(&j->batch->lock);
+    if ( g_atomic_int_dec_and_test(&j->batch->remaining) ) g_cond_signal(&j->batch->done);
+    g_mutex_unlock(&j->batch->lock);
+}
+
+/**
+ * @brief Worker thread. Runs jobs until there is none left anywhere, then sleeps until new jobs are queued.
+ *
+ * @param data Worker arguments.
+*/
+static gpointer scheduler_loop(gpointer data)
+{
+    struct worker *w = data;
+    struct scheduler *s = w->s;
+    struct job j;
+
+    while ( 1 )
+    {
+        if ( scheduler_find(s, w->id, &j, NULL) )
+        {
+            scheduler_run(s, &j);
+            continue;
+        }
+
+        g_mutex_lock(&s->lock);
+        while ( g_atomic_int_get(&s->queued) <= 0 && !s->quit ) g_cond_wait(&s->wake, &s->lock);
+        int quit = s->quit;
+        g_mutex_unlock(&s->lock);
+        if ( quit ) break;
+    }
+
+    free(w);
+    return NULL;
+}
+
+/**
+ * @brief Initializes the Scheduler structure and starts its workers.
+ *
+ * @param threads Number of threads that run jobs, including the one calling scheduler_parallel_for.
+ *                If lesser than 1, number of processors is used. 1 means every loop runs serially.
+ *
+ * @returns A scheduler.
+*/
+scheduler_tt scheduler_create(int threads)
+{
+    struct scheduler *s = (struct scheduler*) malloc(sizeof(struct scheduler));
+
+    if ( threads < 1 ) threads = g_get_num_processors();
+    s->threads = threads;
+    g_mutex_init(&s->lock);
+    g_cond_init(&s->wake);
+    s->queued = 0;
+    s->quit = 0;
+    s->next = 0;
+
+    s->deques = (struct deque*) malloc(sizeof(struct deque) * threads);
+    for ( int i = 0; i < threads; i++ )
+    {
+        g_mutex_init(&s->deques[i].lock);
+        s->deques[i].jobs = (struct job*) malloc(sizeof(struct job) * DEQUE_INITIAL_SIZE);
+        s->deques[i].top = 0;
+        s->deques[i].size = 0;
+        s->deques[i].capacity = DEQUE_INITIAL_SIZE;
+    }
+
+    s->workers = (GThread**) malloc(sizeof(GThread*) * threads);
+    for ( int i = 1; i < threads; i++ )
+    {
+        struct worker *w = (struct worker*) malloc(sizeof(struct worker));
+        w->s = s;
+        w->id = i;
+        s->workers[i] = g_thread_new("scheduler", scheduler_loop, w);
+    }
+
+    return (s);
+}
+
+/**
+ * @brief Stops workers and destroys the Scheduler structure. No loop may be running.
+ *
+ * @param s Given scheduler.
+*/
+void scheduler_destroy(struct scheduler *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    g_mutex_lock(&s->lock);
+    s->quit = 1;
+    g_cond_broadcast(&s->wake);
+    g_mutex_unlock(&s->lock);
+    for ( int i = 1; i < s->threads; i++ ) g_thread_join(s->workers[i]);
+
+    for ( int i = 0; i < s->threads; i++ )
+    {
+        g_mutex_clear(&s->deques[i].lock);
+        free(s->deques[i].jobs);
+    }
+    free(s->deques);
+    free(s->workers);
+    g_mutex_clear(&s->lock);
+    g_cond_clear(&s->wake);
+    free(s);
+}
+
+/**
+ * @brief Returns the number of threads that run jobs.
+ *
+ * @param s Given scheduler.
+ *
+ * @returns Number of threads.
+*/
+int scheduler_threads(struct scheduler *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->threads);
+}
+
+/**
+ * @brief Runs fn over indexes [0, n), split in jobs of (at most) chunk indexes. Jobs are spread over all deques and idle
+ * threads steal from busy ones, the caller also runs its own loop's jobs (never other loops' ones) until it is done. Jobs must only write to their own indexes,
+ * so results do not depend on how many threads ran them. Can be called from any thread, even concurrently.
+ *
+ * @param s     Given scheduler.
+ * @param n     Number of indexes.
+ * @param chunk Indexes per job. If lesser than 1, 1 is used.
+ * @param fn    Job function.
+ * @param arg   Job function's argument.
+*/
+void scheduler_parallel_for(struct scheduler *s,
+                            int               n,
+                            int               chunk,
+                            scheduler_job_fn  fn,
+                            void             *arg)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+    assert( fn != NULL );
+
+    if ( chunk < 1 ) chunk = 1;
+    if ( n <= 0 ) return;
+
+    // Nothing to split, running it here is cheaper than waking anyone.
+    if ( s->threads == 1 || n <= chunk )
+    {
+        fn(0, n, arg);
+        return;
+    }
+
+    struct batch b;
+    int jobs = (n + chunk - 1) / chunk,
+        first = g_atomic_int_add(&s->next, jobs);
+    b.fn = fn;
+    b.arg = arg;
+    b.remaining = jobs;
+    g_mutex_init(&b.lock);
+    g_cond_init(&b.done);
+
+    for ( int i = 0; i < jobs; i++ )
+    {
+        struct job j = { &b, i * chunk, ( (i + 1) * chunk < n ) ? (i + 1) * chunk : n };
+        deque_push(&s->deques[(unsigned) (first + i) % s->threads], j);
+    }
+
+    g_mutex_lock(&s->lock);
+    g_atomic_int_add(&s->queued, jobs);
+    g_cond_broadcast(&s->wake);
+    g_mutex_unlock(&s->lock);
+
+    // Caller helps until no job of its loop is left, then waits for the ones still running. Jobs of other loops are left to
+    // workers, so e.g. GTK's main thread never runs a render thread's tiles (nor the other way round).
+    struct job j;
+    while ( g_atomic_int_get(&b.remaining) > 0 && scheduler_find(s, 0, &j, &b) ) scheduler_run(s, &j);
+
+    g_mutex_lock(&b.lock);
+    while ( g_atomic_int_get(&b.remaining) > 0 ) g_cond_wait(&b.done, &b.lock);
+    g_mutex_unlock(&b.lock);
+
+    g_mutex_clear(&b.lock);
+    g_cond_clear(&b.done);
+}
@@ -0,0 +1,281 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+
+#include "raster.h"
+#include "scheduler.h"
+#include "tiler.h"
+#include "vector.h"
+
+/**
+ * @brief Indexes of display list's operations that touch a tile.
+*/
+typedef VECTOR(int) tile_bin_tt;
+
+struct tiler
+{
+    scheduler_tt               scheduler; /** << Threads that rasterize tiles.                  */
+
+    int                        cols;      /** << Columns of tiles in current frame.             */
+    int                        rows;      /** << Rows of tiles in current frame.                */
+    int                        num_bins;  /** << Number of allocated bins (kept between frames). */
+    tile_bin_tt               *bins;      /** << One bin per tile.                              */
+
+    const struct display_list *dl;        /** << Display list of current frame.                 */
+    unsigned char             *data;      /** << Pixels of target surface.                      */
+    int                        stride;    /** << Stride of target surface.                      */
+    int                        width;     /** << Width of target surface.                       */
+    int                        height;    /** << Height of target surface.                      */
+};
+
+/**
+ * @brief Computes which pixels an operation may touch.
+ *
+ * @param op   Given operation.
+ * @param view Canvas' origin.
+ * @param box  Bounding box in pixels: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+*/
+static void tiler_op_bounds(const struct display_op  *op,
+                            const struct raster_view *view,
+                            double                   *box)
+{
+    double x0 = op->x0 + view->center_x,
+           y0 = view->center_y - op->y0,
+           pad = RASTER_BRUSH_SIZE;
+
+    switch ( op->type )
+    {
+        case DISPLAY_LINE:
+        {
+            double x1 = op->x1 + view->center_x,
+                   y1 = view->center_y - op->y1;
+            box[0] = fmin(x0, x1) - pad;
+            box[1] = fmin(y0, y1) - pad;
+            box[2] = fmax(x0, x1) + pad;
+            box[3] = fmax(y0, y1) + pad;
+            break;
+        }
+        case DISPLAY_CIRCUMFERENCE:
+            box[0] = x0 - op->x1 - pad;
+            box[1] = y0 - op->x1 - pad;
+            box[2] = x0 + op->x1 + pad;
+            box[3] = y0 + op->x1 + pad;
+            break;
+        case DISPLAY_LABEL:
+            // Label is written at (x - 34, y + 15), its text never gets wider than RASTER_LABEL_SIZE chars.
+            box[0] = x0 - 34;
+            box[1] = y0;
+            box[2] = x0 - 34 + RASTER_LABEL_SIZE * 8;
+            box[3] = y0 + 20;
+            break;
+        default:
+            box[0] = x0 - pad;
+            box[1] = y0 - pad;
+            box[2] = x0 + pad;
+            box[3] = y0 + pad;
+            break;
+    }
+}
+
+/**
+ * @brief Checks if an operation really touches a tile, since bounding boxes of long lines and big circumferences cover many tiles they never touch.
+ *
+ * @param op   Given operation.
+ * @param view Canvas' origin.
+ * @param rect Tile in pixels: 1st idx = xmin, 2nd idx = ymin, 3rd idx = xmax, 4th idx = ymax.
+ *
+ * @returns If operation touches the tile. 0 = No, 1 = Yes.
+*/
+static int tiler_op_hits(const struct display_op  *op,
+                         const struct raster_view *view,
+                         const double             *rect)
+{
+    double pad = RASTER_BRUSH_SIZE,
+           xmin = rect[0] - pad,
+           ymin = rect[1] - pad,
+           xmax = rect[2] + pad,
+           ymax = rect[3] + pad,
+           x0 = op->x0 + view->center_x,
+           y0 = view->center_y - op->y0;
+
+    if ( op->type == DISPLAY_LINE )
+    {
+        // Same parametric test used by Liang-Barsky (and by raster_dda() and raster_bresenham() to step only inside a tile), against the padded tile.
+        double padded[4] = { xmin, ymin, xmax, ymax },
+               u[2];
+
+        return raster_clip_segment(x0, y0, op->x1 + view->center_x, view->center_y - op->y1, padded, u);
+    }
+    else if ( op->type == DISPLAY_CIRCUMFERENCE )
+    {
+        // Tile touches the ring if the closest point is inside it and the farthest point is outside it.
+        double cx = fmax(xmin, fmin(x0, xmax)) - x0,
+               cy = fmax(ymin, fmin(y0, ymax)) - y0,
+               fx = fmax(fabs(xmin - x0), fabs(xmax - x0)),
+               fy = fmax(fabs(ymin - y0), fabs(ymax - y0)),
+               r = op->x1;
+
+        return ( sqrt(cx * cx + cy * cy) <= r + pad ) && ( sqrt(fx * fx + fy * fy) >= r - pad );
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Rasterizes a single tile. Each tile is a cairo surface over its own pixels of target surface,
+ * so tiles never write the same pixel and need no locks.
+ *
+ * @param t    Given tiler.
+ * @param tile Index of tile.
+*/
+static void tiler_tile(struct tiler *t,
+                       int           tile)
+{
+    int x0 = (tile % t->cols) * TILE_SIZE,
+        y0 = (tile / t->cols) * TILE_SIZE,
+        w = ( x0 + TILE_SIZE > t->width ) ? t->width - x0 : TILE_SIZE,
+        h = ( y0 + TILE_SIZE > t->height ) ? t->height - y0 : TILE_SIZE;
+
+    cairo_surface_t *s = cairo_image_surface_create_for_data(t->data + (y0 * t->stride) + (x0 * 4), CAIRO_FORMAT_RGB24, w, h, t->stride);
+    cairo_t *cr = cairo_create(s);
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_paint(cr);
+    cairo_translate(cr, -x0, -y0);
+
+    struct raster_view view;
+    raster_view_init(&view, t->dl);
+    view.clip_x0 = x0;
+    view.clip_y0 = y0;
+    view.clip_x1 = x0 + w;
+    view.clip_y1 = y0 + h;
+
+    tile_bin_tt *bin = &t->bins[tile];
+    for ( int i = 0; i < bin->size; i++ )
+        raster_op(cr, &view, display_list_get(t->dl, vector_get(bin, i)));
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(s);
+}
+
+/**
+ * @brief (JOB) Rasterizes tiles [begin, end).
+ *
+ * @param begin First tile.
+ * @param end   One past last tile.
+ * @param arg   Given tiler.
+*/
+static void tiler_job(int   begin,
+                      int   end,
+                      void *arg)
+{
+    for ( int i = begin; i < end; i++ ) tiler_tile(arg, i);
+}
+
+/**
+ * @brief Initializes the Tiler structure.
+ *
+ * @param scheduler Scheduler whose threads rasterize tiles.
+ *
+ * @returns A tiler.
+*/
+tiler_tt tiler_create(scheduler_tt scheduler)
+{
+    /* Sanity Check. */
+    assert( scheduler != NULL );
+
+    struct tiler *t = (struct tiler*) malloc(sizeof(struct tiler));
+
+    t->scheduler = scheduler;
+    t->cols = t->rows = 0;
+    t->num_bins = 0;
+    t->bins = NULL;
+    t->dl = NULL;
+
+    return (t);
+}
+
+/**
+ * @brief Destroys the Tiler structure.
+ *
+ * @param t Given tiler.
+*/
+void tiler_destroy(struct tiler *t)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+
+    for ( int i = 0; i < t->num_bins; i++ ) vector_free(&t->bins[i]);
+    free(t->bins);
+    free(t);
+}
+
+/**
+ * @brief Rasterizes a display list into an image surface. Surface is split into tiles of TILE_SIZE pixels,
+ * each operation is binned into the tiles it touches and scheduler's threads rasterize tiles independently.
+ * Inside a tile, operations keep display list's order.
+ *
+ * @param t       Given tiler.
+ * @param surface Target image surface (CAIRO_FORMAT_RGB24).
+ * @param dl      Display list.
+*/
+void tiler_rasterize(struct tiler              *t,
+                     cairo_surface_t           *surface,
+                     const struct display_list *dl)
+{
+    /* Sanity Check. */
+    assert( t != NULL );
+    assert( dl != NULL );
+
+    cairo_surface_flush(surface);
+    t->dl = dl;
+    t->data = cairo_image_surface_get_data(surface);
+    t->stride = cairo_image_surface_get_stride(surface);
+    t->width = cairo_image_surface_get_width(surface);
+    t->height = cairo_image_surface_get_height(surface);
+    t->cols = (t->width + TILE_SIZE - 1) / TILE_SIZE;
+    t->rows = (t->height + TILE_SIZE - 1) / TILE_SIZE;
+
+    int num_tiles = t->cols * t->rows;
+    if ( num_tiles == 0 ) return;
+    if ( num_tiles > t->num_bins )
+    {
+        t->bins = (tile_bin_tt*) realloc(t->bins, sizeof(tile_bin_tt) * num_tiles);
+        for ( int i = t->num_bins; i < num_tiles; i++ ) vector_init(&t->bins[i]);
+        t->num_bins = num_tiles;
+    }
+    for ( int i = 0; i < num_tiles; i++ ) vector_clear(&t->bins[i]);
+
+    // Binning.
+    struct raster_view view;
+    raster_view_init(&view, dl);
+    for ( int i = 0; i < display_list_size(dl); i++ )
+    {
+        const struct display_op *op = display_list_get(dl, i);
+        double box[4];
+        tiler_op_bounds(op, &view, box);
+
+        int c0 = (int) floor(box[0] / TILE_SIZE),
+            r0 = (int) floor(box[1] / TILE_SIZE),
+            c1 = (int) floor(box[2] / TILE_SIZE),
+            r1 = (int) floor(box[3] / TILE_SIZE);
+        if ( c1 < 0 || r1 < 0 || c0 >= t->cols || r0 >= t->rows ) continue;
+        if ( c0 < 0 ) c0 = 0;
+        if ( r0 < 0 ) r0 = 0;
+        if ( c1 >= t->cols ) c1 = t->cols - 1;
+        if ( r1 >= t->rows ) r1 = t->rows - 1;
+
+        int single = ( c0 == c1 && r0 == r1 );
+        for ( int r = r0; r <= r1; r++ )
+            for ( int c = c0; c <= c1; c++ )
+            {
+                double rect[4] = { c * TILE_SIZE, r * TILE_SIZE, (c + 1) * TILE_SIZE, (r + 1) * TILE_SIZE };
+                if ( single || tiler_op_hits(op, &view, rect) ) vector_push(&t->bins[r * t->cols + c], i);
+            }
+    }
+
+    // Rasterizing, one tile per job: tiles' costs vary a lot, idle threads steal the remaining ones.
+    scheduler_parallel_for(t->scheduler, num_tiles, 1, tiler_job, t);
+
+    cairo_surface_mark_dirty(surface);
+}
@@ -0,0 +1,590 @@
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#include "transform_script.h"
+#include "vector.h"
+
+#define INITIAL_STEPS 16 /** << Steps reserved when a script is created, so short scripts never allocate while parsing. */
+
+#define MAX_MANTISSA UINT64_C(1000000000000000000) /** << Digits are kept while a number is below it (so they fit in 64 bits), further ones only scale it. */
+
+#define MAX_EXACT UINT64_C(9007199254740992) /** << 2^53: integers up to it are exact doubles. */
+
+#define MAX_EXPONENT 100000000 /** << Exponents written beyond it (either sign) saturate: number is out of range (or zero) anyway. */
+
+#define MAX_DIGITS 800 /** << Significant digits given to strtod(). Correct rounding of a double never needs more than 768, further ones only matter if they are not zero. */
+
+/**
+ * @brief Kinds of tokens.
+*/
+/**@(*/
+#define TOKEN_END       0 /** << End of text.                                     */
+#define TOKEN_NUMBER    1 /** << '10', '-2.5', '+3', '.5', '1e-3'.                */
+#define TOKEN_LETTER    2 /** << A letter (upper case).                           */
+#define TOKEN_SYMBOL    3 /** << '(', ')', ',', ';' or new line.                  */
+#define TOKEN_INVALID   4 /** << Any other char, or a malformed number.           */
+/**@)*/
+
+struct transform_script
+{
+    VECTOR(struct transform_step) steps;  /** << Steps, in the order they are applied.          */
+    const char                   *error;  /** << Why last parse failed. NULL if it did not.      */
+    int                           line;   /** << Line where last parse failed (from 1).         */
+    int                           column; /** << Column where last parse failed (from 1).       */
+};
+
+/**
+ * @brief A token, pointing into the text (nothing is copied).
+*/
+struct token
+{
+    int    kind;   /** << TOKEN_*.                                       */
+    int    pos;    /** << First char.                                   */
+    int    line;   /** << Line of first char (from 1).                 */
+    int    column; /** << Column of first char (from 1).               */
+    char   ch;     /** << Letter (upper case) or symbol.                */
+    double value;  /** << Number's value.                               */
+};
+
+/**
+ * @brief Tokenizer: reads text once, from start to end, one token ahead of parser.
+*/
+struct lexer
+{
+    const char  *text;  /** << Text.                                   */
+    int          pos;   /** << First char not tokenized yet.           */
+    int          line;  /** << Line of pos (from 1).                   */
+    int          start; /** << First char of pos' line.                */
+    struct token next;  /** << Current token (lookahead).              */
+};
+
+/**
+ * @brief Names of steps, by TRANSFORM_* type.
+*/
+static const char *names[7] = { "?", "T", "R", "S", "RX", "RY", "RXY" };
+
+/**
+ * @brief Powers of 10 that are exact doubles.
+*/
+static const double powers[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+/**
+ * @brief Converts a number that is not exact on lex_number's fast path with strtod(), correctly rounded. Its significant digits are copied
+ * into a stack buffer without '.' (so locale's decimal point does not matter), followed by a '1' if any digit beyond MAX_DIGITS is not zero.
+ *
+ * @param s     Number's first digit (or '.'), already validated by lex_number.
+ * @param scale Exponent written after 'e' (0 if there is none).
+ *
+ * @returns Number's absolute value (HUGE_VAL if out of range).
+*/
+static double lex_decimal(const char *s,
+                          int         scale)
+{
+    char buffer[MAX_DIGITS + 16];
+    int n = 0,
+        exponent = scale,
+        fraction = 0,
+        sticky = 0;
+
+    for ( int p = 0; (s[p] >= '0' && s[p] <= '9') || (s[p] == '.' && !fraction); p++ )
+    {
+        if ( s[p] == '.' )
+        {
+            fraction = 1;
+            continue;
+        }
+        if ( fraction ) exponent--;
+        if ( n == 0 && s[p] == '0' ) continue;
+        if ( n < MAX_DIGITS ) buffer[n++] = s[p];
+        else
+        {
+            exponent++;
+            sticky = sticky || ( s[p] != '0' );
+        }
+    }
+    if ( sticky )
+    {
+        buffer[n++] = '1';
+        exponent--;
+    }
+    if ( n == 0 ) return (0.0);
+
+    snprintf(buffer + n, sizeof(buffer) - n, "e%d", exponent);
+    return strtod(buffer, NULL);
+}
+
+/**
+ * @brief Reads a number: [sign] digits [. digits] [(e|E) [sign] digits], at least one digit before or after '.'. Result is correctly rounded:
+ * significant digits are accumulated as an integer and, when it is exact (up to 2^53) and so is its power of 10 (up to 1e22), scaled by it once,
+ * which is a single rounding. Any other number (e.g. 1e23) is converted by lex_decimal.
+ *
+ * @param l   Given lexer, at number's first char.
+ * @param tok Output: TOKEN_NUMBER, or TOKEN_INVALID (at the offending char) if number is malformed or out of range.
+*/
+static void lex_number(struct lexer *l,
+                       struct token *tok)
+{
+    const char *s = l->text;
+    int p = l->pos,
+        negative = 0,
+        digits = 0,
+        exponent = 0,
+        scale = 0,
+        start = 0,
+        dropped = 0;
+    uint64_t mantissa = 0;
+
+    if ( s[p] == '-' || s[p] == '+' ) negative = ( s[p++] == '-' );
+    start = p;
+    for ( ; s[p] >= '0' && s[p] <= '9'; p++, digits++ )
+    {
+        if ( mantissa == 0 && s[p] == '0' ) continue;
+        if ( mantissa < MAX_MANTISSA ) mantissa = (mantissa * 10) + (uint64_t) (s[p] - '0');
+        else
+        {
+            exponent++;
+            dropped = 1;
+        }
+    }
+    if ( s[p] == '.' )
+    {
+        for ( p++; s[p] >= '0' && s[p] <= '9'; p++, digits++ )
+        {
+            if ( mantissa < MAX_MANTISSA )
+            {
+                mantissa = (mantissa * 10) + (uint64_t) (s[p] - '0');
+                exponent--;
+            }
+            else dropped = 1;
+        }
+    }
+    if ( digits == 0 )
+    {
+        tok->kind = TOKEN_INVALID;
+        tok->column = p - l->start + 1;
+        l->pos = p;
+        return;
+    }
+    if ( s[p] == 'e' || s[p] == 'E' )
+    {
+        int sign = 1,
+            e = 0;
+
+        p++;
+        if ( s[p] == '-' || s[p] == '+' ) sign = ( s[p++] == '-' ) ? -1 : 1;
+        if ( s[p] < '0' || s[p] > '9' )
+        {
+            tok->kind = TOKEN_INVALID;
+            tok->column = p - l->start + 1;
+            l->pos = p;
+            return;
+        }
+        for ( ; s[p] >= '0' && s[p] <= '9'; p++ )
+            if ( e < MAX_EXPONENT ) e = (e * 10) + (s[p] - '0');
+        scale = sign * e;
+        exponent += scale;
+    }
+
+    // Both operands exact: multiplying (or dividing) rounds once, e.g. 0.1 = 1 / 1e1. Otherwise strtod() rounds all digits
+    double value = (double) mantissa;
+    if ( mantissa == 0 ) value = 0.0;
+    else if ( dropped || mantissa > MAX_EXACT || exponent > 22 || exponent < -22 ) value = lex_decimal(s + start, scale);
+    else if ( exponent > 0 ) value = value * powers[exponent];
+    else if ( exponent < 0 ) value = value / powers[-exponent];
+    l->pos = p;
+    if ( !isfinite(value) )
+    {
+        tok->kind = TOKEN_INVALID;
+        return;
+    }
+    tok->kind = TOKEN_NUMBER;
+    tok->value = ( negative ) ? -value : value;
+}
+
+/**
+ * @brief Reads next token into lookahead, skipping blanks (not new lines, they separate steps) and comments ('#' up to end of line).
+ *
+ * @param l Given lexer.
+*/
+static void lex_next(struct lexer *l)
+{
+    struct token *tok = &l->next;
+    const char *s = l->text;
+
+    for ( ;; )
+    {
+        if ( s[l->pos] == ' ' || s[l->pos] == '\t' || s[l->pos] == '\r' ) l->pos++;
+        else if ( s[l->pos] == '#' )
+            while ( s[l->pos] != '\0' && s[l->pos] != '\n' ) l->pos++;
+        else break;
+    }
+
+    char ch = s[l->pos];
+    tok->pos = l->pos;
+    tok->line = l->line;
+    tok->column = l->pos - l->start + 1;
+    tok->ch = ch;
+
+    if ( ch == '\0' ) tok->kind = TOKEN_END;
+    else if ( (ch >= '0' && ch <= '9') || ch == '.' || ch == '-' || ch == '+' ) lex_number(l, tok);
+    else if ( (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') )
+    {
+        tok->kind = TOKEN_LETTER;
+        tok->ch = ( ch >= 'a' ) ? (char) (ch - 'a' + 'A') : ch;
+        l->pos++;
+    }
+    else if ( ch == '(' || ch == ')' || ch == ',' || ch == ';' || ch == '\n' )
+    {
+        tok->kind = TOKEN_SYMBOL;
+        l->pos++;
+        if ( ch == '\n' )
+        {
+            l->line++;
+            l->start = l->pos;
+        }
+    }
+    else
+    {
+        tok->kind = TOKEN_INVALID;
+        l->pos++;
+    }
+}
+
+/**
+ * @brief Starts tokenizing a text.
+ *
+ * @param l    Given lexer.
+ * @param text Text.
+*/
+static void lex_init(struct lexer *l,
+                     const char   *text)
+{
+    l->text = text;
+    l->pos = 0;
+    l->line = 1;
+    l->start = 0;
+    lex_next(l);
+}
+
+/**
+ * @brief Records why parsing failed, at current token.
+ *
+ * @param s       Given script.
+ * @param l       Given lexer.
+ * @param message What was expected.
+ *
+ * @returns -1.
+*/
+static int parse_error(struct transform_script *s,
+                       const struct lexer      *l,
+                       const char              *message)
+{
+    s->error = ( l->next.kind == TOKEN_INVALID && (l->next.ch == '.' || l->next.ch == '-' || l->next.ch == '+' || (l->next.ch >= '0' && l->next.ch <= '9')) )
+               ? "invalid number" : message;
+    s->line = l->next.line;
+    s->column = l->next.column;
+    return (-1);
+}
+
+/**
+ * @brief Consumes current token if it is a given letter or symbol.
+ *
+ * @param l    Given lexer.
+ * @param kind TOKEN_LETTER or TOKEN_SYMBOL.
+ * @param ch   Letter (upper case) or symbol.
+ *
+ * @returns 1 if it was consumed, 0 otherwise.
+*/
+static int accept(struct lexer *l,
+                  int           kind,
+                  char          ch)
+{
+    if ( l->next.kind != kind || l->next.ch != ch ) return (0);
+    lex_next(l);
+    return (1);
+}
+
+/**
+ * @brief Consumes current token if it is a number.
+ *
+ * @param l     Given lexer.
+ * @param value Output: number's value.
+ *
+ * @returns 1 if it was consumed, 0 otherwise.
+*/
+static int accept_number(struct lexer *l,
+                         double       *value)
+{
+    if ( l->next.kind != TOKEN_NUMBER ) return (0);
+    *value = l->next.value;
+    lex_next(l);
+    return (1);
+}
+
+/**
+ * @brief Reads '(X,Y)'.
+ *
+ * @param s      Given script.
+ * @param l      Given lexer.
+ * @param values Output: X and Y.
+ *
+ * @returns 0 if it was read, -1 otherwise (see transform_script_error).
+*/
+static int read_pair(struct transform_script *s,
+                     struct lexer            *l,
+                     double                  *values)
+{
+    if ( !accept(l, TOKEN_SYMBOL, '(') ) return parse_error(s, l, "expected '('");
+    if ( !accept_number(l, &values[0]) ) return parse_error(s, l, "expected a number");
+    if ( !accept(l, TOKEN_SYMBOL, ',') ) return parse_error(s, l, "expected ','");
+    if ( !accept_number(l, &values[1]) ) return parse_error(s, l, "expected a number");
+    if ( !accept(l, TOKEN_SYMBOL, ')') ) return parse_error(s, l, "expected ')'");
+    return (0);
+}
+
+/**
+ * @brief Reads 'Xd' (an angle in degrees).
+ *
+ * @param s     Given script.
+ * @param l     Given lexer.
+ * @param angle Output: angle, in radians.
+ *
+ * @returns 0 if it was read, -1 otherwise (see transform_script_error).
+*/
+static int read_angle(struct transform_script *s,
+                      struct lexer            *l,
+                      double                  *angle)
+{
+    if ( !accept_number(l, angle) ) return parse_error(s, l, "expected an angle");
+    if ( !accept(l, TOKEN_LETTER, 'D') ) return parse_error(s, l, "expected 'd'");
+    *angle = *angle * M_PI / 180.0;
+    return (0);
+}
+
+/**
+ * @brief Reads a step: 'T(X,Y)', 'S(X,Y)', 'RXd', 'RX', 'RY' or 'RXY'.
+ *
+ * @param s    Given script.
+ * @param l    Given lexer (at step's first token).
+ * @param step Output: step read.
+ *
+ * @returns 0 if it was read, -1 otherwise (see transform_script_error).
+*/
+static int read_step(struct transform_script *s,
+                     struct lexer            *l,
+                     struct transform_step   *step)
+{
+    step->values[0] = 0.0;
+    step->values[1] = 0.0;
+    step->line = l->next.line;
+
+    if ( accept(l, TOKEN_LETTER, 'T') )
+    {
+        step->type = TRANSFORM_TRANSLATION;
+        return read_pair(s, l, step->values);
+    }
+    if ( accept(l, TOKEN_LETTER, 'S') )
+    {
+        step->type = TRANSFORM_SCALE;
+        return read_pair(s, l, step->values);
+    }
+    if ( !accept(l, TOKEN_LETTER, 'R') ) return parse_error(s, l, "expected 'T', 'R' or 'S'");
+
+    if ( accept(l, TOKEN_LETTER, 'X') )
+    {
+        step->type = ( accept(l, TOKEN_LETTER, 'Y') ) ? TRANSFORM_XY_REFLECTION : TRANSFORM_X_REFLECTION;
+        return (0);
+    }
+    if ( accept(l, TOKEN_LETTER, 'Y') )
+    {
+        step->type = TRANSFORM_Y_REFLECTION;
+        return (0);
+    }
+
+    step->type = TRANSFORM_ROTATION;
+    if ( l->next.kind != TOKEN_NUMBER ) return parse_error(s, l, "expected an angle or 'X', 'Y'");
+    return read_angle(s, l, &step->values[0]);
+}
+
+/**
+ * @brief Initializes the Transform Script structure, with no steps.
+ *
+ * @returns A transform script.
+*/
+transform_script_tt transform_script_create(void)
+{
+    struct transform_script *s = (struct transform_script*) malloc(sizeof(struct transform_script));
+
+    vector_init(&s->steps);
+    vector_reserve(&s->steps, INITIAL_STEPS);
+    s->error = NULL;
+    s->line = 0;
+    s->column = 0;
+
+    return (s);
+}
+
+/**
+ * @brief Destroys the Transform Script structure.
+ *
+ * @param s Given script.
+*/
+void transform_script_destroy(struct transform_script *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    vector_free(&s->steps);
+    free(s);
+}
+
+/**
+ * @brief Parses a script in a single pass, replacing previous steps (memory is reused, nothing is allocated unless the script has more steps
+ * than any previous one). Steps are separated by ';' or new lines (empty ones are skipped), letters may be lower case and blanks may be
+ * anywhere between tokens. If script is invalid, no step is kept.
+ *
+ * @param s    Given script.
+ * @param text Script's text.
+ *
+ * @returns Number of steps, -1 if script is invalid (see transform_script_error).
+*/
+int transform_script_parse(struct transform_script *s,
+                           const char              *text)
+{
+    /* Sanity Check. */
+    assert( s != NULL && text != NULL );
+
+    struct lexer l;
+    struct transform_step step;
+
+    vector_clear(&s->steps);
+    s->error = NULL;
+    lex_init(&l, text);
+    while ( l.next.kind != TOKEN_END )
+    {
+        if ( accept(&l, TOKEN_SYMBOL, ';') || accept(&l, TOKEN_SYMBOL, '\n') ) continue;
+
+        if ( read_step(s, &l, &step) < 0 )
+        {
+            vector_clear(&s->steps);
+            return (-1);
+        }
+        vector_push(&s->steps, step);
+
+        if ( l.next.kind != TOKEN_END && !accept(&l, TOKEN_SYMBOL, ';') && !accept(&l, TOKEN_SYMBOL, '\n') )
+        {
+            vector_clear(&s->steps);
+            return parse_error(s, &l, "expected ';' or end of line");
+        }
+    }
+
+    return (s->steps.size);
+}
+
+/**
+ * @brief Parses the template of a single transformation, as typed for "Transformation"'s dropdown: '(X,Y)' for Translation and Scale,
+ * 'Xd' for Rotation. Reflections have no template. Replaces previous steps with it (see transform_script_parse).
+ *
+ * @param s    Given script.
+ * @param text Template's text.
+ * @param type TRANSFORM_TRANSLATION, TRANSFORM_ROTATION or TRANSFORM_SCALE.
+ *
+ * @returns 0 if template was read (it is step 0), -1 otherwise (see transform_script_error).
+*/
+int transform_script_parse_template(struct transform_script *s,
+                                    const char              *text,
+                                    int                      type)
+{
+    /* Sanity Check. */
+    assert( s != NULL && text != NULL );
+    assert( type == TRANSFORM_TRANSLATION || type == TRANSFORM_ROTATION || type == TRANSFORM_SCALE );
+
+    struct lexer l;
+    struct transform_step step = { type, { 0.0, 0.0 }, 1 };
+    int rc;
+
+    vector_clear(&s->steps);
+    s->error = NULL;
+    lex_init(&l, text);
+    if ( type == TRANSFORM_ROTATION ) rc = read_angle(s, &l, &step.values[0]);
+    else rc = read_pair(s, &l, step.values);
+    if ( rc == 0 && l.next.kind != TOKEN_END ) rc = parse_error(s, &l, "expected end of template");
+    if ( rc < 0 ) return (-1);
+
+    vector_push(&s->steps, step);
+    return (0);
+}
+
+/**
+ * @brief Returns the number of steps.
+ *
+ * @param s Given script.
+ *
+ * @returns Number of steps.
+*/
+int transform_script_size(const struct transform_script *s)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    return (s->steps.size);
+}
+
+/**
+ * @brief Returns a step.
+ *
+ * @param s Given script.
+ * @param i Position of step.
+ *
+ * @returns ith step.
+*/
+const struct transform_step *transform_script_get(const struct transform_script *s,
+                                                  int                            i)
+{
+    /* Sanity Check. */
+    assert( s != NULL && i >= 0 && i < s->steps.size );
+
+    return (&s->steps.data[i]);
+}
+
+/**
+ * @brief Returns why last parse failed, and where.
+ *
+ * @param s      Given script.
+ * @param line   Output: line (from 1). May be NULL.
+ * @param column Output: column (from 1). May be NULL.
+ *
+ * @returns What was expected. NULL if last parse did not fail.
+*/
+const char *transform_script_error(const struct transform_script *s,
+                                   int                           *line,
+                                   int                           *column)
+{
+    /* Sanity Check. */
+    assert( s != NULL );
+
+    if ( line ) *line = s->line;
+    if ( column ) *column = s->column;
+
+    return (s->error);
+}
+
+/**
+ * @brief Returns the name of a step, as written in scripts (e.g. 'T', 'RX').
+ *
+ * @param type TRANSFORM_*.
+ *
+ * @returns Step's name.
+*/
+const char *transform_script_name(int type)
+{
+    /* Sanity Check. */
+    assert( type >= TRANSFORM_TRANSLATION && type <= TRANSFORM_XY_REFLECTION );
+
+    return (names[type]);
+}